@@ -24,69 +24,1199 @@
  */
 
 #include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_ADCRing.h"
+
+// Contiguous runs of writable config registers mirrored in shadow_regs.
+// 0x19/0x1A (ICO_ILIM) is read-only and updated by the chip, so it is not
+// shadowed even though it sits next to the control block.
+#define BQ25798_CACHE_CTRL_FIRST BQ25798_REG_MINIMAL_SYSTEM_VOLTAGE
+#define BQ25798_CACHE_CTRL_LAST BQ25798_REG_NTC_CONTROL_1
+#define BQ25798_CACHE_MASK_FIRST BQ25798_REG_CHARGER_MASK_0
+#define BQ25798_CACHE_MASK_LAST BQ25798_REG_ADC_FUNCTION_DISABLE_1
+
+// commit() writes through runs of up to this many clean registers rather than
+// paying for a separate transaction on each side of them
+#define BQ25798_BATCH_MAX_GAP 2
+
+/*!
+ * @brief  Map a register address to its slot in the shadow cache
+ * @param  reg Register address
+ * @return Index into shadow_regs, or -1 if the register is not cached
+ */
+static int8_t cacheIndex(uint8_t reg) {
+  if (reg <= BQ25798_CACHE_CTRL_LAST) {
+    return reg - BQ25798_CACHE_CTRL_FIRST;
+  }
+  if (reg >= BQ25798_CACHE_MASK_FIRST && reg <= BQ25798_CACHE_MASK_LAST) {
+    return (BQ25798_CACHE_CTRL_LAST - BQ25798_CACHE_CTRL_FIRST + 1) +
+           (reg - BQ25798_CACHE_MASK_FIRST);
+  }
+  if (reg == BQ25798_REG_DPDM_DRIVER) {
+    return BQ25798_CACHE_SIZE - 1;
+  }
+  return -1;
+}
+
+/*!
+ * @brief  Bits within a cached register that the chip clears by itself
+ * @param  reg Register address
+ * @return Mask of self-clearing bits (always read from the bus, never cached)
+ */
+static uint8_t cacheVolatileMask(uint8_t reg) {
+  switch (reg) {
+  case BQ25798_REG_TERMINATION_CONTROL:
+    return 0x40; // REG_RST
+  case BQ25798_REG_CHARGER_CONTROL_0:
+    return 0x08; // FORCE_ICO
+  case BQ25798_REG_CHARGER_CONTROL_1:
+    return 0x08; // WD_RST
+  case BQ25798_REG_CHARGER_CONTROL_2:
+    return 0x80; // FORCE_INDET
+  default:
+    return 0x00;
+  }
+}
+
+/*!
+ * @brief  Bits within a cached register that the chip may change by itself
+ *         but which, unlike strobes, must not be written back as 0
+ * @param  reg Register address
+ * @return Mask of live bits (always read from the bus, read-modify-write of
+ *         the register always starts from a fresh read)
+ */
+static uint8_t cacheLiveMask(uint8_t reg) {
+  // ADC_EN clears when a one-shot conversion finishes but stays set in
+  // continuous mode
+  return (reg == BQ25798_REG_ADC_CONTROL) ? 0x80 : 0x00;
+}
+
+/*!
+ * @brief  Whether commit() may rewrite an unchanged register from the shadow
+ *         copy to join two bursts
+ * @param  reg Register address
+ * @return False if the chip changes bits of the register by itself, so
+ *         writing back the shadow copy could undo that
+ */
+static bool cacheBridgeable(uint8_t reg) {
+  // VBUS plug-in clears EN_HIZ, an OTG fault clears EN_OTG and ADC_EN
+  // clears after a one-shot conversion
+  return reg != BQ25798_REG_CHARGER_CONTROL_0 &&
+         reg != BQ25798_REG_CHARGER_CONTROL_3 &&
+         reg != BQ25798_REG_ADC_CONTROL;
+}
+
+/*!
+ * @brief Expands one BQ25798_FIELD_LIST row into its descriptor
+ */
+#define BQ25798_FIELD_DESC(name, reg, width, bits, shift, scale, offset, min,  \
+                           max, flags)                                         \
+  {reg, width, bits, shift, scale, offset, min, max, flags},
+
+// Indexed by bq25798_field_t. The accessor templates only read it in
+// constant expressions, so for them it is folded into each call site; the
+// by-ID API copies entries out of flash with memcpy_P.
+static constexpr bq25798_field_desc_t field_table[] PROGMEM = {
+    BQ25798_FIELD_LIST(BQ25798_FIELD_DESC)};
+
+static_assert(sizeof(field_table) / sizeof(field_table[0]) ==
+                  BQ25798_FIELD_COUNT,
+              "field_table out of step with bq25798_field_t");
+
+/*!
+ * @brief Expands one BQ25798_FIELD_LIST row into its NUL terminated name
+ */
+#define BQ25798_FIELD_NAME(name, reg, width, bits, shift, scale, offset, min,  \
+                           max, flags)                                         \
+  #name "\0"
+
+// Every field name back to back, in bq25798_field_t order
+static const char field_names[] PROGMEM = {
+    BQ25798_FIELD_LIST(BQ25798_FIELD_NAME)};
+
+/*!
+ * @brief  Convert a raw field value to its engineering units
+ * @param  field Field descriptor
+ * @param  raw Field bits, right aligned
+ * @return raw * scale + offset, sign extended for signed fields
+ */
+static inline int32_t fieldDecode(const bq25798_field_desc_t &field,
+                                  uint16_t raw) {
+  if (field.flags & BQ25798_FIELD_SIGNED) {
+    return (int32_t)(int16_t)raw * field.scale + field.offset;
+  }
+  return (uint16_t)(raw * field.scale + field.offset);
+}
+
+/*!
+ * @brief  Range check a value in engineering units and round it to the
+ *         nearest LSB step
+ * @param  field Field descriptor
+ * @param  value Setting in engineering units
+ * @param  raw Set to the field bits, right aligned
+ * @return False if the field is read-only or the value out of range
+ */
+static inline bool fieldEncode(const bq25798_field_desc_t &field,
+                               int32_t value, uint16_t &raw) {
+  if ((field.flags & BQ25798_FIELD_RO) || value < field.min ||
+      value > field.max) {
+    return false;
+  }
+
+  // min >= offset and max < 64k, so this stays in 16-bit math
+  raw = ((uint16_t)value - field.offset + field.scale / 2) / field.scale;
+  if (raw > (uint16_t)((1UL << field.bits) - 1)) {
+    raw = (1UL << field.bits) - 1;
+  }
+  return true;
+}
+
+#ifndef BQ25798_NO_FLOAT
+/*!
+ * @brief  Convert volts or amps to the nearest milli-unit for the integer
+ *         API, saturating so out of range inputs still fail its range check
+ * @param  value Volts or amps
+ * @return Millivolts or milliamps, 0 for negative or NaN inputs
+ */
+static uint16_t toMilli(float value) {
+  if (!(value > 0.0f)) {
+    return 0;
+  }
+  if (value >= 65.535f) {
+    return 65535;
+  }
+  return (uint16_t)(value * 1000.0f + 0.5f);
+}
+#endif
+
+/*!
+ * @brief  Instantiates a new BQ25798 class
+ */
+Adafruit_BQ25798::Adafruit_BQ25798() {
+  transport = NULL;
+  owns_transport = false;
+  setRetryPolicy(1);
+  last_error = BQ25798_OK;
+  wdt_piggyback = false;
+  wdt_reset_ms = 0;
+  cache_enabled = false;
+  cache_valid = false;
+  batching = false;
+  resync_pending = false;
+  memset(shadow_dirty, 0, sizeof(shadow_dirty));
+
+  vbus_present_cb = NULL;
+  power_good_cb = NULL;
+  chg_stat_cb = NULL;
+  chg_done_cb = NULL;
+  wdt_cb = NULL;
+  tshut_cb = NULL;
+  fault_cb = NULL;
+  event_cb = NULL;
+
+  adc_ring = NULL;
+  adc_channels = BQ25798_ADC_CH_ALL;
+  adc_oneshot = false;
+
+  setAsyncQueue(NULL, 0);
+
+#ifdef BQ25798_BUS_STATS
+  resetBusStats();
+#endif
+}
+
+/*!
+ * @brief  Destroys the BQ25798 object
+ */
+Adafruit_BQ25798::~Adafruit_BQ25798() {
+  if (owns_transport) {
+    delete transport;
+  }
+}
+
+#ifdef ARDUINO
+/*!
+ * @brief  Sets up the hardware and initializes I2C
+ * @param  i2c_addr
+ *         The I2C address to be used.
+ * @param  wire
+ *         The Wire object to be used for I2C connections.
+ * @return True if initialization was successful, otherwise false.
+ */
+bool Adafruit_BQ25798::begin(uint8_t i2c_addr, TwoWire *wire) {
+  bool ok = begin(new Adafruit_BQ25798_I2C(i2c_addr, wire));
+
+  // We allocated it, so the destructor (or the next begin) frees it
+  owns_transport = true;
+
+  return ok;
+}
+#endif
+
+/*!
+ * @brief  Sets up the chip over a caller-supplied register transport, e.g. a
+ *         simulator or a non-Arduino bus. The transport must outlive this
+ *         object.
+ * @param  bus The register transport to use
+ * @return True if initialization was successful, otherwise false.
+ */
+bool Adafruit_BQ25798::begin(Adafruit_BQ25798_Transport *bus) {
+  if (owns_transport && transport != bus) {
+    delete transport;
+  }
+  transport = bus;
+  owns_transport = false;
+  cache_valid = false;
+
+  // Any batch still open was staged against the previous setup
+  batching = false;
+  resync_pending = false;
+  memset(shadow_dirty, 0, sizeof(shadow_dirty));
+
+  if (!transport || !transport->begin()) {
+    last_error = BQ25798_ERR_NO_DEVICE;
+    return false;
+  }
+
+  // Check part information register to verify chip
+  uint8_t part_info = 0;
+  if (!readRegisters(BQ25798_REG_PART_INFORMATION, &part_info, 1)) {
+    return false;
+  }
+
+  // Verify part number (bits 5-3 should be 011b = 3h for BQ25798)
+  if ((part_info & 0x38) != 0x18) {
+    last_error = BQ25798_ERR_NO_DEVICE;
+    return false;
+  }
+
+  // Reset all registers to default values (also refills the shadow cache)
+  return reset();
+}
+
+/*!
+ * @brief  Read a run of consecutive registers in one transport call
+ * @param  reg First register address
+ * @param  buffer Destination for the register contents
+ * @param  len Number of registers to read
+ * @return True if every transfer was acknowledged
+ */
+bool Adafruit_BQ25798::readRegisters(uint8_t reg, uint8_t *buffer,
+                                     uint8_t len) {
+  return transfer(false, reg, buffer, len);
+}
+
+/*!
+ * @brief  Write a run of consecutive registers in one transport call
+ * @param  reg First register address
+ * @param  buffer Register contents to write
+ * @param  len Number of registers to write
+ * @return True if every transfer was acknowledged
+ */
+bool Adafruit_BQ25798::writeRegisters(uint8_t reg, const uint8_t *buffer,
+                                      uint8_t len) {
+  return transfer(true, reg, (uint8_t *)buffer, len);
+}
+
+/*!
+ * @brief  Move a run of registers over the transport, retrying under the
+ *         policy from setRetryPolicy(), and record the outcome in
+ *         last_error
+ * @param  write True to write buffer, false to read into it
+ * @param  reg First register address
+ * @param  buffer Register contents, only read from when writing
+ * @param  len Number of registers
+ * @return True if an attempt was acknowledged
+ */
+bool Adafruit_BQ25798::transfer(bool write, uint8_t reg, uint8_t *buffer,
+                                uint8_t len) {
+  if (!transport) {
+    last_error = BQ25798_ERR_NO_DEVICE;
+    return false;
+  }
+
+  // Never start a transfer on top of one the async queue has in flight,
+  // but do not wait forever on a transport that never finishes it
+  uint32_t wait_us = micros();
+  while (transport->transferStatus() == BQ25798_XFER_BUSY) {
+    if ((uint32_t)(micros() - wait_us) > BQ25798_XFER_TIMEOUT_US) {
+      last_error = BQ25798_ERR_TIMEOUT;
+      return false;
+    }
+  }
+
+  // A write that covers CHARGER_CONTROL_1 anyway can feed the watchdog for
+  // free. The caller's buffer gets its WD_RST bit back afterwards.
+  uint8_t *kick = NULL;
+  if (write && wdt_piggyback && reg <= BQ25798_REG_CHARGER_CONTROL_1 &&
+      reg + len > BQ25798_REG_CHARGER_CONTROL_1) {
+    kick = buffer + (BQ25798_REG_CHARGER_CONTROL_1 - reg);
+    if (*kick & 0x08) {
+      kick = NULL;
+    } else {
+      *kick |= 0x08;
+    }
+  }
+
+  bool ok;
+  for (uint8_t attempt = 1;; attempt++) {
+#ifdef BQ25798_BUS_STATS
+    uint32_t start_us = micros();
+#endif
+    ok = write ? transport->writeRegisters(reg, buffer, len)
+               : transport->readRegisters(reg, buffer, len);
+#ifdef BQ25798_BUS_STATS
+    recordTransaction(write, reg, len, ok, start_us);
+#endif
+    if (ok) {
+      last_error = BQ25798_OK;
+      syncShadow(write, reg, buffer, len);
+      break;
+    }
+    if (attempt >= retry_attempts) {
+      last_error = BQ25798_ERR_BUS;
+      break;
+    }
+
+    // A slave stuck mid-byte holds SDA low until it is clocked out
+    if (retry_recover && transport->recoverBus()) {
+#ifdef BQ25798_BUS_STATS
+      bus_stats.recoveries++;
+#endif
+    }
+    delayMicroseconds((uint32_t)retry_backoff_us << (attempt - 1));
+#ifdef BQ25798_BUS_STATS
+    bus_stats.retries++;
+#endif
+  }
+
+  if (kick) {
+    *kick &= ~0x08;
+  }
+  return ok;
+}
+
+/*!
+ * @brief  Bring the shadow cache in step with a successful transfer
+ * @param  write True for a write, false for a read
+ * @param  reg First register address
+ * @param  buffer Register contents that went over the bus
+ * @param  len Number of registers moved
+ */
+void Adafruit_BQ25798::syncShadow(bool write, uint8_t reg,
+                                  const uint8_t *buffer, uint8_t len) {
+  if (write && reg <= BQ25798_REG_CHARGER_CONTROL_1 &&
+      reg + len > BQ25798_REG_CHARGER_CONTROL_1 &&
+      (buffer[BQ25798_REG_CHARGER_CONTROL_1 - reg] & 0x08)) {
+    wdt_reset_ms = millis();
+  }
+
+  if (!cache_valid) {
+    return;
+  }
+
+  // Anything pulled off the bus is fresher than the shadow copy, except
+  // values staged by a batch that have not been committed yet. Writes go
+  // through and settle the staged value. Self-clearing bits never stick.
+  for (uint8_t i = 0; i < len; i++) {
+    int8_t idx = cacheIndex(reg + i);
+    if (idx < 0 || (!write && isDirty(idx))) {
+      continue;
+    }
+    shadow_regs[idx] = buffer[i] & ~cacheVolatileMask(reg + i);
+    if (write) {
+      shadow_dirty[idx / 8] &= ~(1 << (idx % 8));
+    }
+  }
+}
+
+#ifdef BQ25798_BUS_STATS
+/*!
+ * @brief  Account one transport call in the bus statistics
+ * @param  write True for a write, false for a read
+ * @param  reg First register address
+ * @param  len Number of registers moved
+ * @param  ok Whether the transport reported success
+ * @param  start_us micros() when the call began
+ */
+void Adafruit_BQ25798::recordTransaction(bool write, uint8_t reg, uint8_t len,
+                                         bool ok, uint32_t start_us) {
+  uint32_t elapsed = micros() - start_us;
+
+  if (reg < BQ25798_NUM_REGS) {
+    if (write) {
+      bus_stats.writes[reg]++;
+    } else {
+      bus_stats.reads[reg]++;
+    }
+  }
+  for (uint8_t i = 0; i < len && reg + i < BQ25798_NUM_REGS; i++) {
+    bus_stats.bytes[reg + i]++;
+  }
+
+  if (write) {
+    bus_stats.total_writes++;
+  } else {
+    bus_stats.total_reads++;
+  }
+  bus_stats.total_bytes += len;
+  bus_stats.busy_us += elapsed;
+  if (!ok) {
+    bus_stats.errors++;
+  }
+
+  uint8_t bucket = 0;
+  while (elapsed > 1 && bucket < BQ25798_LATENCY_BUCKETS - 1) {
+    elapsed >>= 1;
+    bucket++;
+  }
+  bus_stats.latency[bucket]++;
+}
+
+/*!
+ * @brief  Take a snapshot of the bus statistics
+ * @param  stats Struct to copy the counters into
+ */
+void Adafruit_BQ25798::getBusStats(bq25798_bus_stats_t &stats) {
+  stats = bus_stats;
+}
+
+/*!
+ * @brief  Zero every bus statistics counter
+ */
+void Adafruit_BQ25798::resetBusStats() {
+  memset(&bus_stats, 0, sizeof(bus_stats));
+}
+#endif
+
+/*!
+ * @brief  Check whether a shadow slot holds an uncommitted batch value
+ * @param  idx Index into shadow_regs
+ * @return True if the slot is dirty
+ */
+bool Adafruit_BQ25798::isDirty(int8_t idx) {
+  return shadow_dirty[idx / 8] & (1 << (idx % 8));
+}
+
+/*!
+ * @brief  Check whether a register run can be served from the shadow cache
+ * @param  reg First register address
+ * @param  len Number of registers
+ * @return True if every register in the run is cached and the cache is valid
+ */
+bool Adafruit_BQ25798::cacheHit(uint8_t reg, uint8_t len) {
+  if (!(cache_enabled || batching) || !cache_valid) {
+    return false;
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    if (cacheIndex(reg + i) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * @brief  Read a bit field from an 8 or 16 bit (MSB first) register
+ * @param  reg Register address
+ * @param  bits Width of the field in bits
+ * @param  shift Bit position of the field's LSB
+ * @param  width Register width in bytes (1 or 2)
+ * @return The field value, or 0 if the read failed
+ */
+uint16_t Adafruit_BQ25798::readBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                                    uint8_t width) {
+  uint16_t value = 0;
+  readBits(reg, bits, shift, width, value);
+  return value;
+}
+
+/*!
+ * @brief  Read a bit field, reporting whether the read succeeded
+ * @param  reg Register address
+ * @param  bits Width of the field in bits
+ * @param  shift Bit position of the field's LSB
+ * @param  width Register width in bytes (1 or 2)
+ * @param  value Set to the field value, left alone if the read failed
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::readBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                                uint8_t width, uint16_t &value) {
+  uint8_t buffer[2] = {0, 0};
+  uint16_t mask = (uint16_t)(((1UL << bits) - 1) << shift);
+
+  // Self-clearing bits only ever live in single byte registers
+  bool uncached =
+      (width == 1) && ((cacheVolatileMask(reg) | cacheLiveMask(reg)) & mask);
+
+  if (!uncached && cacheHit(reg, width)) {
+    for (uint8_t i = 0; i < width; i++) {
+      buffer[i] = shadow_regs[cacheIndex(reg + i)];
+    }
+    last_error = BQ25798_OK;
+  } else if (!readRegisters(reg, buffer, width)) {
+    return false;
+  }
+
+  uint16_t reg_value = (width == 2) ? ((uint16_t)buffer[0] << 8) | buffer[1]
+                                    : buffer[0];
+  value = (reg_value & mask) >> shift;
+  return true;
+}
+
+/*!
+ * @brief  Read-modify-write a bit field in an 8 or 16 bit (MSB first)
+ *         register. With a valid shadow cache the read is skipped.
+ * @param  reg Register address
+ * @param  bits Width of the field in bits
+ * @param  shift Bit position of the field's LSB
+ * @param  value New field value
+ * @param  width Register width in bytes (1 or 2)
+ * @return True if the write was acknowledged
+ */
+bool Adafruit_BQ25798::writeBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                                 uint16_t value, uint8_t width) {
+  uint8_t buffer[2] = {0, 0};
+  uint16_t mask = (uint16_t)(((1UL << bits) - 1) << shift);
+  bool live = (width == 1) && cacheLiveMask(reg);
+
+  if (!live && cacheHit(reg, width)) {
+    for (uint8_t i = 0; i < width; i++) {
+      buffer[i] = shadow_regs[cacheIndex(reg + i)];
+    }
+    last_error = BQ25798_OK;
+  } else if (!readRegisters(reg, buffer, width)) {
+    return false;
+  }
+
+  uint16_t reg_value = (width == 2) ? ((uint16_t)buffer[0] << 8) | buffer[1]
+                                    : buffer[0];
+  reg_value = (reg_value & ~mask) | ((value << shift) & mask);
+
+  if (width == 2) {
+    buffer[0] = reg_value >> 8;
+    buffer[1] = reg_value & 0xFF;
+  } else {
+    buffer[0] = reg_value & 0xFF;
+  }
+
+  // Inside a batch, stage the change in RAM for commit(). Strobes such as
+  // WD_RST must still reach the chip now or they would be lost.
+  bool strobe = (width == 1) && (cacheVolatileMask(reg) & mask);
+  if (batching && !strobe && !live && cacheHit(reg, width)) {
+    for (uint8_t i = 0; i < width; i++) {
+      int8_t idx = cacheIndex(reg + i);
+      shadow_regs[idx] = buffer[i];
+      shadow_dirty[idx / 8] |= 1 << (idx % 8);
+    }
+    last_error = BQ25798_OK;
+    return true;
+  }
+
+  return writeRegisters(reg, buffer, width);
+}
+
+/*!
+ * @brief  Read a field and convert it to its engineering units
+ * @tparam F Field to read
+ * @return Field value, see fieldDecode(). 0 if the read failed.
+ */
+template <bq25798_field_t F> int32_t Adafruit_BQ25798::readField() {
+  constexpr bq25798_field_desc_t field = field_table[F];
+
+  uint16_t raw = readBits(field.reg, field.bits, field.shift, field.width);
+
+  // Same as fieldDecode(), spelled out so every term folds to a constant
+  if (field.flags & BQ25798_FIELD_SIGNED) {
+    return (int32_t)(int16_t)raw * field.scale + field.offset;
+  }
+  return (uint16_t)(raw * field.scale + field.offset);
+}
+
+/*!
+ * @brief  Range check a value in engineering units, round it to the nearest
+ *         LSB step and write it to a field
+ * @tparam F Field to write
+ * @param  value New setting
+ * @return True if successful, false if out of range or the write failed
+ */
+template <bq25798_field_t F>
+bool Adafruit_BQ25798::writeField(int32_t value) {
+  constexpr bq25798_field_desc_t field = field_table[F];
+  constexpr uint16_t raw_max = (1UL << field.bits) - 1;
+  static_assert(!(field.flags & BQ25798_FIELD_RO), "field is read-only");
+
+  // Same as fieldEncode(), spelled out so every term folds to a constant
+  if (value < field.min || value > field.max) {
+    last_error = BQ25798_ERR_INVALID;
+    return false;
+  }
+  uint16_t raw = ((uint16_t)value - field.offset + field.scale / 2) /
+                 field.scale;
+  if (raw > raw_max) {
+    raw = raw_max;
+  }
+
+  return writeBits(field.reg, field.bits, field.shift, raw, field.width);
+}
+
+/*!
+ * @brief  Read any field by ID, e.g. for a remote configuration channel
+ * @param  field Field to read
+ * @return Value in the field's units (see BQ25798_FIELD_LIST), or 0 if the
+ *         ID is unknown or the read failed
+ */
+int32_t Adafruit_BQ25798::getField(bq25798_field_t field) {
+  int32_t value = 0;
+  getField(field, value);
+  return value;
+}
+
+/*!
+ * @brief  Read any field by ID, telling a failed read apart from a value
+ *         that happens to be 0. Every named getter has a field here.
+ * @param  field Field to read
+ * @param  value Set to the value in the field's units, left alone on failure
+ * @return True if successful, false if the ID is unknown or the read failed
+ *         (see getLastError())
+ */
+bool Adafruit_BQ25798::getField(bq25798_field_t field, int32_t &value) {
+  bq25798_field_desc_t desc;
+  uint16_t raw;
+
+  if (!getFieldInfo(field, desc)) {
+    last_error = BQ25798_ERR_INVALID;
+    return false;
+  }
+  if (!readBits(desc.reg, desc.bits, desc.shift, desc.width, raw)) {
+    return false;
+  }
+
+  value = fieldDecode(desc, raw);
+  return true;
+}
+
+/*!
+ * @brief  Write any field by ID, e.g. for a remote configuration channel
+ * @param  field Field to write
+ * @param  value New setting in the field's units, rounded to the nearest LSB
+ * @return True if successful, false if the ID is unknown, the field is
+ *         read-only, the value is out of range or the write failed
+ */
+bool Adafruit_BQ25798::setField(bq25798_field_t field, int32_t value) {
+  bq25798_field_desc_t desc;
+  uint16_t raw;
+
+  if (!getFieldInfo(field, desc) || !fieldEncode(desc, value, raw)) {
+    last_error = BQ25798_ERR_INVALID;
+    return false;
+  }
+
+  return writeBits(desc.reg, desc.bits, desc.shift, raw, desc.width);
+}
+
+/*!
+ * @brief  Read many fields at once. Each register behind the requested
+ *         fields is read only once, neighbouring registers are merged into
+ *         burst reads, and with the shadow cache enabled config registers
+ *         cost nothing.
+ * @param  fields Fields to read, in any order, duplicates allowed
+ * @param  values Filled with one value per entry of fields
+ * @param  count Number of fields
+ * @return True if successful, false if an ID is unknown or a read failed
+ */
+bool Adafruit_BQ25798::getFields(const bq25798_field_t *fields,
+                                 int32_t *values, uint8_t count) {
+  uint8_t image[BQ25798_NUM_REGS];
+  uint8_t wanted[(BQ25798_NUM_REGS + 7) / 8];
+  bq25798_field_desc_t desc;
+
+  memset(wanted, 0, sizeof(wanted));
+
+  // Work out which registers have to come off the bus and take the rest
+  // from the shadow cache
+  for (uint8_t i = 0; i < count; i++) {
+    if (!getFieldInfo(fields[i], desc)) {
+      last_error = BQ25798_ERR_INVALID;
+      return false;
+    }
+    uint16_t mask = (uint16_t)(((1UL << desc.bits) - 1) << desc.shift);
+    for (uint8_t b = 0; b < desc.width; b++) {
+      uint8_t reg = desc.reg + b;
+      uint8_t reg_mask = (desc.width == 2 && b == 0) ? mask >> 8 : mask;
+      bool uncached = (cacheVolatileMask(reg) | cacheLiveMask(reg)) & reg_mask;
+      if (!uncached && cacheHit(reg, 1)) {
+        image[reg] = shadow_regs[cacheIndex(reg)];
+      } else {
+        wanted[reg / 8] |= 1 << (reg % 8);
+      }
+    }
+  }
+
+  // One burst per run of wanted registers, bridging small gaps the same way
+  // commit() does. Never read across the flag registers, that clears them.
+  uint8_t reg = 0;
+  while (reg < BQ25798_NUM_REGS) {
+    if (!(wanted[reg / 8] & (1 << (reg % 8)))) {
+      reg++;
+      continue;
+    }
+
+    uint8_t last = reg;
+    for (uint8_t next = reg + 1; next < BQ25798_NUM_REGS &&
+                                 next - last <= BQ25798_BATCH_MAX_GAP + 1;
+         next++) {
+      if (next >= BQ25798_REG_CHARGER_FLAG_0 &&
+          next <= BQ25798_REG_FAULT_FLAG_1) {
+        break;
+      }
+      if (wanted[next / 8] & (1 << (next % 8))) {
+        last = next;
+      }
+    }
+
+    if (!readRegisters(reg, image + reg, last - reg + 1)) {
+      return false;
+    }
+    reg = last + 1;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    getFieldInfo(fields[i], desc);
+    uint16_t raw = (desc.width == 2)
+                       ? ((uint16_t)image[desc.reg] << 8) | image[desc.reg + 1]
+                       : image[desc.reg];
+    raw = (raw >> desc.shift) & ((1UL << desc.bits) - 1);
+    values[i] = fieldDecode(desc, raw);
+  }
+
+  // Needed when every register came from the shadow cache
+  last_error = BQ25798_OK;
+  return true;
+}
+
+/*!
+ * @brief  Look up where a field lives and how it is scaled
+ * @param  field Field ID
+ * @param  desc Filled with the field's descriptor
+ * @return True if successful, false if the ID is unknown
+ */
+bool Adafruit_BQ25798::getFieldInfo(bq25798_field_t field,
+                                    bq25798_field_desc_t &desc) {
+  if (field >= BQ25798_FIELD_COUNT) {
+    return false;
+  }
+
+  memcpy_P(&desc, &field_table[field], sizeof(desc));
+  return true;
+}
+
+/*!
+ * @brief  Get the datasheet name of a field, e.g. "VREG"
+ * @param  field Field ID
+ * @param  buffer Destination, BQ25798_FIELD_NAME_MAX bytes is always enough
+ * @param  len Size of buffer, the name is truncated to fit
+ * @return True if successful, false if the ID is unknown
+ */
+bool Adafruit_BQ25798::getFieldName(bq25798_field_t field, char *buffer,
+                                    uint8_t len) {
+  if (field >= BQ25798_FIELD_COUNT || len == 0) {
+    return false;
+  }
+
+  const char *name = field_names;
+  for (uint8_t i = 0; i < field; i++) {
+    while (pgm_read_byte(name++)) {
+    }
+  }
+
+  uint8_t n = 0;
+  char c;
+  while (n < len - 1 && (c = pgm_read_byte(name + n))) {
+    buffer[n++] = c;
+  }
+  buffer[n] = 0;
+  return true;
+}
+
+/*!
+ * @brief  Find a field by its datasheet name, e.g. "ICHG"
+ * @param  name Field name, case sensitive
+ * @return Field ID, or BQ25798_FIELD_COUNT if there is no such field
+ */
+bq25798_field_t Adafruit_BQ25798::findField(const char *name) {
+  const char *entry = field_names;
+
+  for (uint8_t i = 0; i < BQ25798_FIELD_COUNT; i++) {
+    uint8_t n = 0;
+    char c;
+    while ((c = pgm_read_byte(entry + n)) && c == name[n]) {
+      n++;
+    }
+    if (!c && !name[n]) {
+      return (bq25798_field_t)i;
+    }
+    while (pgm_read_byte(entry + n)) {
+      n++;
+    }
+    entry += n + 1;
+  }
+
+  return BQ25798_FIELD_COUNT;
+}
+
+/*!
+ * @brief  Set how hard a failed transfer is retried before the call gives
+ *         up. Applies to every getter, setter and burst, and to queued
+ *         operations.
+ *
+ *         Retrying a read of the clear-on-read flag registers can lose
+ *         events if the chip saw the first attempt.
+ * @param  attempts Tries per transfer; 1 (the default) disables retries
+ * @param  backoff_us Wait before the first retry, doubling for each further
+ *         one. Queued operations retry on the next tick() instead.
+ * @param  recover True to have the transport clock a stuck bus free before
+ *         each retry, see Adafruit_BQ25798_Transport::recoverBus()
+ */
+void Adafruit_BQ25798::setRetryPolicy(uint8_t attempts, uint16_t backoff_us,
+                                      bool recover) {
+  retry_attempts = attempts ? attempts : 1;
+  retry_backoff_us = backoff_us;
+  retry_recover = recover;
+}
+
+/*!
+ * @brief  Why the most recent call failed. Set by every bus transfer,
+ *         every rejected setting and every call served from the shadow
+ *         cache or staged in a batch, so check it straight after the call,
+ *         e.g. to tell a getter's failed read apart from a genuine 0.
+ * @return BQ25798_OK if the last transfer succeeded
+ */
+bq25798_error_t Adafruit_BQ25798::getLastError() {
+  return last_error;
+}
+
+/*!
+ * @brief  Opt in to (or out of) the write-through shadow register cache.
+ *         While enabled, config getters are served from RAM and setters
+ *         cost a single write. Status, flag and ADC registers always go to
+ *         the bus.
+ * @param  enable True to enable the cache, false to disable it
+ * @return True if successful, false if the initial fill failed
+ */
+bool Adafruit_BQ25798::enableCache(bool enable) {
+  cache_enabled = enable;
+  cache_valid = false;
+
+  if (!enable || !transport) {
+    // begin() fills the cache once the bus is up
+    return true;
+  }
+
+  return resyncCache();
+}
+
+/*!
+ * @brief  Refill the shadow cache from the chip in three burst reads. Call
+ *         this after anything outside the driver may have changed config
+ *         registers, e.g. a watchdog expiry or a VBUS plug-in clearing HIZ.
+ *         Inside a batch the refill is deferred to commit(), which keeps
+ *         the staged registers and reloads the rest.
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::resyncCache() {
+  if (batching) {
+    resync_pending = true;
+    last_error = BQ25798_OK;
+    return true;
+  }
+
+  if (!cache_enabled) {
+    cache_valid = false;
+    return false;
+  }
+
+  return fillShadow();
+}
+
+/*!
+ * @brief  Load every shadowed register from the chip, dropping anything
+ *         staged by a batch
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::fillShadow() {
+  cache_valid = false;
+  memset(shadow_dirty, 0, sizeof(shadow_dirty));
+
+  if (!readConfigImage(shadow_regs)) {
+    return false;
+  }
+
+  cache_valid = true;
+  return true;
+}
+
+/*!
+ * @brief  Read every shadowable register from the chip in three bursts, in
+ *         shadow_regs layout, with self-clearing bits stripped
+ * @param  image Destination, BQ25798_CACHE_SIZE bytes
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::readConfigImage(uint8_t *image) {
+  uint8_t *ctrl = image + cacheIndex(BQ25798_CACHE_CTRL_FIRST);
+  uint8_t *masks = image + cacheIndex(BQ25798_CACHE_MASK_FIRST);
+  uint8_t *dpdm = image + cacheIndex(BQ25798_REG_DPDM_DRIVER);
+
+  if (!readRegisters(BQ25798_CACHE_CTRL_FIRST, ctrl,
+                     BQ25798_CACHE_CTRL_LAST - BQ25798_CACHE_CTRL_FIRST + 1) ||
+      !readRegisters(BQ25798_CACHE_MASK_FIRST, masks,
+                     BQ25798_CACHE_MASK_LAST - BQ25798_CACHE_MASK_FIRST + 1) ||
+      !readRegisters(BQ25798_REG_DPDM_DRIVER, dpdm, 1)) {
+    return false;
+  }
+
+  for (uint8_t reg = BQ25798_CACHE_CTRL_FIRST; reg <= BQ25798_CACHE_CTRL_LAST;
+       reg++) {
+    image[cacheIndex(reg)] &= ~cacheVolatileMask(reg);
+  }
+
+  return true;
+}
+
+/*!
+ * @brief  CRC-16/CCITT-FALSE used to protect saved configuration and state
+ *         blobs
+ * @param  data Bytes to checksum
+ * @param  len Number of bytes
+ * @return CRC value
+ */
+uint16_t Adafruit_BQ25798::crc16(const uint8_t *data, uint8_t len) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/*!
+ * @brief  Capture every writable control register (0x00-0x18, 0x28-0x30,
+ *         0x47) into a versioned, CRC-protected blob for later
+ *         restoreConfig(). Served from the shadow cache when it is valid,
+ *         otherwise three burst reads.
+ * @param  buffer Destination, BQ25798_CONFIG_SIZE bytes
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::saveConfig(uint8_t *buffer) {
+  buffer[0] = BQ25798_CONFIG_VERSION;
+
+  if (cacheHit(BQ25798_CACHE_CTRL_FIRST, 1)) {
+    memcpy(buffer + 1, shadow_regs, BQ25798_CACHE_SIZE);
+    last_error = BQ25798_OK;
+  } else if (!readConfigImage(buffer + 1)) {
+    return false;
+  }
+
+  uint16_t crc = crc16(buffer, BQ25798_CACHE_SIZE + 1);
+  buffer[BQ25798_CACHE_SIZE + 1] = crc >> 8;
+  buffer[BQ25798_CACHE_SIZE + 2] = crc & 0xFF;
+  return true;
+}
 
 /*!
- * @brief  Instantiates a new BQ25798 class
+ * @brief  Bring the chip back to a configuration captured by saveConfig().
+ *         The live registers are always read first, even with the shadow
+ *         cache on, and only the ones that differ are written, coalesced
+ *         into bursts. The shadow copy is refreshed from the live values.
+ * @param  buffer Blob from saveConfig(), BQ25798_CONFIG_SIZE bytes
+ * @param  changed Optional pointer that receives the number of registers
+ *         that had to be rewritten
+ * @return True if successful, false if the blob is corrupt, from another
+ *         version, a batch is open (its staged changes are left alone) or
+ *         the bus failed
  */
-Adafruit_BQ25798::Adafruit_BQ25798() {
-  i2c_dev = NULL;
+bool Adafruit_BQ25798::restoreConfig(const uint8_t *buffer, uint8_t *changed) {
+  uint16_t crc = ((uint16_t)buffer[BQ25798_CACHE_SIZE + 1] << 8) |
+                 buffer[BQ25798_CACHE_SIZE + 2];
+  if (buffer[0] != BQ25798_CONFIG_VERSION ||
+      crc16(buffer, BQ25798_CACHE_SIZE + 1) != crc) {
+    last_error = BQ25798_ERR_INVALID;
+    return false;
+  }
+
+  // Restoring through the caller's batch would commit its staged changes
+  if (batching) {
+    last_error = BQ25798_ERR_BUSY;
+    return false;
+  }
+
+  // The point is to repair changes made behind the shadow copy's back
+  // (watchdog expiry, another host), so never diff against the cache
+  if (!fillShadow()) {
+    return false;
+  }
+  batching = true;
+
+  uint8_t count = 0;
+  const uint8_t *image = buffer + 1;
+  for (uint8_t idx = 0; idx < BQ25798_CACHE_SIZE; idx++) {
+    if (shadow_regs[idx] != image[idx]) {
+      shadow_regs[idx] = image[idx];
+      shadow_dirty[idx / 8] |= 1 << (idx % 8);
+      count++;
+    }
+  }
+
+  if (changed) {
+    *changed = count;
+  }
+
+  if (!commit()) {
+    // Do not leave a half-written batch open for the next setter
+    bq25798_error_t error = last_error;
+    abortBatch();
+    last_error = error;
+    return false;
+  }
+  return true;
 }
 
 /*!
- * @brief  Destroys the BQ25798 object
+ * @brief  Start a configuration batch. Until commit(), config setters only
+ *         update a RAM image of the registers (getters see the staged
+ *         values), so a whole boot sequence costs a handful of bursts.
+ *         Loads the image with three burst reads unless the shadow cache
+ *         already holds it.
+ * @return True if successful, false if the image could not be read
  */
-Adafruit_BQ25798::~Adafruit_BQ25798() {
-  if (i2c_dev) {
-    delete i2c_dev;
+bool Adafruit_BQ25798::beginBatch() {
+  if (!batching && !cache_valid && !fillShadow()) {
+    return false;
   }
+  batching = true;
+  last_error = BQ25798_OK;
+  return true;
 }
 
 /*!
- * @brief  Sets up the hardware and initializes I2C
- * @param  i2c_addr
- *         The I2C address to be used.
- * @param  wire
- *         The Wire object to be used for I2C connections.
- * @return True if initialization was successful, otherwise false.
+ * @brief  Write every register changed since beginBatch() and end the
+ *         batch. Adjacent dirty registers, including across short runs of
+ *         unchanged ones the chip never changes by itself, go out as a
+ *         single burst.
+ * @return True if successful. On failure the batch stays open with the
+ *         unwritten registers still staged, so commit() can be retried or
+ *         the batch dropped with abortBatch().
  */
-bool Adafruit_BQ25798::begin(uint8_t i2c_addr, TwoWire *wire) {
-  if (i2c_dev) {
-    delete i2c_dev;
+bool Adafruit_BQ25798::commit() {
+  if (!batching) {
+    return false;
   }
 
-  i2c_dev = new Adafruit_I2CDevice(i2c_addr, wire);
+  // A resync requested during the batch (watchdog expiry, reset()) means
+  // the unstaged registers no longer match the chip
+  if (resync_pending) {
+    uint8_t image[BQ25798_CACHE_SIZE];
+    if (!readConfigImage(image)) {
+      return false;
+    }
+    for (uint8_t idx = 0; idx < BQ25798_CACHE_SIZE; idx++) {
+      if (!isDirty(idx)) {
+        shadow_regs[idx] = image[idx];
+      }
+    }
+    resync_pending = false;
+  }
 
-  if (!i2c_dev->begin()) {
-    return false;
+  static const uint8_t runs[][2] = {
+      {BQ25798_CACHE_CTRL_FIRST, BQ25798_CACHE_CTRL_LAST},
+      {BQ25798_CACHE_MASK_FIRST, BQ25798_CACHE_MASK_LAST},
+      {BQ25798_REG_DPDM_DRIVER, BQ25798_REG_DPDM_DRIVER}};
+
+  for (uint8_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+    uint8_t reg = runs[r][0];
+    while (reg <= runs[r][1]) {
+      if (!isDirty(cacheIndex(reg))) {
+        reg++;
+        continue;
+      }
+
+      // Extend the burst while the next dirty register is close enough
+      uint8_t first = reg;
+      uint8_t last = reg;
+      for (uint8_t next = reg + 1;
+           next <= runs[r][1] && next - last <= BQ25798_BATCH_MAX_GAP + 1;
+           next++) {
+        if (isDirty(cacheIndex(next))) {
+          last = next;
+        } else if (!cacheBridgeable(next)) {
+          break;
+        }
+      }
+
+      if (!writeRegisters(first, shadow_regs + cacheIndex(first),
+                          last - first + 1)) {
+        return false;
+      }
+      reg = last + 1;
+    }
   }
 
-  // Check part information register to verify chip
-  Adafruit_BusIO_Register part_info_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_PART_INFORMATION);
-  uint8_t part_info = part_info_reg.read();
-  
-  // Verify part number (bits 5-3 should be 011b = 3h for BQ25798)
-  if ((part_info & 0x38) != 0x18) {
-    return false;
+  batching = false;
+  if (!cache_enabled) {
+    cache_valid = false;
   }
+  last_error = BQ25798_OK; // also when nothing was dirty
+  return true;
+}
 
-  // Reset all registers to default values
-  reset();
+/*!
+ * @brief  Drop every change staged since beginBatch() without writing it
+ */
+void Adafruit_BQ25798::abortBatch() {
+  batching = false;
+  resync_pending = false;
+  cache_valid = false;
+  memset(shadow_dirty, 0, sizeof(shadow_dirty));
 
-  return true;
+  if (cache_enabled) {
+    fillShadow();
+  }
+}
+
+/*!
+ * @brief  Mark the shadow cache stale. Accesses go to the bus until
+ *         resyncCache() is called.
+ */
+void Adafruit_BQ25798::invalidateCache() {
+  cache_valid = false;
+}
+
+/*!
+ * @brief Get the minimal system voltage setting
+ * @return Minimal system voltage in millivolts
+ */
+uint16_t Adafruit_BQ25798::getMinSystem_mV() {
+  return readField<BQ25798_FIELD_VSYSMIN>();
+}
+
+/*!
+ * @brief Set the minimal system voltage
+ * @param millivolts Minimal system voltage in millivolts (2500mV to 16000mV),
+ *        rounded to the nearest 250mV step
+ * @return True if successful, false if voltage out of range
+ */
+bool Adafruit_BQ25798::setMinSystem_mV(uint16_t millivolts) {
+  return writeField<BQ25798_FIELD_VSYSMIN>(millivolts);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the minimal system voltage setting
  * @return Minimal system voltage in volts
  */
 float Adafruit_BQ25798::getMinSystemV() {
-  Adafruit_BusIO_Register vsys_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MINIMAL_SYSTEM_VOLTAGE);
-  Adafruit_BusIO_RegisterBits vsys_bits = Adafruit_BusIO_RegisterBits(&vsys_reg, 6, 0);
-  
-  uint8_t reg_value = vsys_bits.read();
-  
-  // Convert to voltage: (register_value × 250mV) + 2500mV
-  return (reg_value * 0.25f) + 2.5f;
+  return getMinSystem_mV() * 0.001f;
 }
 
 /*!
@@ -95,38 +1225,35 @@ float Adafruit_BQ25798::getMinSystemV() {
  * @return True if successful, false if voltage out of range
  */
 bool Adafruit_BQ25798::setMinSystemV(float voltage) {
-  if (voltage < 2.5f || voltage > 16.0f) {
-    return false;
-  }
-  
-  // Convert voltage to register value: (voltage - 2.5V) / 0.25V
-  uint8_t reg_value = (uint8_t)((voltage - 2.5f) / 0.25f);
-  
-  // Clamp to 6-bit range (0-63)
-  if (reg_value > 63) {
-    reg_value = 63;
-  }
-  
-  Adafruit_BusIO_Register vsys_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MINIMAL_SYSTEM_VOLTAGE);
-  Adafruit_BusIO_RegisterBits vsys_bits = Adafruit_BusIO_RegisterBits(&vsys_reg, 6, 0);
-  
-  vsys_bits.write(reg_value);
-  
-  return true;
+  return setMinSystem_mV(toMilli(voltage));
+}
+#endif
+
+/*!
+ * @brief Get the charge voltage limit setting
+ * @return Charge voltage limit in millivolts
+ */
+uint16_t Adafruit_BQ25798::getChargeLimit_mV() {
+  return readField<BQ25798_FIELD_VREG>();
+}
+
+/*!
+ * @brief Set the charge voltage limit
+ * @param millivolts Charge voltage limit in millivolts (3000mV to 18800mV),
+ *        rounded to the nearest 10mV step
+ * @return True if successful, false if voltage out of range
+ */
+bool Adafruit_BQ25798::setChargeLimit_mV(uint16_t millivolts) {
+  return writeField<BQ25798_FIELD_VREG>(millivolts);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the charge voltage limit setting
  * @return Charge voltage limit in volts
  */
 float Adafruit_BQ25798::getChargeLimitV() {
-  Adafruit_BusIO_Register vreg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGE_VOLTAGE_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits vreg_bits = Adafruit_BusIO_RegisterBits(&vreg_reg, 11, 0);
-  
-  uint16_t reg_value = vreg_bits.read();
-  
-  // Convert to voltage: register_value × 10mV
-  return reg_value * 0.01f;
+  return getChargeLimit_mV() * 0.001f;
 }
 
 /*!
@@ -135,38 +1262,35 @@ float Adafruit_BQ25798::getChargeLimitV() {
  * @return True if successful, false if voltage out of range
  */
 bool Adafruit_BQ25798::setChargeLimitV(float voltage) {
-  if (voltage < 3.0f || voltage > 18.8f) {
-    return false;
-  }
-  
-  // Convert voltage to register value: voltage / 0.01V
-  uint16_t reg_value = (uint16_t)(voltage / 0.01f);
-  
-  // Clamp to 11-bit range (0-2047)
-  if (reg_value > 2047) {
-    reg_value = 2047;
-  }
-  
-  Adafruit_BusIO_Register vreg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGE_VOLTAGE_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits vreg_bits = Adafruit_BusIO_RegisterBits(&vreg_reg, 11, 0);
-  
-  vreg_bits.write(reg_value);
-  
-  return true;
+  return setChargeLimit_mV(toMilli(voltage));
+}
+#endif
+
+/*!
+ * @brief Get the charge current limit setting
+ * @return Charge current limit in milliamps
+ */
+uint16_t Adafruit_BQ25798::getChargeLimit_mA() {
+  return readField<BQ25798_FIELD_ICHG>();
+}
+
+/*!
+ * @brief Set the charge current limit
+ * @param milliamps Charge current limit in milliamps (50mA to 5000mA),
+ *        rounded to the nearest 10mA step
+ * @return True if successful, false if current out of range
+ */
+bool Adafruit_BQ25798::setChargeLimit_mA(uint16_t milliamps) {
+  return writeField<BQ25798_FIELD_ICHG>(milliamps);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the charge current limit setting
  * @return Charge current limit in amps
  */
 float Adafruit_BQ25798::getChargeLimitA() {
-  Adafruit_BusIO_Register ichg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGE_CURRENT_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits ichg_bits = Adafruit_BusIO_RegisterBits(&ichg_reg, 9, 0);
-  
-  uint16_t reg_value = ichg_bits.read();
-  
-  // Convert to current: register_value × 10mA
-  return reg_value * 0.01f;
+  return getChargeLimit_mA() * 0.001f;
 }
 
 /*!
@@ -175,37 +1299,35 @@ float Adafruit_BQ25798::getChargeLimitA() {
  * @return True if successful, false if current out of range
  */
 bool Adafruit_BQ25798::setChargeLimitA(float current) {
-  if (current < 0.05f || current > 5.0f) {
-    return false;
-  }
-  
-  // Convert current to register value: current / 0.01A
-  uint16_t reg_value = (uint16_t)(current / 0.01f);
-  
-  // Clamp to 9-bit range (0-511)
-  if (reg_value > 511) {
-    reg_value = 511;
-  }
-  
-  Adafruit_BusIO_Register ichg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGE_CURRENT_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits ichg_bits = Adafruit_BusIO_RegisterBits(&ichg_reg, 9, 0);
-  
-  ichg_bits.write(reg_value);
-  
-  return true;
+  return setChargeLimit_mA(toMilli(current));
+}
+#endif
+
+/*!
+ * @brief Get the input voltage limit setting
+ * @return Input voltage limit in millivolts
+ */
+uint16_t Adafruit_BQ25798::getInputLimit_mV() {
+  return readField<BQ25798_FIELD_VINDPM>();
 }
 
+/*!
+ * @brief Set the input voltage limit
+ * @param millivolts Input voltage limit in millivolts (3600mV to 22000mV),
+ *        rounded to the nearest 100mV step
+ * @return True if successful, false if voltage out of range
+ */
+bool Adafruit_BQ25798::setInputLimit_mV(uint16_t millivolts) {
+  return writeField<BQ25798_FIELD_VINDPM>(millivolts);
+}
+
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the input voltage limit setting
  * @return Input voltage limit in volts
  */
 float Adafruit_BQ25798::getInputLimitV() {
-  Adafruit_BusIO_Register vindpm_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_INPUT_VOLTAGE_LIMIT);
-  
-  uint8_t reg_value = vindpm_reg.read();
-  
-  // Convert to voltage: register_value × 100mV
-  return reg_value * 0.1f;
+  return getInputLimit_mV() * 0.001f;
 }
 
 /*!
@@ -214,37 +1336,35 @@ float Adafruit_BQ25798::getInputLimitV() {
  * @return True if successful, false if voltage out of range
  */
 bool Adafruit_BQ25798::setInputLimitV(float voltage) {
-  if (voltage < 3.6f || voltage > 22.0f) {
-    return false;
-  }
-  
-  // Convert voltage to register value: voltage / 0.1V
-  uint8_t reg_value = (uint8_t)(voltage / 0.1f);
-  
-  // Clamp to 8-bit range (0-255)
-  if (reg_value > 255) {
-    reg_value = 255;
-  }
-  
-  Adafruit_BusIO_Register vindpm_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_INPUT_VOLTAGE_LIMIT);
-  
-  vindpm_reg.write(reg_value);
-  
-  return true;
+  return setInputLimit_mV(toMilli(voltage));
+}
+#endif
+
+/*!
+ * @brief Get the input current limit setting
+ * @return Input current limit in milliamps
+ */
+uint16_t Adafruit_BQ25798::getInputLimit_mA() {
+  return readField<BQ25798_FIELD_IINDPM>();
+}
+
+/*!
+ * @brief Set the input current limit
+ * @param milliamps Input current limit in milliamps (100mA to 3300mA),
+ *        rounded to the nearest 10mA step
+ * @return True if successful, false if current out of range
+ */
+bool Adafruit_BQ25798::setInputLimit_mA(uint16_t milliamps) {
+  return writeField<BQ25798_FIELD_IINDPM>(milliamps);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the input current limit setting
  * @return Input current limit in amps
  */
 float Adafruit_BQ25798::getInputLimitA() {
-  Adafruit_BusIO_Register iindpm_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_INPUT_CURRENT_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits iindpm_bits = Adafruit_BusIO_RegisterBits(&iindpm_reg, 9, 0);
-  
-  uint16_t reg_value = iindpm_bits.read();
-  
-  // Convert to current: register_value × 10mA
-  return reg_value * 0.01f;
+  return getInputLimit_mA() * 0.001f;
 }
 
 /*!
@@ -253,37 +1373,16 @@ float Adafruit_BQ25798::getInputLimitA() {
  * @return True if successful, false if current out of range
  */
 bool Adafruit_BQ25798::setInputLimitA(float current) {
-  if (current < 0.1f || current > 3.3f) {
-    return false;
-  }
-  
-  // Convert current to register value: current / 0.01A
-  uint16_t reg_value = (uint16_t)(current / 0.01f);
-  
-  // Clamp to 9-bit range (0-511)
-  if (reg_value > 511) {
-    reg_value = 511;
-  }
-  
-  Adafruit_BusIO_Register iindpm_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_INPUT_CURRENT_LIMIT, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits iindpm_bits = Adafruit_BusIO_RegisterBits(&iindpm_reg, 9, 0);
-  
-  iindpm_bits.write(reg_value);
-  
-  return true;
+  return setInputLimit_mA(toMilli(current));
 }
+#endif
 
 /*!
  * @brief Get the battery voltage threshold for precharge to fast charge transition
  * @return Battery voltage threshold as percentage of VREG
  */
 bq25798_vbat_lowv_t Adafruit_BQ25798::getVBatLowV() {
-  Adafruit_BusIO_Register precharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_PRECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits vbat_lowv_bits = Adafruit_BusIO_RegisterBits(&precharge_reg, 2, 6);
-  
-  uint8_t reg_value = vbat_lowv_bits.read();
-  
-  return (bq25798_vbat_lowv_t)reg_value;
+  return (bq25798_vbat_lowv_t)readField<BQ25798_FIELD_VBAT_LOWV>();
 }
 
 /*!
@@ -292,30 +1391,34 @@ bq25798_vbat_lowv_t Adafruit_BQ25798::getVBatLowV() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVBatLowV(bq25798_vbat_lowv_t threshold) {
-  if (threshold > BQ25798_VBAT_LOWV_71_4_PERCENT) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register precharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_PRECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits vbat_lowv_bits = Adafruit_BusIO_RegisterBits(&precharge_reg, 2, 6);
-  
-  vbat_lowv_bits.write((uint8_t)threshold);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VBAT_LOWV>(threshold);
+}
+
+/*!
+ * @brief Get the precharge current limit setting
+ * @return Precharge current limit in milliamps
+ */
+uint16_t Adafruit_BQ25798::getPrechargeLimit_mA() {
+  return readField<BQ25798_FIELD_IPRECHG>();
+}
+
+/*!
+ * @brief Set the precharge current limit
+ * @param milliamps Precharge current limit in milliamps (40mA to 2000mA),
+ *        rounded to the nearest 40mA step
+ * @return True if successful, false if current out of range
+ */
+bool Adafruit_BQ25798::setPrechargeLimit_mA(uint16_t milliamps) {
+  return writeField<BQ25798_FIELD_IPRECHG>(milliamps);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the precharge current limit setting
  * @return Precharge current limit in amps
  */
 float Adafruit_BQ25798::getPrechargeLimitA() {
-  Adafruit_BusIO_Register precharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_PRECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits iprechg_bits = Adafruit_BusIO_RegisterBits(&precharge_reg, 6, 0);
-  
-  uint8_t reg_value = iprechg_bits.read();
-  
-  // Convert to current: register_value × 40mA
-  return reg_value * 0.04f;
+  return getPrechargeLimit_mA() * 0.001f;
 }
 
 /*!
@@ -324,35 +1427,16 @@ float Adafruit_BQ25798::getPrechargeLimitA() {
  * @return True if successful, false if current out of range
  */
 bool Adafruit_BQ25798::setPrechargeLimitA(float current) {
-  if (current < 0.04f || current > 2.0f) {
-    return false;
-  }
-  
-  // Convert current to register value: current / 0.04A
-  uint8_t reg_value = (uint8_t)(current / 0.04f);
-  
-  // Clamp to 6-bit range (0-63)
-  if (reg_value > 63) {
-    reg_value = 63;
-  }
-  
-  Adafruit_BusIO_Register precharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_PRECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits iprechg_bits = Adafruit_BusIO_RegisterBits(&precharge_reg, 6, 0);
-  
-  iprechg_bits.write(reg_value);
-  
-  return true;
+  return setPrechargeLimit_mA(toMilli(current));
 }
+#endif
 
 /*!
  * @brief Get the watchdog timer reset behavior for safety timers
  * @return True if watchdog expiration will NOT reset safety timers, false if it will reset them
  */
 bool Adafruit_BQ25798::getStopOnWDT() {
-  Adafruit_BusIO_Register term_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TERMINATION_CONTROL);
-  Adafruit_BusIO_RegisterBits stop_wd_bit = Adafruit_BusIO_RegisterBits(&term_reg, 1, 5);
-  
-  return stop_wd_bit.read() == 1;
+  return readField<BQ25798_FIELD_STOP_WD_CHG>();
 }
 
 /*!
@@ -361,26 +1445,34 @@ bool Adafruit_BQ25798::getStopOnWDT() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setStopOnWDT(bool stopOnWDT) {
-  Adafruit_BusIO_Register term_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TERMINATION_CONTROL);
-  Adafruit_BusIO_RegisterBits stop_wd_bit = Adafruit_BusIO_RegisterBits(&term_reg, 1, 5);
-  
-  stop_wd_bit.write(stopOnWDT ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_STOP_WD_CHG>(stopOnWDT);
+}
+
+/*!
+ * @brief Get the termination current limit setting
+ * @return Termination current limit in milliamps
+ */
+uint16_t Adafruit_BQ25798::getTermination_mA() {
+  return readField<BQ25798_FIELD_ITERM>();
+}
+
+/*!
+ * @brief Set the termination current limit
+ * @param milliamps Termination current limit in milliamps (40mA to 1000mA),
+ *        rounded to the nearest 40mA step
+ * @return True if successful, false if current out of range
+ */
+bool Adafruit_BQ25798::setTermination_mA(uint16_t milliamps) {
+  return writeField<BQ25798_FIELD_ITERM>(milliamps);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the termination current limit setting
  * @return Termination current limit in amps
  */
 float Adafruit_BQ25798::getTerminationA() {
-  Adafruit_BusIO_Register term_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TERMINATION_CONTROL);
-  Adafruit_BusIO_RegisterBits iterm_bits = Adafruit_BusIO_RegisterBits(&term_reg, 5, 0);
-  
-  uint8_t reg_value = iterm_bits.read();
-  
-  // Convert to current: register_value × 40mA
-  return reg_value * 0.04f;
+  return getTermination_mA() * 0.001f;
 }
 
 /*!
@@ -389,37 +1481,16 @@ float Adafruit_BQ25798::getTerminationA() {
  * @return True if successful, false if current out of range
  */
 bool Adafruit_BQ25798::setTerminationA(float current) {
-  if (current < 0.04f || current > 1.0f) {
-    return false;
-  }
-  
-  // Convert current to register value: current / 0.04A
-  uint8_t reg_value = (uint8_t)(current / 0.04f);
-  
-  // Clamp to 5-bit range (0-31)
-  if (reg_value > 31) {
-    reg_value = 31;
-  }
-  
-  Adafruit_BusIO_Register term_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TERMINATION_CONTROL);
-  Adafruit_BusIO_RegisterBits iterm_bits = Adafruit_BusIO_RegisterBits(&term_reg, 5, 0);
-  
-  iterm_bits.write(reg_value);
-  
-  return true;
+  return setTermination_mA(toMilli(current));
 }
+#endif
 
 /*!
  * @brief Get the battery cell count setting
  * @return Battery cell count
  */
 bq25798_cell_count_t Adafruit_BQ25798::getCellCount() {
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits cell_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 2, 6);
-  
-  uint8_t reg_value = cell_bits.read();
-  
-  return (bq25798_cell_count_t)reg_value;
+  return (bq25798_cell_count_t)readField<BQ25798_FIELD_CELL>();
 }
 
 /*!
@@ -428,16 +1499,7 @@ bq25798_cell_count_t Adafruit_BQ25798::getCellCount() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setCellCount(bq25798_cell_count_t cellCount) {
-  if (cellCount > BQ25798_CELL_COUNT_4S) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits cell_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 2, 6);
-  
-  cell_bits.write((uint8_t)cellCount);
-  
-  return true;
+  return writeField<BQ25798_FIELD_CELL>(cellCount);
 }
 
 /*!
@@ -445,12 +1507,7 @@ bool Adafruit_BQ25798::setCellCount(bq25798_cell_count_t cellCount) {
  * @return Battery recharge deglitch time
  */
 bq25798_trechg_time_t Adafruit_BQ25798::getRechargeDeglitchTime() {
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits trechg_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 2, 4);
-  
-  uint8_t reg_value = trechg_bits.read();
-  
-  return (bq25798_trechg_time_t)reg_value;
+  return (bq25798_trechg_time_t)readField<BQ25798_FIELD_TRECHG>();
 }
 
 /*!
@@ -458,31 +1515,36 @@ bq25798_trechg_time_t Adafruit_BQ25798::getRechargeDeglitchTime() {
  * @param deglitchTime Battery recharge deglitch time (64ms to 2048ms)
  * @return True if successful
  */
-bool Adafruit_BQ25798::setRechargeDeglitchTime(bq25798_trechg_time_t deglitchTime) {
-  if (deglitchTime > BQ25798_TRECHG_2048MS) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits trechg_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 2, 4);
-  
-  trechg_bits.write((uint8_t)deglitchTime);
-  
-  return true;
+bool Adafruit_BQ25798::setRechargeDeglitchTime(
+    bq25798_trechg_time_t deglitchTime) {
+  return writeField<BQ25798_FIELD_TRECHG>(deglitchTime);
+}
+
+/*!
+ * @brief Get the battery recharge threshold offset voltage
+ * @return Recharge threshold offset voltage in millivolts (below VREG)
+ */
+uint16_t Adafruit_BQ25798::getRechargeThreshOffset_mV() {
+  return readField<BQ25798_FIELD_VRECHG>();
+}
+
+/*!
+ * @brief Set the battery recharge threshold offset voltage
+ * @param millivolts Recharge threshold offset voltage in millivolts (50mV to 800mV),
+ *        rounded to the nearest 50mV step
+ * @return True if successful, false if voltage out of range
+ */
+bool Adafruit_BQ25798::setRechargeThreshOffset_mV(uint16_t millivolts) {
+  return writeField<BQ25798_FIELD_VRECHG>(millivolts);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the battery recharge threshold offset voltage
  * @return Recharge threshold offset voltage in volts (below VREG)
  */
 float Adafruit_BQ25798::getRechargeThreshOffsetV() {
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits vrechg_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 4, 0);
-  
-  uint8_t reg_value = vrechg_bits.read();
-  
-  // Convert to voltage: (register_value × 50mV) + 50mV
-  return (reg_value * 0.05f) + 0.05f;
+  return getRechargeThreshOffset_mV() * 0.001f;
 }
 
 /*!
@@ -491,38 +1553,35 @@ float Adafruit_BQ25798::getRechargeThreshOffsetV() {
  * @return True if successful, false if voltage out of range
  */
 bool Adafruit_BQ25798::setRechargeThreshOffsetV(float voltage) {
-  if (voltage < 0.05f || voltage > 0.8f) {
-    return false;
-  }
-  
-  // Convert voltage to register value: (voltage - 0.05V) / 0.05V
-  uint8_t reg_value = (uint8_t)((voltage - 0.05f) / 0.05f);
-  
-  // Clamp to 4-bit range (0-15)
-  if (reg_value > 15) {
-    reg_value = 15;
-  }
-  
-  Adafruit_BusIO_Register recharge_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_RECHARGE_CONTROL);
-  Adafruit_BusIO_RegisterBits vrechg_bits = Adafruit_BusIO_RegisterBits(&recharge_reg, 4, 0);
-  
-  vrechg_bits.write(reg_value);
-  
-  return true;
+  return setRechargeThreshOffset_mV(toMilli(voltage));
+}
+#endif
+
+/*!
+ * @brief Get the OTG mode regulation voltage setting
+ * @return OTG voltage in millivolts
+ */
+uint16_t Adafruit_BQ25798::getOTG_mV() {
+  return readField<BQ25798_FIELD_VOTG>();
+}
+
+/*!
+ * @brief Set the OTG mode regulation voltage
+ * @param millivolts OTG voltage in millivolts (2800mV to 22000mV),
+ *        rounded to the nearest 10mV step
+ * @return True if successful, false if voltage out of range
+ */
+bool Adafruit_BQ25798::setOTG_mV(uint16_t millivolts) {
+  return writeField<BQ25798_FIELD_VOTG>(millivolts);
 }
 
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the OTG mode regulation voltage setting
  * @return OTG voltage in volts
  */
 float Adafruit_BQ25798::getOTGV() {
-  Adafruit_BusIO_Register votg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_VOTG_REGULATION, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits votg_bits = Adafruit_BusIO_RegisterBits(&votg_reg, 11, 0);
-  
-  uint16_t reg_value = votg_bits.read();
-  
-  // Convert to voltage: (register_value × 10mV) + 2800mV
-  return (reg_value * 0.01f) + 2.8f;
+  return getOTG_mV() * 0.001f;
 }
 
 /*!
@@ -531,37 +1590,16 @@ float Adafruit_BQ25798::getOTGV() {
  * @return True if successful, false if voltage out of range
  */
 bool Adafruit_BQ25798::setOTGV(float voltage) {
-  if (voltage < 2.8f || voltage > 22.0f) {
-    return false;
-  }
-  
-  // Convert voltage to register value: (voltage - 2.8V) / 0.01V
-  uint16_t reg_value = (uint16_t)((voltage - 2.8f) / 0.01f);
-  
-  // Clamp to 11-bit range (0-2047)
-  if (reg_value > 2047) {
-    reg_value = 2047;
-  }
-  
-  Adafruit_BusIO_Register votg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_VOTG_REGULATION, 2, MSBFIRST);
-  Adafruit_BusIO_RegisterBits votg_bits = Adafruit_BusIO_RegisterBits(&votg_reg, 11, 0);
-  
-  votg_bits.write(reg_value);
-  
-  return true;
+  return setOTG_mV(toMilli(voltage));
 }
+#endif
 
 /*!
  * @brief Get the precharge safety timer setting
  * @return Precharge timer setting
  */
 bq25798_prechg_timer_t Adafruit_BQ25798::getPrechargeTimer() {
-  Adafruit_BusIO_Register iotg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_IOTG_REGULATION);
-  Adafruit_BusIO_RegisterBits prechg_tmr_bit = Adafruit_BusIO_RegisterBits(&iotg_reg, 1, 7);
-  
-  uint8_t reg_value = prechg_tmr_bit.read();
-  
-  return (bq25798_prechg_timer_t)reg_value;
+  return (bq25798_prechg_timer_t)readField<BQ25798_FIELD_PRECHG_TMR>();
 }
 
 /*!
@@ -570,30 +1608,34 @@ bq25798_prechg_timer_t Adafruit_BQ25798::getPrechargeTimer() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setPrechargeTimer(bq25798_prechg_timer_t timer) {
-  if (timer > BQ25798_PRECHG_TMR_0_5HR) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register iotg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_IOTG_REGULATION);
-  Adafruit_BusIO_RegisterBits prechg_tmr_bit = Adafruit_BusIO_RegisterBits(&iotg_reg, 1, 7);
-  
-  prechg_tmr_bit.write((uint8_t)timer);
-  
-  return true;
+  return writeField<BQ25798_FIELD_PRECHG_TMR>(timer);
+}
+
+/*!
+ * @brief Get the OTG current limit setting
+ * @return OTG current limit in milliamps
+ */
+uint16_t Adafruit_BQ25798::getOTGLimit_mA() {
+  return readField<BQ25798_FIELD_IOTG>();
 }
 
+/*!
+ * @brief Set the OTG current limit
+ * @param milliamps OTG current limit in milliamps (160mA to 3360mA),
+ *        rounded to the nearest 40mA step
+ * @return True if successful, false if current out of range
+ */
+bool Adafruit_BQ25798::setOTGLimit_mA(uint16_t milliamps) {
+  return writeField<BQ25798_FIELD_IOTG>(milliamps);
+}
+
+#ifndef BQ25798_NO_FLOAT
 /*!
  * @brief Get the OTG current limit setting
  * @return OTG current limit in amps
  */
 float Adafruit_BQ25798::getOTGLimitA() {
-  Adafruit_BusIO_Register iotg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_IOTG_REGULATION);
-  Adafruit_BusIO_RegisterBits iotg_bits = Adafruit_BusIO_RegisterBits(&iotg_reg, 7, 0);
-  
-  uint8_t reg_value = iotg_bits.read();
-  
-  // Convert to current: register_value × 40mA
-  return reg_value * 0.04f;
+  return getOTGLimit_mA() * 0.001f;
 }
 
 /*!
@@ -602,37 +1644,16 @@ float Adafruit_BQ25798::getOTGLimitA() {
  * @return True if successful, false if current out of range
  */
 bool Adafruit_BQ25798::setOTGLimitA(float current) {
-  if (current < 0.16f || current > 3.36f) {
-    return false;
-  }
-  
-  // Convert current to register value: current / 0.04A
-  uint8_t reg_value = (uint8_t)(current / 0.04f);
-  
-  // Clamp to 7-bit range (0-127)
-  if (reg_value > 127) {
-    reg_value = 127;
-  }
-  
-  Adafruit_BusIO_Register iotg_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_IOTG_REGULATION);
-  Adafruit_BusIO_RegisterBits iotg_bits = Adafruit_BusIO_RegisterBits(&iotg_reg, 7, 0);
-  
-  iotg_bits.write(reg_value);
-  
-  return true;
+  return setOTGLimit_mA(toMilli(current));
 }
+#endif
 
 /*!
  * @brief Get the top-off timer setting
  * @return Top-off timer setting
  */
 bq25798_topoff_timer_t Adafruit_BQ25798::getTopOffTimer() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits topoff_bits = Adafruit_BusIO_RegisterBits(&timer_reg, 2, 6);
-  
-  uint8_t reg_value = topoff_bits.read();
-  
-  return (bq25798_topoff_timer_t)reg_value;
+  return (bq25798_topoff_timer_t)readField<BQ25798_FIELD_TOPOFF_TMR>();
 }
 
 /*!
@@ -641,16 +1662,7 @@ bq25798_topoff_timer_t Adafruit_BQ25798::getTopOffTimer() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setTopOffTimer(bq25798_topoff_timer_t timer) {
-  if (timer > BQ25798_TOPOFF_TMR_45MIN) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits topoff_bits = Adafruit_BusIO_RegisterBits(&timer_reg, 2, 6);
-  
-  topoff_bits.write((uint8_t)timer);
-  
-  return true;
+  return writeField<BQ25798_FIELD_TOPOFF_TMR>(timer);
 }
 
 /*!
@@ -658,10 +1670,7 @@ bool Adafruit_BQ25798::setTopOffTimer(bq25798_topoff_timer_t timer) {
  * @return True if trickle charge timer is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getTrickleChargeTimerEnable() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits trickle_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 5);
-  
-  return trickle_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_TRICHG_TMR>();
 }
 
 /*!
@@ -670,12 +1679,7 @@ bool Adafruit_BQ25798::getTrickleChargeTimerEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setTrickleChargeTimerEnable(bool enable) {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits trickle_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 5);
-  
-  trickle_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_TRICHG_TMR>(enable);
 }
 
 /*!
@@ -683,10 +1687,7 @@ bool Adafruit_BQ25798::setTrickleChargeTimerEnable(bool enable) {
  * @return True if precharge timer is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getPrechargeTimerEnable() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits prechg_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 4);
-  
-  return prechg_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_PRECHG_TMR>();
 }
 
 /*!
@@ -695,12 +1696,7 @@ bool Adafruit_BQ25798::getPrechargeTimerEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setPrechargeTimerEnable(bool enable) {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits prechg_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 4);
-  
-  prechg_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_PRECHG_TMR>(enable);
 }
 
 /*!
@@ -708,10 +1704,7 @@ bool Adafruit_BQ25798::setPrechargeTimerEnable(bool enable) {
  * @return True if fast charge timer is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getFastChargeTimerEnable() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits chg_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 3);
-  
-  return chg_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_CHG_TMR>();
 }
 
 /*!
@@ -720,12 +1713,7 @@ bool Adafruit_BQ25798::getFastChargeTimerEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setFastChargeTimerEnable(bool enable) {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits chg_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 3);
-  
-  chg_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_CHG_TMR>(enable);
 }
 
 /*!
@@ -733,12 +1721,7 @@ bool Adafruit_BQ25798::setFastChargeTimerEnable(bool enable) {
  * @return Fast charge timer setting
  */
 bq25798_chg_timer_t Adafruit_BQ25798::getFastChargeTimer() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits chg_tmr_bits = Adafruit_BusIO_RegisterBits(&timer_reg, 2, 1);
-  
-  uint8_t reg_value = chg_tmr_bits.read();
-  
-  return (bq25798_chg_timer_t)reg_value;
+  return (bq25798_chg_timer_t)readField<BQ25798_FIELD_CHG_TMR>();
 }
 
 /*!
@@ -747,16 +1730,7 @@ bq25798_chg_timer_t Adafruit_BQ25798::getFastChargeTimer() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setFastChargeTimer(bq25798_chg_timer_t timer) {
-  if (timer > BQ25798_CHG_TMR_24HR) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits chg_tmr_bits = Adafruit_BusIO_RegisterBits(&timer_reg, 2, 1);
-  
-  chg_tmr_bits.write((uint8_t)timer);
-  
-  return true;
+  return writeField<BQ25798_FIELD_CHG_TMR>(timer);
 }
 
 /*!
@@ -764,10 +1738,7 @@ bool Adafruit_BQ25798::setFastChargeTimer(bq25798_chg_timer_t timer) {
  * @return True if timer half-rate is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getTimerHalfRateEnable() {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits tmr2x_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 0);
-  
-  return tmr2x_bit.read() == 1;
+  return readField<BQ25798_FIELD_TMR2X_EN>();
 }
 
 /*!
@@ -776,12 +1747,7 @@ bool Adafruit_BQ25798::getTimerHalfRateEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setTimerHalfRateEnable(bool enable) {
-  Adafruit_BusIO_Register timer_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TIMER_CONTROL);
-  Adafruit_BusIO_RegisterBits tmr2x_bit = Adafruit_BusIO_RegisterBits(&timer_reg, 1, 0);
-  
-  tmr2x_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_TMR2X_EN>(enable);
 }
 
 /*!
@@ -789,10 +1755,7 @@ bool Adafruit_BQ25798::setTimerHalfRateEnable(bool enable) {
  * @return True if automatic OVP battery discharge is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getAutoOVPBattDischarge() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits auto_ibatdis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 7);
-  
-  return auto_ibatdis_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_AUTO_IBATDIS>();
 }
 
 /*!
@@ -801,12 +1764,7 @@ bool Adafruit_BQ25798::getAutoOVPBattDischarge() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setAutoOVPBattDischarge(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits auto_ibatdis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 7);
-  
-  auto_ibatdis_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_AUTO_IBATDIS>(enable);
 }
 
 /*!
@@ -814,10 +1772,7 @@ bool Adafruit_BQ25798::setAutoOVPBattDischarge(bool enable) {
  * @return True if force battery discharge is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getForceBattDischarge() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits force_ibatdis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 6);
-  
-  return force_ibatdis_bit.read() == 1;
+  return readField<BQ25798_FIELD_FORCE_IBATDIS>();
 }
 
 /*!
@@ -826,12 +1781,7 @@ bool Adafruit_BQ25798::getForceBattDischarge() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setForceBattDischarge(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits force_ibatdis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 6);
-  
-  force_ibatdis_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_FORCE_IBATDIS>(enable);
 }
 
 /*!
@@ -839,10 +1789,7 @@ bool Adafruit_BQ25798::setForceBattDischarge(bool enable) {
  * @return True if charging is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getChargeEnable() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_chg_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 5);
-  
-  return en_chg_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_CHG>();
 }
 
 /*!
@@ -851,12 +1798,7 @@ bool Adafruit_BQ25798::getChargeEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setChargeEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_chg_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 5);
-  
-  en_chg_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_CHG>(enable);
 }
 
 /*!
@@ -864,10 +1806,7 @@ bool Adafruit_BQ25798::setChargeEnable(bool enable) {
  * @return True if ICO is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getICOEnable() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_ico_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 4);
-  
-  return en_ico_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_ICO>();
 }
 
 /*!
@@ -876,12 +1815,7 @@ bool Adafruit_BQ25798::getICOEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setICOEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_ico_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 4);
-  
-  en_ico_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_ICO>(enable);
 }
 
 /*!
@@ -889,10 +1823,7 @@ bool Adafruit_BQ25798::setICOEnable(bool enable) {
  * @return True if force ICO is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getForceICO() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits force_ico_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 3);
-  
-  return force_ico_bit.read() == 1;
+  return readField<BQ25798_FIELD_FORCE_ICO>();
 }
 
 /*!
@@ -901,12 +1832,7 @@ bool Adafruit_BQ25798::getForceICO() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setForceICO(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits force_ico_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 3);
-  
-  force_ico_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_FORCE_ICO>(enable);
 }
 
 /*!
@@ -914,10 +1840,7 @@ bool Adafruit_BQ25798::setForceICO(bool enable) {
  * @return True if HIZ mode is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getHIZMode() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_hiz_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 2);
-  
-  return en_hiz_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_HIZ>();
 }
 
 /*!
@@ -926,12 +1849,7 @@ bool Adafruit_BQ25798::getHIZMode() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setHIZMode(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_hiz_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 2);
-  
-  en_hiz_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_HIZ>(enable);
 }
 
 /*!
@@ -939,10 +1857,7 @@ bool Adafruit_BQ25798::setHIZMode(bool enable) {
  * @return True if charge termination is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getTerminationEnable() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_term_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 1);
-  
-  return en_term_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_TERM>();
 }
 
 /*!
@@ -951,12 +1866,7 @@ bool Adafruit_BQ25798::getTerminationEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setTerminationEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_term_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 1);
-  
-  en_term_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_TERM>(enable);
 }
 
 /*!
@@ -964,10 +1874,7 @@ bool Adafruit_BQ25798::setTerminationEnable(bool enable) {
  * @return True if backup mode is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getBackupModeEnable() {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_backup_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 0);
-  
-  return en_backup_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_BACKUP>();
 }
 
 /*!
@@ -976,12 +1883,7 @@ bool Adafruit_BQ25798::getBackupModeEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBackupModeEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl0_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_0);
-  Adafruit_BusIO_RegisterBits en_backup_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl0_reg, 1, 0);
-  
-  en_backup_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_BACKUP>(enable);
 }
 
 /*!
@@ -989,12 +1891,7 @@ bool Adafruit_BQ25798::setBackupModeEnable(bool enable) {
  * @return Backup mode threshold setting
  */
 bq25798_vbus_backup_t Adafruit_BQ25798::getBackupModeThresh() {
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits vbus_backup_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 2, 6);
-  
-  uint8_t reg_value = vbus_backup_bits.read();
-  
-  return (bq25798_vbus_backup_t)reg_value;
+  return (bq25798_vbus_backup_t)readField<BQ25798_FIELD_VBUS_BACKUP>();
 }
 
 /*!
@@ -1003,16 +1900,7 @@ bq25798_vbus_backup_t Adafruit_BQ25798::getBackupModeThresh() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBackupModeThresh(bq25798_vbus_backup_t threshold) {
-  if (threshold > BQ25798_VBUS_BACKUP_100_PERCENT) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits vbus_backup_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 2, 6);
-  
-  vbus_backup_bits.write((uint8_t)threshold);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VBUS_BACKUP>(threshold);
 }
 
 /*!
@@ -1020,12 +1908,7 @@ bool Adafruit_BQ25798::setBackupModeThresh(bq25798_vbus_backup_t threshold) {
  * @return VAC OVP threshold setting
  */
 bq25798_vac_ovp_t Adafruit_BQ25798::getVACOVP() {
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits vac_ovp_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 2, 4);
-  
-  uint8_t reg_value = vac_ovp_bits.read();
-  
-  return (bq25798_vac_ovp_t)reg_value;
+  return (bq25798_vac_ovp_t)readField<BQ25798_FIELD_VAC_OVP>();
 }
 
 /*!
@@ -1034,16 +1917,7 @@ bq25798_vac_ovp_t Adafruit_BQ25798::getVACOVP() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVACOVP(bq25798_vac_ovp_t threshold) {
-  if (threshold > BQ25798_VAC_OVP_7V) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits vac_ovp_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 2, 4);
-  
-  vac_ovp_bits.write((uint8_t)threshold);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VAC_OVP>(threshold);
 }
 
 /*!
@@ -1051,12 +1925,36 @@ bool Adafruit_BQ25798::setVACOVP(bq25798_vac_ovp_t threshold) {
  * @return True if successful
  */
 bool Adafruit_BQ25798::resetWDT() {
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits wd_rst_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 1, 3);
-  
-  wd_rst_bit.write(1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_WD_RST>(1);
+}
+
+/*!
+ * @brief Check whether the watchdog has expired. Expiry reloads the
+ *        register defaults, see Adafruit_BQ25798_Watchdog.
+ * @return True if WD_STAT is set. False if it is clear or the read failed,
+ *         tell the two apart with getLastError().
+ */
+bool Adafruit_BQ25798::getWDTStatus() {
+  return readBits(BQ25798_REG_CHARGER_STATUS_0, 1, 5);
+}
+
+/*!
+ * @brief Feed the watchdog with every blocking write that covers
+ *        CHARGER_CONTROL_1 (0x10), by setting its WD_RST bit on the way
+ *        out. Setting changes to that register then double as kicks.
+ * @param enable True to piggyback kicks, false to write 0x10 as given
+ */
+void Adafruit_BQ25798::setWDTPiggyback(bool enable) {
+  wdt_piggyback = enable;
+}
+
+/*!
+ * @brief Get when the watchdog was last fed, by resetWDT() or by any
+ *        other write that carried WD_RST
+ * @return millis() of that write, 0 if there has been none
+ */
+uint32_t Adafruit_BQ25798::getLastWDTReset() {
+  return wdt_reset_ms;
 }
 
 /*!
@@ -1064,12 +1962,7 @@ bool Adafruit_BQ25798::resetWDT() {
  * @return Watchdog timer setting
  */
 bq25798_wdt_t Adafruit_BQ25798::getWDT() {
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits watchdog_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 3, 0);
-  
-  uint8_t reg_value = watchdog_bits.read();
-  
-  return (bq25798_wdt_t)reg_value;
+  return (bq25798_wdt_t)readField<BQ25798_FIELD_WATCHDOG>();
 }
 
 /*!
@@ -1078,16 +1971,7 @@ bq25798_wdt_t Adafruit_BQ25798::getWDT() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setWDT(bq25798_wdt_t timer) {
-  if (timer > BQ25798_WDT_160S) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl1_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_1);
-  Adafruit_BusIO_RegisterBits watchdog_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl1_reg, 3, 0);
-  
-  watchdog_bits.write((uint8_t)timer);
-  
-  return true;
+  return writeField<BQ25798_FIELD_WATCHDOG>(timer);
 }
 
 /*!
@@ -1095,10 +1979,7 @@ bool Adafruit_BQ25798::setWDT(bq25798_wdt_t timer) {
  * @return True if force D+/D- detection is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getForceDPinsDetection() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits force_indet_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 7);
-  
-  return force_indet_bit.read() == 1;
+  return readField<BQ25798_FIELD_FORCE_INDET>();
 }
 
 /*!
@@ -1107,12 +1988,7 @@ bool Adafruit_BQ25798::getForceDPinsDetection() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setForceDPinsDetection(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits force_indet_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 7);
-  
-  force_indet_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_FORCE_INDET>(enable);
 }
 
 /*!
@@ -1120,10 +1996,7 @@ bool Adafruit_BQ25798::setForceDPinsDetection(bool enable) {
  * @return True if auto D+/D- detection is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getAutoDPinsDetection() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits auto_indet_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 6);
-  
-  return auto_indet_bit.read() == 1;
+  return readField<BQ25798_FIELD_AUTO_INDET_EN>();
 }
 
 /*!
@@ -1132,12 +2005,7 @@ bool Adafruit_BQ25798::getAutoDPinsDetection() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setAutoDPinsDetection(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits auto_indet_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 6);
-  
-  auto_indet_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_AUTO_INDET_EN>(enable);
 }
 
 /*!
@@ -1145,10 +2013,7 @@ bool Adafruit_BQ25798::setAutoDPinsDetection(bool enable) {
  * @return True if HVDCP 12V is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getHVDCP12VEnable() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits en_12v_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 5);
-  
-  return en_12v_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_12V>();
 }
 
 /*!
@@ -1157,12 +2022,7 @@ bool Adafruit_BQ25798::getHVDCP12VEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setHVDCP12VEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits en_12v_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 5);
-  
-  en_12v_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_12V>(enable);
 }
 
 /*!
@@ -1170,10 +2030,7 @@ bool Adafruit_BQ25798::setHVDCP12VEnable(bool enable) {
  * @return True if HVDCP 9V is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getHVDCP9VEnable() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits en_9v_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 4);
-  
-  return en_9v_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_9V>();
 }
 
 /*!
@@ -1182,12 +2039,7 @@ bool Adafruit_BQ25798::getHVDCP9VEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setHVDCP9VEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits en_9v_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 4);
-  
-  en_9v_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_9V>(enable);
 }
 
 /*!
@@ -1195,10 +2047,7 @@ bool Adafruit_BQ25798::setHVDCP9VEnable(bool enable) {
  * @return True if HVDCP is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getHVDCPEnable() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits hvdcp_en_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 3);
-  
-  return hvdcp_en_bit.read() == 1;
+  return readField<BQ25798_FIELD_HVDCP_EN>();
 }
 
 /*!
@@ -1207,12 +2056,7 @@ bool Adafruit_BQ25798::getHVDCPEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setHVDCPEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits hvdcp_en_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 3);
-  
-  hvdcp_en_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_HVDCP_EN>(enable);
 }
 
 /*!
@@ -1220,12 +2064,7 @@ bool Adafruit_BQ25798::setHVDCPEnable(bool enable) {
  * @return Ship FET mode setting
  */
 bq25798_sdrv_ctrl_t Adafruit_BQ25798::getShipFETmode() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits sdrv_ctrl_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 2, 1);
-  
-  uint8_t reg_value = sdrv_ctrl_bits.read();
-  
-  return (bq25798_sdrv_ctrl_t)reg_value;
+  return (bq25798_sdrv_ctrl_t)readField<BQ25798_FIELD_SDRV_CTRL>();
 }
 
 /*!
@@ -1234,16 +2073,7 @@ bq25798_sdrv_ctrl_t Adafruit_BQ25798::getShipFETmode() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setShipFETmode(bq25798_sdrv_ctrl_t mode) {
-  if (mode > BQ25798_SDRV_SYSTEM_RESET) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits sdrv_ctrl_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 2, 1);
-  
-  sdrv_ctrl_bits.write((uint8_t)mode);
-  
-  return true;
+  return writeField<BQ25798_FIELD_SDRV_CTRL>(mode);
 }
 
 /*!
@@ -1251,10 +2081,7 @@ bool Adafruit_BQ25798::setShipFETmode(bq25798_sdrv_ctrl_t mode) {
  * @return True if ship FET 10s delay is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getShipFET10sDelay() {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits sdrv_dly_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 0);
-  
-  return sdrv_dly_bit.read() == 1;
+  return readField<BQ25798_FIELD_SDRV_DLY>();
 }
 
 /*!
@@ -1263,12 +2090,7 @@ bool Adafruit_BQ25798::getShipFET10sDelay() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setShipFET10sDelay(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl2_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_2);
-  Adafruit_BusIO_RegisterBits sdrv_dly_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl2_reg, 1, 0);
-  
-  sdrv_dly_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_SDRV_DLY>(enable);
 }
 
 /*!
@@ -1276,11 +2098,7 @@ bool Adafruit_BQ25798::setShipFET10sDelay(bool enable) {
  * @return True if AC driver is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getACenable() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_acdrv_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 7);
-  
-  // Invert the DIS_ACDRV bit - 1 = disabled, 0 = enabled
-  return dis_acdrv_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_ACDRV>();
 }
 
 /*!
@@ -1289,13 +2107,7 @@ bool Adafruit_BQ25798::getACenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setACenable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_acdrv_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 7);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_acdrv_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_ACDRV>(!enable);
 }
 
 /*!
@@ -1303,10 +2115,7 @@ bool Adafruit_BQ25798::setACenable(bool enable) {
  * @return True if OTG is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getOTGenable() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits en_otg_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 6);
-  
-  return en_otg_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_OTG>();
 }
 
 /*!
@@ -1315,12 +2124,7 @@ bool Adafruit_BQ25798::getOTGenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setOTGenable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits en_otg_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 6);
-  
-  en_otg_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_OTG>(enable);
 }
 
 /*!
@@ -1328,11 +2132,7 @@ bool Adafruit_BQ25798::setOTGenable(bool enable) {
  * @return True if OTG PFM is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getOTGPFM() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits pfm_otg_dis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 5);
-  
-  // Invert the PFM_OTG_DIS bit - 1 = disabled, 0 = enabled
-  return pfm_otg_dis_bit.read() == 0;
+  return !readField<BQ25798_FIELD_PFM_OTG_DIS>();
 }
 
 /*!
@@ -1341,13 +2141,7 @@ bool Adafruit_BQ25798::getOTGPFM() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setOTGPFM(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits pfm_otg_dis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 5);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  pfm_otg_dis_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_PFM_OTG_DIS>(!enable);
 }
 
 /*!
@@ -1355,11 +2149,7 @@ bool Adafruit_BQ25798::setOTGPFM(bool enable) {
  * @return True if forward PFM is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getForwardPFM() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits pfm_fwd_dis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 4);
-  
-  // Invert the PFM_FWD_DIS bit - 1 = disabled, 0 = enabled
-  return pfm_fwd_dis_bit.read() == 0;
+  return !readField<BQ25798_FIELD_PFM_FWD_DIS>();
 }
 
 /*!
@@ -1368,13 +2158,7 @@ bool Adafruit_BQ25798::getForwardPFM() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setForwardPFM(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits pfm_fwd_dis_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 4);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  pfm_fwd_dis_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_PFM_FWD_DIS>(!enable);
 }
 
 /*!
@@ -1382,12 +2166,7 @@ bool Adafruit_BQ25798::setForwardPFM(bool enable) {
  * @return Ship mode wakeup delay setting
  */
 bq25798_wkup_dly_t Adafruit_BQ25798::getShipWakeupDelay() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits wkup_dly_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 3);
-  
-  uint8_t reg_value = wkup_dly_bit.read();
-  
-  return (bq25798_wkup_dly_t)reg_value;
+  return (bq25798_wkup_dly_t)readField<BQ25798_FIELD_WKUP_DLY>();
 }
 
 /*!
@@ -1396,16 +2175,7 @@ bq25798_wkup_dly_t Adafruit_BQ25798::getShipWakeupDelay() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setShipWakeupDelay(bq25798_wkup_dly_t delay) {
-  if (delay > BQ25798_WKUP_DLY_15MS) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits wkup_dly_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 3);
-  
-  wkup_dly_bit.write((uint8_t)delay);
-  
-  return true;
+  return writeField<BQ25798_FIELD_WKUP_DLY>(delay);
 }
 
 /*!
@@ -1413,11 +2183,7 @@ bool Adafruit_BQ25798::setShipWakeupDelay(bq25798_wkup_dly_t delay) {
  * @return True if BATFET LDO precharge is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getBATFETLDOprecharge() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_ldo_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 2);
-  
-  // Invert the DIS_LDO bit - 1 = disabled, 0 = enabled
-  return dis_ldo_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_LDO>();
 }
 
 /*!
@@ -1426,13 +2192,7 @@ bool Adafruit_BQ25798::getBATFETLDOprecharge() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBATFETLDOprecharge(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_ldo_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 2);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_ldo_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_LDO>(!enable);
 }
 
 /*!
@@ -1440,11 +2200,7 @@ bool Adafruit_BQ25798::setBATFETLDOprecharge(bool enable) {
  * @return True if OTG OOA is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getOTGOOA() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_otg_ooa_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 1);
-  
-  // Invert the DIS_OTG_OOA bit - 1 = disabled, 0 = enabled
-  return dis_otg_ooa_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_OTG_OOA>();
 }
 
 /*!
@@ -1453,13 +2209,7 @@ bool Adafruit_BQ25798::getOTGOOA() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setOTGOOA(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_otg_ooa_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 1);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_otg_ooa_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_OTG_OOA>(!enable);
 }
 
 /*!
@@ -1467,11 +2217,7 @@ bool Adafruit_BQ25798::setOTGOOA(bool enable) {
  * @return True if forward OOA is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getForwardOOA() {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_fwd_ooa_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 0);
-  
-  // Invert the DIS_FWD_OOA bit - 1 = disabled, 0 = enabled
-  return dis_fwd_ooa_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_FWD_OOA>();
 }
 
 /*!
@@ -1480,13 +2226,7 @@ bool Adafruit_BQ25798::getForwardOOA() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setForwardOOA(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl3_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_3);
-  Adafruit_BusIO_RegisterBits dis_fwd_ooa_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl3_reg, 1, 0);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_fwd_ooa_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_FWD_OOA>(!enable);
 }
 
 /*!
@@ -1494,10 +2234,7 @@ bool Adafruit_BQ25798::setForwardOOA(bool enable) {
  * @return True if ACDRV2 is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getACDRV2enable() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_acdrv2_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 7);
-  
-  return en_acdrv2_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_ACDRV2>();
 }
 
 /*!
@@ -1506,12 +2243,7 @@ bool Adafruit_BQ25798::getACDRV2enable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setACDRV2enable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_acdrv2_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 7);
-  
-  en_acdrv2_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_ACDRV2>(enable);
 }
 
 /*!
@@ -1519,10 +2251,7 @@ bool Adafruit_BQ25798::setACDRV2enable(bool enable) {
  * @return True if ACDRV1 is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getACDRV1enable() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_acdrv1_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 6);
-  
-  return en_acdrv1_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_ACDRV1>();
 }
 
 /*!
@@ -1531,12 +2260,7 @@ bool Adafruit_BQ25798::getACDRV1enable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setACDRV1enable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_acdrv1_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 6);
-  
-  en_acdrv1_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_ACDRV1>(enable);
 }
 
 /*!
@@ -1544,12 +2268,7 @@ bool Adafruit_BQ25798::setACDRV1enable(bool enable) {
  * @return PWM frequency setting
  */
 bq25798_pwm_freq_t Adafruit_BQ25798::getPWMFrequency() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits pwm_freq_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 5);
-  
-  uint8_t reg_value = pwm_freq_bit.read();
-  
-  return (bq25798_pwm_freq_t)reg_value;
+  return (bq25798_pwm_freq_t)readField<BQ25798_FIELD_PWM_FREQ>();
 }
 
 /*!
@@ -1558,16 +2277,7 @@ bq25798_pwm_freq_t Adafruit_BQ25798::getPWMFrequency() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setPWMFrequency(bq25798_pwm_freq_t frequency) {
-  if (frequency > BQ25798_PWM_FREQ_750KHZ) {
-    return false;
-  }
-  
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits pwm_freq_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 5);
-  
-  pwm_freq_bit.write((uint8_t)frequency);
-  
-  return true;
+  return writeField<BQ25798_FIELD_PWM_FREQ>(frequency);
 }
 
 /*!
@@ -1575,11 +2285,7 @@ bool Adafruit_BQ25798::setPWMFrequency(bq25798_pwm_freq_t frequency) {
  * @return True if STAT pin is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getStatPinEnable() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_stat_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 4);
-  
-  // Invert the DIS_STAT bit - 1 = disabled, 0 = enabled
-  return dis_stat_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_STAT>();
 }
 
 /*!
@@ -1588,13 +2294,7 @@ bool Adafruit_BQ25798::getStatPinEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setStatPinEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_stat_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 4);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_stat_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_STAT>(!enable);
 }
 
 /*!
@@ -1602,11 +2302,7 @@ bool Adafruit_BQ25798::setStatPinEnable(bool enable) {
  * @return True if VSYS short protection is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getVSYSshortProtect() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_vsys_short_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 3);
-  
-  // Invert the DIS_VSYS_SHORT bit - 1 = disabled, 0 = enabled
-  return dis_vsys_short_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_VSYS_SHORT>();
 }
 
 /*!
@@ -1615,13 +2311,7 @@ bool Adafruit_BQ25798::getVSYSshortProtect() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVSYSshortProtect(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_vsys_short_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 3);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_vsys_short_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_VSYS_SHORT>(!enable);
 }
 
 /*!
@@ -1629,11 +2319,7 @@ bool Adafruit_BQ25798::setVSYSshortProtect(bool enable) {
  * @return True if VOTG UVP protection is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getVOTG_UVPProtect() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_votg_uvp_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 2);
-  
-  // Invert the DIS_VOTG_UVP bit - 1 = disabled, 0 = enabled
-  return dis_votg_uvp_bit.read() == 0;
+  return !readField<BQ25798_FIELD_DIS_VOTG_UVP>();
 }
 
 /*!
@@ -1642,13 +2328,7 @@ bool Adafruit_BQ25798::getVOTG_UVPProtect() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVOTG_UVPProtect(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits dis_votg_uvp_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 2);
-  
-  // Invert the enable logic - write 0 to enable, 1 to disable
-  dis_votg_uvp_bit.write(enable ? 0 : 1);
-  
-  return true;
+  return writeField<BQ25798_FIELD_DIS_VOTG_UVP>(!enable);
 }
 
 /*!
@@ -1657,12 +2337,7 @@ bool Adafruit_BQ25798::setVOTG_UVPProtect(bool enable) {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVINDPMdetection(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits force_vindpm_det_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 1);
-  
-  force_vindpm_det_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_FORCE_VINDPM_DET>(enable);
 }
 
 /*!
@@ -1670,10 +2345,7 @@ bool Adafruit_BQ25798::setVINDPMdetection(bool enable) {
  * @return True if VINDPM detection is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getVINDPMdetection() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits force_vindpm_det_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 1);
-  
-  return force_vindpm_det_bit.read() == 1;
+  return readField<BQ25798_FIELD_FORCE_VINDPM_DET>();
 }
 
 /*!
@@ -1681,10 +2353,7 @@ bool Adafruit_BQ25798::getVINDPMdetection() {
  * @return True if IBUS OCP is enabled, false if disabled
  */
 bool Adafruit_BQ25798::getIBUS_OCPenable() {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_ibus_ocp_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 0);
-  
-  return en_ibus_ocp_bit.read() == 1;
+  return readField<BQ25798_FIELD_EN_IBUS_OCP>();
 }
 
 /*!
@@ -1693,12 +2362,7 @@ bool Adafruit_BQ25798::getIBUS_OCPenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setIBUS_OCPenable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl4_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_4);
-  Adafruit_BusIO_RegisterBits en_ibus_ocp_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl4_reg, 1, 0);
-  
-  en_ibus_ocp_bit.write(enable ? 1 : 0);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_IBUS_OCP>(enable);
 }
 
 /*!
@@ -1706,10 +2370,7 @@ bool Adafruit_BQ25798::setIBUS_OCPenable(bool enable) {
  * @return True if ship FET is present
  */
 bool Adafruit_BQ25798::getShipFETpresent() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits sfet_present_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 7);
-  
-  return sfet_present_bit.read();
+  return readField<BQ25798_FIELD_SFET_PRESENT>();
 }
 
 /*!
@@ -1718,12 +2379,7 @@ bool Adafruit_BQ25798::getShipFETpresent() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setShipFETpresent(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits sfet_present_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 7);
-  
-  sfet_present_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_SFET_PRESENT>(enable);
 }
 
 /*!
@@ -1731,10 +2387,7 @@ bool Adafruit_BQ25798::setShipFETpresent(bool enable) {
  * @return True if battery discharge sense is enabled
  */
 bool Adafruit_BQ25798::getBatDischargeSenseEnable() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_ibat_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 5);
-  
-  return en_ibat_bit.read();
+  return readField<BQ25798_FIELD_EN_IBAT>();
 }
 
 /*!
@@ -1743,12 +2396,7 @@ bool Adafruit_BQ25798::getBatDischargeSenseEnable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBatDischargeSenseEnable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_ibat_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 5);
-  
-  en_ibat_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_IBAT>(enable);
 }
 
 /*!
@@ -1756,10 +2404,7 @@ bool Adafruit_BQ25798::setBatDischargeSenseEnable(bool enable) {
  * @return Current regulation setting
  */
 bq25798_ibat_reg_t Adafruit_BQ25798::getBatDischargeA() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits ibat_reg_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 2, 3);
-  
-  return (bq25798_ibat_reg_t)ibat_reg_bits.read();
+  return (bq25798_ibat_reg_t)readField<BQ25798_FIELD_IBAT_REG>();
 }
 
 /*!
@@ -1768,12 +2413,7 @@ bq25798_ibat_reg_t Adafruit_BQ25798::getBatDischargeA() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBatDischargeA(bq25798_ibat_reg_t current) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits ibat_reg_bits = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 2, 3);
-  
-  ibat_reg_bits.write((uint8_t)current);
-  
-  return true;
+  return writeField<BQ25798_FIELD_IBAT_REG>(current);
 }
 
 /*!
@@ -1781,10 +2421,7 @@ bool Adafruit_BQ25798::setBatDischargeA(bq25798_ibat_reg_t current) {
  * @return True if IINDPM is enabled
  */
 bool Adafruit_BQ25798::getIINDPMenable() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_iindpm_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 2);
-  
-  return en_iindpm_bit.read();
+  return readField<BQ25798_FIELD_EN_IINDPM>();
 }
 
 /*!
@@ -1793,12 +2430,7 @@ bool Adafruit_BQ25798::getIINDPMenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setIINDPMenable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_iindpm_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 2);
-  
-  en_iindpm_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_IINDPM>(enable);
 }
 
 /*!
@@ -1806,10 +2438,7 @@ bool Adafruit_BQ25798::setIINDPMenable(bool enable) {
  * @return True if external ILIM pin is enabled
  */
 bool Adafruit_BQ25798::getExtILIMpin() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_extilim_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 1);
-  
-  return en_extilim_bit.read();
+  return readField<BQ25798_FIELD_EN_EXTILIM>();
 }
 
 /*!
@@ -1818,12 +2447,7 @@ bool Adafruit_BQ25798::getExtILIMpin() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setExtILIMpin(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_extilim_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 1);
-  
-  en_extilim_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_EXTILIM>(enable);
 }
 
 /*!
@@ -1831,10 +2455,7 @@ bool Adafruit_BQ25798::setExtILIMpin(bool enable) {
  * @return True if battery discharge OCP is enabled
  */
 bool Adafruit_BQ25798::getBatDischargeOCPenable() {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_batoc_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 0);
-  
-  return en_batoc_bit.read();
+  return readField<BQ25798_FIELD_EN_BATOC>();
 }
 
 /*!
@@ -1843,12 +2464,7 @@ bool Adafruit_BQ25798::getBatDischargeOCPenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBatDischargeOCPenable(bool enable) {
-  Adafruit_BusIO_Register chg_ctrl5_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_CHARGER_CONTROL_5);
-  Adafruit_BusIO_RegisterBits en_batoc_bit = Adafruit_BusIO_RegisterBits(&chg_ctrl5_reg, 1, 0);
-  
-  en_batoc_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_BATOC>(enable);
 }
 
 /*!
@@ -1856,10 +2472,7 @@ bool Adafruit_BQ25798::setBatDischargeOCPenable(bool enable) {
  * @return VOC percentage setting
  */
 bq25798_voc_pct_t Adafruit_BQ25798::getVINDPM_VOCpercent() {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_pct_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 3, 5);
-  
-  return (bq25798_voc_pct_t)voc_pct_bits.read();
+  return (bq25798_voc_pct_t)readField<BQ25798_FIELD_VOC_PCT>();
 }
 
 /*!
@@ -1868,12 +2481,7 @@ bq25798_voc_pct_t Adafruit_BQ25798::getVINDPM_VOCpercent() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVINDPM_VOCpercent(bq25798_voc_pct_t percentage) {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_pct_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 3, 5);
-  
-  voc_pct_bits.write((uint8_t)percentage);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VOC_PCT>(percentage);
 }
 
 /*!
@@ -1881,10 +2489,7 @@ bool Adafruit_BQ25798::setVINDPM_VOCpercent(bq25798_voc_pct_t percentage) {
  * @return VOC delay setting
  */
 bq25798_voc_dly_t Adafruit_BQ25798::getVOCdelay() {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_dly_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 2, 3);
-  
-  return (bq25798_voc_dly_t)voc_dly_bits.read();
+  return (bq25798_voc_dly_t)readField<BQ25798_FIELD_VOC_DLY>();
 }
 
 /*!
@@ -1893,12 +2498,7 @@ bq25798_voc_dly_t Adafruit_BQ25798::getVOCdelay() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVOCdelay(bq25798_voc_dly_t delay) {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_dly_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 2, 3);
-  
-  voc_dly_bits.write((uint8_t)delay);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VOC_DLY>(delay);
 }
 
 /*!
@@ -1906,10 +2506,7 @@ bool Adafruit_BQ25798::setVOCdelay(bq25798_voc_dly_t delay) {
  * @return VOC rate setting
  */
 bq25798_voc_rate_t Adafruit_BQ25798::getVOCrate() {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_rate_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 2, 1);
-  
-  return (bq25798_voc_rate_t)voc_rate_bits.read();
+  return (bq25798_voc_rate_t)readField<BQ25798_FIELD_VOC_RATE>();
 }
 
 /*!
@@ -1918,12 +2515,7 @@ bq25798_voc_rate_t Adafruit_BQ25798::getVOCrate() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVOCrate(bq25798_voc_rate_t rate) {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits voc_rate_bits = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 2, 1);
-  
-  voc_rate_bits.write((uint8_t)rate);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VOC_RATE>(rate);
 }
 
 /*!
@@ -1931,10 +2523,7 @@ bool Adafruit_BQ25798::setVOCrate(bq25798_voc_rate_t rate) {
  * @return True if MPPT is enabled
  */
 bool Adafruit_BQ25798::getMPPTenable() {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits en_mppt_bit = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 1, 0);
-  
-  return en_mppt_bit.read();
+  return readField<BQ25798_FIELD_EN_MPPT>();
 }
 
 /*!
@@ -1943,12 +2532,7 @@ bool Adafruit_BQ25798::getMPPTenable() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setMPPTenable(bool enable) {
-  Adafruit_BusIO_Register mppt_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_MPPT_CONTROL);
-  Adafruit_BusIO_RegisterBits en_mppt_bit = Adafruit_BusIO_RegisterBits(&mppt_ctrl_reg, 1, 0);
-  
-  en_mppt_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_EN_MPPT>(enable);
 }
 
 /*!
@@ -1956,10 +2540,7 @@ bool Adafruit_BQ25798::setMPPTenable(bool enable) {
  * @return Thermal regulation threshold setting
  */
 bq25798_treg_t Adafruit_BQ25798::getThermRegulationThresh() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits treg_bits = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 2, 6);
-  
-  return (bq25798_treg_t)treg_bits.read();
+  return (bq25798_treg_t)readField<BQ25798_FIELD_TREG>();
 }
 
 /*!
@@ -1968,12 +2549,7 @@ bq25798_treg_t Adafruit_BQ25798::getThermRegulationThresh() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setThermRegulationThresh(bq25798_treg_t threshold) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits treg_bits = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 2, 6);
-  
-  treg_bits.write((uint8_t)threshold);
-  
-  return true;
+  return writeField<BQ25798_FIELD_TREG>(threshold);
 }
 
 /*!
@@ -1981,10 +2557,7 @@ bool Adafruit_BQ25798::setThermRegulationThresh(bq25798_treg_t threshold) {
  * @return Thermal shutdown threshold setting
  */
 bq25798_tshut_t Adafruit_BQ25798::getThermShutdownThresh() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits tshut_bits = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 2, 4);
-  
-  return (bq25798_tshut_t)tshut_bits.read();
+  return (bq25798_tshut_t)readField<BQ25798_FIELD_TSHUT>();
 }
 
 /*!
@@ -1993,12 +2566,7 @@ bq25798_tshut_t Adafruit_BQ25798::getThermShutdownThresh() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setThermShutdownThresh(bq25798_tshut_t threshold) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits tshut_bits = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 2, 4);
-  
-  tshut_bits.write((uint8_t)threshold);
-  
-  return true;
+  return writeField<BQ25798_FIELD_TSHUT>(threshold);
 }
 
 /*!
@@ -2006,10 +2574,7 @@ bool Adafruit_BQ25798::setThermShutdownThresh(bq25798_tshut_t threshold) {
  * @return True if VBUS pulldown is enabled
  */
 bool Adafruit_BQ25798::getVBUSpulldown() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vbus_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 3);
-  
-  return vbus_pd_bit.read();
+  return readField<BQ25798_FIELD_VBUS_PD_EN>();
 }
 
 /*!
@@ -2018,12 +2583,7 @@ bool Adafruit_BQ25798::getVBUSpulldown() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVBUSpulldown(bool enable) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vbus_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 3);
-  
-  vbus_pd_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VBUS_PD_EN>(enable);
 }
 
 /*!
@@ -2031,10 +2591,7 @@ bool Adafruit_BQ25798::setVBUSpulldown(bool enable) {
  * @return True if VAC1 pulldown is enabled
  */
 bool Adafruit_BQ25798::getVAC1pulldown() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vac1_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 2);
-  
-  return vac1_pd_bit.read();
+  return readField<BQ25798_FIELD_VAC1_PD_EN>();
 }
 
 /*!
@@ -2043,12 +2600,7 @@ bool Adafruit_BQ25798::getVAC1pulldown() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVAC1pulldown(bool enable) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vac1_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 2);
-  
-  vac1_pd_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VAC1_PD_EN>(enable);
 }
 
 /*!
@@ -2056,10 +2608,7 @@ bool Adafruit_BQ25798::setVAC1pulldown(bool enable) {
  * @return True if VAC2 pulldown is enabled
  */
 bool Adafruit_BQ25798::getVAC2pulldown() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vac2_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 1);
-  
-  return vac2_pd_bit.read();
+  return readField<BQ25798_FIELD_VAC2_PD_EN>();
 }
 
 /*!
@@ -2068,12 +2617,7 @@ bool Adafruit_BQ25798::getVAC2pulldown() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setVAC2pulldown(bool enable) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits vac2_pd_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 1);
-  
-  vac2_pd_bit.write(enable);
-  
-  return true;
+  return writeField<BQ25798_FIELD_VAC2_PD_EN>(enable);
 }
 
 /*!
@@ -2081,10 +2625,7 @@ bool Adafruit_BQ25798::setVAC2pulldown(bool enable) {
  * @return True if backup ACFET1 is on
  */
 bool Adafruit_BQ25798::getBackupACFET1on() {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits bkup_acfet1_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 0);
-  
-  return bkup_acfet1_bit.read();
+  return readField<BQ25798_FIELD_BKUP_ACFET1_ON>();
 }
 
 /*!
@@ -2093,23 +2634,877 @@ bool Adafruit_BQ25798::getBackupACFET1on() {
  * @return True if successful
  */
 bool Adafruit_BQ25798::setBackupACFET1on(bool enable) {
-  Adafruit_BusIO_Register temp_ctrl_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TEMPERATURE_CONTROL);
-  Adafruit_BusIO_RegisterBits bkup_acfet1_bit = Adafruit_BusIO_RegisterBits(&temp_ctrl_reg, 1, 0);
-  
-  bkup_acfet1_bit.write(enable);
-  
+  return writeField<BQ25798_FIELD_BKUP_ACFET1_ON>(enable);
+}
+
+#ifndef BQ25798_NO_FLOAT
+/*!
+ * @brief Read every ADC channel (0x31-0x46) in a single 22-byte burst so all
+ *        values come from the same conversion cycle. The ADC must already be
+ *        enabled for the registers to hold fresh data.
+ * @param adc Struct to fill with the decoded readings
+ * @return True if successful, false if the burst read failed
+ */
+bool Adafruit_BQ25798::readAllADC(bq25798_adc_t &adc) {
+  bq25798_adc_fixed_t fixed;
+
+  if (!readADCChannels(BQ25798_ADC_CH_ALL, fixed)) {
+    return false;
+  }
+
+  adc.ibus = fixed.ibus * 0.001f;
+  adc.ibat = fixed.ibat * 0.001f;
+  adc.vbus = fixed.vbus * 0.001f;
+  adc.vac1 = fixed.vac1 * 0.001f;
+  adc.vac2 = fixed.vac2 * 0.001f;
+  adc.vbat = fixed.vbat * 0.001f;
+  adc.vsys = fixed.vsys * 0.001f;
+  adc.ts = fixed.ts * 0.01f;
+  adc.tdie = fixed.tdie * 0.1f;
+  adc.dplus = fixed.dplus * 0.001f;
+  adc.dminus = fixed.dminus * 0.001f;
+
+  return true;
+}
+#endif
+
+/*!
+ * @brief Decode ADC result registers (0x31-0x46) to integer units
+ * @param buffer Raw IBUS_ADC through DMINUS_ADC, may alias adc
+ * @param channels BQ25798_ADC_CH_* mask, unselected channels read as 0
+ * @param adc Struct to fill with the decoded readings
+ */
+static void decodeADC(const uint8_t *buffer, uint16_t channels,
+                      bq25798_adc_fixed_t &adc) {
+  // Every channel is a 16-bit MSB-first word; IBUS, IBAT and TDIE are
+  // two's complement. Channels inside the span but not selected may hold a
+  // stale conversion, so they are dropped here. Everything is read out
+  // before adc is written, so buffer may point into it.
+  uint16_t raw[(BQ25798_REG_DPDM_DRIVER - BQ25798_REG_IBUS_ADC) / 2];
+  for (uint8_t i = 0; i < sizeof(raw) / sizeof(raw[0]); i++) {
+    raw[i] = (channels & (1 << i))
+                 ? ((uint16_t)buffer[i * 2] << 8) | buffer[i * 2 + 1]
+                 : 0;
+  }
+
+  adc.ibus = (int16_t)raw[0];                  // 1mA per LSB
+  adc.ibat = (int16_t)raw[1];                  // 1mA per LSB
+  adc.vbus = raw[2];                           // 1mV per LSB
+  adc.vac1 = raw[3];                           // 1mV per LSB
+  adc.vac2 = raw[4];                           // 1mV per LSB
+  adc.vbat = raw[5];                           // 1mV per LSB
+  adc.vsys = raw[6];                           // 1mV per LSB
+  adc.ts = ((uint32_t)raw[7] * 625 + 32) / 64; // 100/1024% of REGN per LSB
+  adc.tdie = (int16_t)raw[8] * 5;              // 0.5C per LSB
+  adc.dplus = raw[9];                          // 1mV per LSB
+  adc.dminus = raw[10];                        // 1mV per LSB
+}
+
+/*!
+ * @brief Read every ADC channel (0x31-0x46) in a single 22-byte burst,
+ *        decoded to integer millivolts and milliamps
+ * @param adc Struct to fill with the decoded readings
+ * @return True if successful, false if the burst read failed
+ */
+bool Adafruit_BQ25798::readAllADC(bq25798_adc_fixed_t &adc) {
+  return readADCChannels(BQ25798_ADC_CH_ALL, adc);
+}
+
+/*!
+ * @brief Burst read the span of ADC result registers covering a channel set
+ *        and decode it
+ * @param channels BQ25798_ADC_CH_* mask, unselected channels read as 0
+ * @param adc Struct to fill with the decoded readings
+ * @return True if successful, false if the burst read failed
+ */
+bool Adafruit_BQ25798::readADCChannels(uint16_t channels,
+                                       bq25798_adc_fixed_t &adc) {
+  uint8_t buffer[BQ25798_REG_DPDM_DRIVER - BQ25798_REG_IBUS_ADC];
+  uint8_t first = 0;
+  uint8_t last = sizeof(buffer) / 2 - 1;
+
+  channels &= BQ25798_ADC_CH_ALL;
+  memset(buffer, 0, sizeof(buffer));
+
+  if (channels) {
+    while (!(channels & (1 << first))) {
+      first++;
+    }
+    while (!(channels & (1 << last))) {
+      last--;
+    }
+    if (!readRegisters(BQ25798_REG_IBUS_ADC + first * 2, buffer + first * 2,
+                       (last - first + 1) * 2)) {
+      return false;
+    }
+  }
+
+  decodeADC(buffer, channels, adc);
+  return true;
+}
+
+/*!
+ * @brief Enable the ADC and set its mode, resolution, averaging and channel
+ *        set in one go
+ * @param continuous True to convert continuously, false for a single
+ *        conversion (poll() re-arms it after each sample)
+ * @param resolution Sample resolution, lower is faster
+ * @param averaging True to report a running average instead of single
+ *        conversions. The average restarts from a fresh conversion.
+ * @param channels BQ25798_ADC_CH_* mask of channels to convert, the rest are
+ *        disabled to shorten the conversion cycle
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::configureADC(bool continuous,
+                                    bq25798_adc_resolution_t resolution,
+                                    bool averaging, uint16_t channels) {
+  uint8_t disable[2] = {0, 0};
+
+  // ADC_FUNCTION_DISABLE_0: IBUS, IBAT, VBUS, VBAT, VSYS, TS, TDIE in bits 7:1
+  static const uint16_t dis0[] = {BQ25798_ADC_CH_IBUS, BQ25798_ADC_CH_IBAT,
+                                  BQ25798_ADC_CH_VBUS, BQ25798_ADC_CH_VBAT,
+                                  BQ25798_ADC_CH_VSYS, BQ25798_ADC_CH_TS,
+                                  BQ25798_ADC_CH_TDIE};
+  // ADC_FUNCTION_DISABLE_1: D+, D-, VAC2, VAC1 in bits 7:4
+  static const uint16_t dis1[] = {BQ25798_ADC_CH_DPLUS, BQ25798_ADC_CH_DMINUS,
+                                  BQ25798_ADC_CH_VAC2, BQ25798_ADC_CH_VAC1};
+
+  for (uint8_t i = 0; i < sizeof(dis0) / sizeof(dis0[0]); i++) {
+    if (!(channels & dis0[i])) {
+      disable[0] |= 0x80 >> i;
+    }
+  }
+  for (uint8_t i = 0; i < sizeof(dis1) / sizeof(dis1[0]); i++) {
+    if (!(channels & dis1[i])) {
+      disable[1] |= 0x80 >> i;
+    }
+  }
+
+  // Channels first, so a one-shot conversion started by ADC_EN already uses
+  // the new set
+  if (!writeRegisters(BQ25798_REG_ADC_FUNCTION_DISABLE_0, disable, 2)) {
+    return false;
+  }
+
+  uint8_t control = 0x80 | ((resolution & 0x03) << 4); // ADC_EN, ADC_SAMPLE
+  if (!continuous) {
+    control |= 0x40; // ADC_RATE one-shot
+  }
+  if (averaging) {
+    control |= 0x0C; // ADC_AVG, ADC_AVG_INIT
+  }
+  if (!writeRegisters(BQ25798_REG_ADC_CONTROL, &control, 1)) {
+    return false;
+  }
+
+  adc_channels = channels & BQ25798_ADC_CH_ALL;
+  adc_oneshot = !continuous;
+  return true;
+}
+
+/*!
+ * @brief Stop the ADC. Leaves the mode, resolution and channel settings
+ *        alone.
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::disableADC() {
+  return writeField<BQ25798_FIELD_ADC_EN>(0);
+}
+
+/*!
+ * @brief Get the ADC enable state. In one-shot mode this reads false once
+ *        the conversion has finished.
+ * @return True if the ADC is enabled or converting
+ */
+bool Adafruit_BQ25798::getADCEnable() {
+  return readField<BQ25798_FIELD_ADC_EN>();
+}
+
+/*!
+ * @brief Set the ring buffer that poll() pushes ADC samples into
+ * @param ring Destination ring, or NULL to stop streaming. poll() is the
+ *        only producer; drain it from exactly one other context.
+ */
+void Adafruit_BQ25798::setADCStream(Adafruit_BQ25798_ADCRing *ring) {
+  adc_ring = ring;
+}
+
+/*!
+ * @brief Take one ADC sample for the stream set with setADCStream(). Only
+ *        the channels enabled by configureADC() are read, in one burst.
+ *
+ *        In continuous mode every call samples, so call it at the rate you
+ *        want to log at (no faster than the conversion cycle). In one-shot
+ *        mode a call only samples once the pending conversion has finished,
+ *        then starts the next one.
+ * @return True if a sample was pushed, false if none was ready, the bus
+ *         failed or the ring was full
+ */
+bool Adafruit_BQ25798::poll() {
+  if (!adc_ring) {
+    return false;
+  }
+
+  // ADC_EN self-clears when a one-shot conversion is done
+  uint8_t control = 0;
+  if (adc_oneshot) {
+    if (!readRegisters(BQ25798_REG_ADC_CONTROL, &control, 1) ||
+        (control & 0x80)) {
+      return false;
+    }
+  }
+
+  bq25798_adc_sample_t sample;
+  sample.timestamp_us = micros();
+  sample.channels = adc_channels;
+  if (!readADCChannels(adc_channels, sample.adc)) {
+    return false;
+  }
+
+  if (adc_oneshot) {
+    // Re-arm from the control byte read above rather than re-reading it
+    control |= 0x80;
+    writeRegisters(BQ25798_REG_ADC_CONTROL, &control, 1);
+  }
+
+  return adc_ring->push(sample);
+}
+
+/*!
+ * @brief Decode the seven status registers (0x1B-0x21)
+ * @param regs Raw CHARGER_STATUS_0 through FAULT_STATUS_1
+ * @param status Struct to fill
+ */
+static void decodeStatus(const uint8_t *regs, bq25798_status_t &status) {
+  status.iindpm = regs[0] & 0x80;
+  status.vindpm = regs[0] & 0x40;
+  status.wd_expired = regs[0] & 0x20;
+  status.power_good = regs[0] & 0x08;
+  status.ac2_present = regs[0] & 0x04;
+  status.ac1_present = regs[0] & 0x02;
+  status.vbus_present = regs[0] & 0x01;
+
+  status.chg_stat = (bq25798_chg_stat_t)(regs[1] >> 5);
+  status.vbus_stat = (bq25798_vbus_stat_t)((regs[1] >> 1) & 0x0F);
+  status.bc12_done = regs[1] & 0x01;
+
+  status.ico_stat = (bq25798_ico_stat_t)(regs[2] >> 6);
+  status.treg = regs[2] & 0x04;
+  status.dpdm_ongoing = regs[2] & 0x02;
+  status.vbat_present = regs[2] & 0x01;
+
+  status.acrb2 = regs[3] & 0x80;
+  status.acrb1 = regs[3] & 0x40;
+  status.adc_done = regs[3] & 0x20;
+  status.vsys_reg = regs[3] & 0x10;
+  status.chg_tmr = regs[3] & 0x08;
+  status.trichg_tmr = regs[3] & 0x04;
+  status.prechg_tmr = regs[3] & 0x02;
+
+  status.vbatotg_low = regs[4] & 0x10;
+  status.ts_cold = regs[4] & 0x08;
+  status.ts_cool = regs[4] & 0x04;
+  status.ts_warm = regs[4] & 0x02;
+  status.ts_hot = regs[4] & 0x01;
+
+  status.ibat_reg = regs[5] & 0x80;
+  status.vbus_ovp = regs[5] & 0x40;
+  status.vbat_ovp = regs[5] & 0x20;
+  status.ibus_ocp = regs[5] & 0x10;
+  status.ibat_ocp = regs[5] & 0x08;
+  status.conv_ocp = regs[5] & 0x04;
+  status.vac2_ovp = regs[5] & 0x02;
+  status.vac1_ovp = regs[5] & 0x01;
+
+  status.vsys_short = regs[6] & 0x80;
+  status.vsys_ovp = regs[6] & 0x40;
+  status.otg_ovp = regs[6] & 0x20;
+  status.otg_uvp = regs[6] & 0x10;
+  status.tshut = regs[6] & 0x04;
+}
+
+/*!
+ * @brief Read CHARGER_STATUS_0..4 and FAULT_STATUS_0/1 in a single 7-byte
+ *        burst and decode them
+ * @param status Struct to fill with the decoded chip state
+ * @return True if successful, false if the burst read failed
+ */
+bool Adafruit_BQ25798::getStatus(bq25798_status_t &status) {
+  uint8_t buffer[BQ25798_REG_FAULT_STATUS_1 - BQ25798_REG_CHARGER_STATUS_0 + 1];
+
+  if (!readRegisters(BQ25798_REG_CHARGER_STATUS_0, buffer, sizeof(buffer))) {
+    return false;
+  }
+
+  decodeStatus(buffer, status);
+  return true;
+}
+
+// Queued operation types, see bq25798_async_op_t
+#define BQ25798_ASYNC_READ 0        ///< Raw register read
+#define BQ25798_ASYNC_WRITE 1       ///< Raw register write
+#define BQ25798_ASYNC_FIELD_READ 2  ///< getFieldAsync()
+#define BQ25798_ASYNC_FIELD_WRITE 3 ///< setFieldAsync(), read-modify-write
+#define BQ25798_ASYNC_STATUS 4      ///< getStatusAsync()
+#define BQ25798_ASYNC_ADC 5         ///< readAllADCAsync()
+
+// The status and ADC bursts land in the caller's result struct and are
+// decoded in place, so the queue needs no buffer of its own
+static_assert(sizeof(bq25798_status_t) >=
+                  BQ25798_REG_FAULT_STATUS_1 - BQ25798_REG_CHARGER_STATUS_0 + 1,
+              "bq25798_status_t too small to hold the raw status burst");
+static_assert(sizeof(bq25798_adc_fixed_t) >=
+                  BQ25798_REG_DPDM_DRIVER - BQ25798_REG_IBUS_ADC,
+              "bq25798_adc_fixed_t too small to hold the raw ADC burst");
+
+/*!
+ * @brief Give the driver storage for queued asynchronous operations.
+ *        Anything still queued is dropped without its callback, so only
+ *        swap queues while asyncPending() is 0.
+ * @param ops Array of slots, must outlive the driver, or NULL
+ * @param capacity Number of slots in ops
+ */
+void Adafruit_BQ25798::setAsyncQueue(bq25798_async_op_t *ops,
+                                     uint8_t capacity) {
+  async_ops = ops;
+  async_capacity = ops ? capacity : 0;
+  async_head = 0;
+  async_count = 0;
+  async_busy = false;
+  async_timed_out = false;
+  async_write = false;
+  async_start_us = 0;
+}
+
+/*!
+ * @brief Queue a raw burst read. buffer is filled by the time the callback
+ *        runs.
+ * @param reg First register address
+ * @param buffer Destination, must stay valid until the callback
+ * @param len Number of registers to read
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the queue is full or missing
+ */
+bool Adafruit_BQ25798::readAsync(uint8_t reg, uint8_t *buffer, uint8_t len,
+                                 bq25798_async_callback_t callback,
+                                 void *context) {
+  return asyncPush(BQ25798_ASYNC_READ, reg, len, buffer, callback, context);
+}
+
+/*!
+ * @brief Queue a raw burst write
+ * @param reg First register address
+ * @param buffer Register contents, must stay valid until the callback
+ * @param len Number of registers to write
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the queue is full or missing
+ */
+bool Adafruit_BQ25798::writeAsync(uint8_t reg, const uint8_t *buffer,
+                                  uint8_t len,
+                                  bq25798_async_callback_t callback,
+                                  void *context) {
+  return asyncPush(BQ25798_ASYNC_WRITE, reg, len, (void *)buffer, callback,
+                   context);
+}
+
+/*!
+ * @brief Queue a field read. Served from the shadow cache without bus
+ *        traffic when getField() would be.
+ * @param field Field to read
+ * @param value Receives the value in the field's units
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the ID is unknown or the queue is full
+ */
+bool Adafruit_BQ25798::getFieldAsync(bq25798_field_t field, int32_t *value,
+                                     bq25798_async_callback_t callback,
+                                     void *context) {
+  bq25798_field_desc_t desc;
+
+  if (!getFieldInfo(field, desc) ||
+      !asyncPush(BQ25798_ASYNC_FIELD_READ, desc.reg, desc.width, value,
+                 callback, context)) {
+    return false;
+  }
+  async_ops[(async_head + async_count - 1) % async_capacity].field = field;
+  return true;
+}
+
+/*!
+ * @brief Queue a field write. The value is checked now; the register is
+ *        read-modify-written later, skipping the read when cached.
+ * @param field Field to write
+ * @param value New setting in the field's units
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the ID is unknown, the field read-only,
+ *         the value out of range or the queue full
+ */
+bool Adafruit_BQ25798::setFieldAsync(bq25798_field_t field, int32_t value,
+                                     bq25798_async_callback_t callback,
+                                     void *context) {
+  bq25798_field_desc_t desc;
+  uint16_t raw;
+
+  if (!getFieldInfo(field, desc) || !fieldEncode(desc, value, raw)) {
+    last_error = BQ25798_ERR_INVALID;
+    return false;
+  }
+  if (!asyncPush(BQ25798_ASYNC_FIELD_WRITE, desc.reg, desc.width, NULL,
+                 callback, context)) {
+    return false;
+  }
+  bq25798_async_op_t &op =
+      async_ops[(async_head + async_count - 1) % async_capacity];
+  op.field = field;
+  op.value = raw;
+  return true;
+}
+
+/*!
+ * @brief Queue a getStatus() burst
+ * @param status Filled by the time the callback runs
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the queue is full or missing
+ */
+bool Adafruit_BQ25798::getStatusAsync(bq25798_status_t *status,
+                                      bq25798_async_callback_t callback,
+                                      void *context) {
+  return asyncPush(BQ25798_ASYNC_STATUS, BQ25798_REG_CHARGER_STATUS_0,
+                   BQ25798_REG_FAULT_STATUS_1 - BQ25798_REG_CHARGER_STATUS_0 +
+                       1,
+                   status, callback, context);
+}
+
+/*!
+ * @brief Queue a readAllADC() burst
+ * @param adc Filled by the time the callback runs
+ * @param callback Called from tick() when done, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the queue is full or missing
+ */
+bool Adafruit_BQ25798::readAllADCAsync(bq25798_adc_fixed_t *adc,
+                                       bq25798_async_callback_t callback,
+                                       void *context) {
+  return asyncPush(BQ25798_ASYNC_ADC, BQ25798_REG_IBUS_ADC,
+                   BQ25798_REG_DPDM_DRIVER - BQ25798_REG_IBUS_ADC, adc,
+                   callback, context);
+}
+
+/*!
+ * @brief Advance the async queue. Each call starts at most one bus
+ *        transfer and, once the transport reports it finished, completes
+ *        the operation and runs its callback. Call it from the main loop or
+ *        scheduler. With a blocking transport (the default startRead() and
+ *        startWrite()) every call still holds the CPU for one transfer;
+ *        with a DMA, interrupt or thread driven one such as
+ *        Adafruit_BQ25798_LinuxI2C it only polls. A transfer still in
+ *        flight after BQ25798_XFER_TIMEOUT_US sets BQ25798_ERR_TIMEOUT and
+ *        its operation fails, but only once the transport has let go of
+ *        the operation's buffer by finishing the transfer.
+ * @return True while operations are still queued
+ */
+bool Adafruit_BQ25798::tick() {
+  if (!async_busy) {
+    // Cache-served operations finish here without a transfer
+    while (async_count && !asyncStart()) {
+    }
+    if (!async_busy) {
+      return async_count;
+    }
+  }
+
+  bq25798_xfer_status_t status = transport->transferStatus();
+  if (status == BQ25798_XFER_BUSY) {
+    if (!async_timed_out &&
+        (uint32_t)(micros() - async_start_us) > BQ25798_XFER_TIMEOUT_US) {
+      // The transport may still write into the op's buffer, so the op
+      // stays queued until it finishes, then fails without a retry
+      async_timed_out = true;
+      last_error = BQ25798_ERR_TIMEOUT;
+    }
+    return true;
+  }
+  async_busy = false;
+
+  bq25798_async_op_t &op = async_ops[async_head];
+  if (async_timed_out) {
+    async_timed_out = false;
+    last_error = BQ25798_ERR_TIMEOUT;
+    asyncFinish(false);
+    return async_count;
+  }
+
+  bool ok = status == BQ25798_XFER_DONE;
+  bool field = op.kind == BQ25798_ASYNC_FIELD_READ ||
+               op.kind == BQ25798_ASYNC_FIELD_WRITE;
+  uint8_t *buffer = field ? op.raw : (uint8_t *)op.data;
+#ifdef BQ25798_BUS_STATS
+  recordTransaction(async_write, op.reg, op.len, ok, async_start_us);
+#endif
+  if (ok) {
+    syncShadow(async_write, op.reg, buffer, op.len);
+  }
+  last_error = ok ? BQ25798_OK : BQ25798_ERR_BUS;
+
+  if (!ok && ++op.tries < retry_attempts) {
+    // Start the same transfer again on the next tick
+    if (retry_recover && transport->recoverBus()) {
+#ifdef BQ25798_BUS_STATS
+      bus_stats.recoveries++;
+#endif
+    }
+#ifdef BQ25798_BUS_STATS
+    bus_stats.retries++;
+#endif
+    return true;
+  }
+  op.tries = 0;
+
+  if (ok && op.kind == BQ25798_ASYNC_FIELD_WRITE && !async_write) {
+    op.phase = 1; // read half done, write on the next tick
+  } else {
+    asyncFinish(ok);
+  }
+  return async_count;
+}
+
+/*!
+ * @brief Number of operations queued or in flight
+ * @return Queue depth
+ */
+uint8_t Adafruit_BQ25798::asyncPending() {
+  return async_count;
+}
+
+/*!
+ * @brief Append an operation to the async queue
+ * @param kind BQ25798_ASYNC_* type
+ * @param reg First register
+ * @param len Register count
+ * @param data Caller buffer or result struct
+ * @param callback Completion callback, may be NULL
+ * @param context Passed back to callback
+ * @return True if queued, false if the queue is full or missing
+ */
+bool Adafruit_BQ25798::asyncPush(uint8_t kind, uint8_t reg, uint8_t len,
+                                 void *data,
+                                 bq25798_async_callback_t callback,
+                                 void *context) {
+  if (async_count >= async_capacity || !len) {
+    return false;
+  }
+
+  bq25798_async_op_t &op =
+      async_ops[(async_head + async_count) % async_capacity];
+  op.kind = kind;
+  op.reg = reg;
+  op.len = len;
+  op.field = 0;
+  op.phase = 0;
+  op.tries = 0;
+  op.value = 0;
+  op.data = data;
+  op.callback = callback;
+  op.context = context;
+  async_count++;
+  return true;
+}
+
+/*!
+ * @brief Start the next transfer of the oldest queued operation, or finish
+ *        it if the shadow cache already covers it or the bus refused
+ * @return True if a transfer is now in flight
+ */
+bool Adafruit_BQ25798::asyncStart() {
+  bq25798_async_op_t &op = async_ops[async_head];
+  uint8_t *buffer = (uint8_t *)op.data;
+  bool write = op.kind == BQ25798_ASYNC_WRITE;
+
+  if (op.kind == BQ25798_ASYNC_FIELD_READ ||
+      op.kind == BQ25798_ASYNC_FIELD_WRITE) {
+    bq25798_field_desc_t desc;
+    getFieldInfo((bq25798_field_t)op.field, desc);
+    uint16_t mask = (uint16_t)(((1UL << desc.bits) - 1) << desc.shift);
+    buffer = op.raw;
+
+    // Same cache rules as readBits() and writeBits()
+    uint8_t uncached = cacheLiveMask(op.reg);
+    if (op.kind == BQ25798_ASYNC_FIELD_READ) {
+      uncached |= cacheVolatileMask(op.reg);
+    }
+    if (op.phase == 0 && !(op.len == 1 && (uncached & mask)) &&
+        cacheHit(op.reg, op.len)) {
+      for (uint8_t i = 0; i < op.len; i++) {
+        op.raw[i] = shadow_regs[cacheIndex(op.reg + i)];
+      }
+      if (op.kind == BQ25798_ASYNC_FIELD_READ) {
+        last_error = BQ25798_OK;
+        asyncFinish(true);
+        return false;
+      }
+      op.phase = 1;
+    }
+
+    if (op.phase == 1) {
+      uint16_t reg_value = (op.len == 2)
+                               ? ((uint16_t)op.raw[0] << 8) | op.raw[1]
+                               : op.raw[0];
+      reg_value = (reg_value & ~mask) | ((op.value << desc.shift) & mask);
+      if (op.len == 2) {
+        op.raw[0] = reg_value >> 8;
+        op.raw[1] = reg_value & 0xFF;
+      } else {
+        op.raw[0] = reg_value & 0xFF;
+      }
+      write = true;
+    }
+  }
+
+  if (!transport) {
+    last_error = BQ25798_ERR_NO_DEVICE;
+    asyncFinish(false);
+    return false;
+  }
+
+  async_start_us = micros();
+  async_write = write;
+  async_busy = write ? transport->startWrite(op.reg, buffer, op.len)
+                     : transport->startRead(op.reg, buffer, op.len);
+  if (!async_busy) {
+    last_error = BQ25798_ERR_BUS;
+    asyncFinish(false);
+  }
+  return async_busy;
+}
+
+/*!
+ * @brief Decode the oldest operation's result, drop it from the queue and
+ *        run its callback
+ * @param ok Whether every transfer of the operation succeeded
+ */
+void Adafruit_BQ25798::asyncFinish(bool ok) {
+  bq25798_async_op_t &op = async_ops[async_head];
+
+  if (ok && op.kind == BQ25798_ASYNC_FIELD_READ) {
+    bq25798_field_desc_t desc;
+    getFieldInfo((bq25798_field_t)op.field, desc);
+    uint16_t value =
+        (op.len == 2) ? ((uint16_t)op.raw[0] << 8) | op.raw[1] : op.raw[0];
+    uint16_t mask = (uint16_t)(((1UL << desc.bits) - 1) << desc.shift);
+    *(int32_t *)op.data = fieldDecode(desc, (value & mask) >> desc.shift);
+  } else if (ok && op.kind == BQ25798_ASYNC_STATUS) {
+    uint8_t raw[BQ25798_REG_FAULT_STATUS_1 - BQ25798_REG_CHARGER_STATUS_0 + 1];
+    memcpy(raw, op.data, sizeof(raw));
+    decodeStatus(raw, *(bq25798_status_t *)op.data);
+  } else if (ok && op.kind == BQ25798_ASYNC_ADC) {
+    decodeADC((const uint8_t *)op.data, BQ25798_ADC_CH_ALL,
+              *(bq25798_adc_fixed_t *)op.data);
+  }
+
+  // Pop first so the callback may queue follow-up work
+  bq25798_async_callback_t callback = op.callback;
+  void *context = op.context;
+  async_head = (async_head + 1) % async_capacity;
+  async_count--;
+
+  if (callback) {
+    callback(ok, context);
+  }
+}
+
+/*!
+ * @brief Program CHARGER_MASK_0..3 and FAULT_MASK_0/1 in one burst
+ * @param mask Bitset of BQ25798_FLAG_* events that should NOT pulse INT
+ * @return True if successful
+ */
+bool Adafruit_BQ25798::setInterruptMask(uint64_t mask) {
+  uint8_t buffer[BQ25798_REG_FAULT_MASK_1 - BQ25798_REG_CHARGER_MASK_0 + 1];
+
+  for (uint8_t i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = (mask >> (i * 8)) & 0xFF;
+  }
+
+  return writeRegisters(BQ25798_REG_CHARGER_MASK_0, buffer, sizeof(buffer));
+}
+
+/*!
+ * @brief Get the current interrupt mask
+ * @return Bitset of BQ25798_FLAG_* events that do not pulse INT
+ */
+uint64_t Adafruit_BQ25798::getInterruptMask() {
+  uint8_t buffer[BQ25798_REG_FAULT_MASK_1 - BQ25798_REG_CHARGER_MASK_0 + 1];
+  uint64_t mask = 0;
+
+  if (cacheHit(BQ25798_REG_CHARGER_MASK_0, sizeof(buffer))) {
+    for (uint8_t i = 0; i < sizeof(buffer); i++) {
+      buffer[i] = shadow_regs[cacheIndex(BQ25798_REG_CHARGER_MASK_0 + i)];
+    }
+    last_error = BQ25798_OK;
+  } else if (!readRegisters(BQ25798_REG_CHARGER_MASK_0, buffer,
+                            sizeof(buffer))) {
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < sizeof(buffer); i++) {
+    mask |= (uint64_t)buffer[i] << (i * 8);
+  }
+  return mask;
+}
+
+/*!
+ * @brief Service an INT pulse: read the status and flag registers
+ *        (0x1B-0x27) in one burst and dispatch the registered callbacks.
+ *        The flags are clear-on-read, so each event is seen exactly once.
+ *        Call this from loop() after your INT pin ISR has fired, never from
+ *        the ISR itself.
+ * @param flags Optional pointer that receives the raw BQ25798_FLAG_* bitset
+ * @return True if successful, false if the burst read failed
+ */
+bool Adafruit_BQ25798::handleInterrupt(uint64_t *flags) {
+  uint8_t buffer[BQ25798_REG_FAULT_FLAG_1 - BQ25798_REG_CHARGER_STATUS_0 + 1];
+
+  if (!readRegisters(BQ25798_REG_CHARGER_STATUS_0, buffer, sizeof(buffer))) {
+    return false;
+  }
+
+  bq25798_status_t status;
+  decodeStatus(buffer, status);
+
+  const uint8_t *flag_regs =
+      buffer + (BQ25798_REG_CHARGER_FLAG_0 - BQ25798_REG_CHARGER_STATUS_0);
+
+  uint64_t events = 0;
+  for (uint8_t i = 0;
+       i <= BQ25798_REG_FAULT_FLAG_1 - BQ25798_REG_CHARGER_FLAG_0; i++) {
+    events |= (uint64_t)flag_regs[i] << (i * 8);
+  }
+
+  if (flags) {
+    *flags = events;
+  }
+  if (!events) {
+    return true;
+  }
+
+  // A watchdog expiry reloads register defaults and a VBUS plug-in clears
+  // EN_HIZ, so the shadow copy can no longer be trusted
+  if ((cache_enabled || batching) &&
+      (events & (BQ25798_FLAG_WD | BQ25798_FLAG_VBUS_PRESENT))) {
+    resyncCache();
+  }
+
+  if ((events & BQ25798_FLAG_VBUS_PRESENT) && vbus_present_cb) {
+    vbus_present_cb(status.vbus_present);
+  }
+  if ((events & BQ25798_FLAG_PG) && power_good_cb) {
+    power_good_cb(status.power_good);
+  }
+  if (events & BQ25798_FLAG_CHG) {
+    if (chg_stat_cb) {
+      chg_stat_cb(status.chg_stat);
+    }
+    if (status.chg_stat == BQ25798_CHG_STAT_DONE && chg_done_cb) {
+      chg_done_cb();
+    }
+  }
+  if ((events & BQ25798_FLAG_WD) && wdt_cb) {
+    wdt_cb();
+  }
+  if ((events & BQ25798_FLAG_TSHUT) && tshut_cb) {
+    tshut_cb();
+  }
+  if ((events >> 32) && fault_cb) {
+    fault_cb((uint16_t)(events >> 32));
+  }
+  if (event_cb) {
+    event_cb(events);
+  }
+
   return true;
 }
 
+/*!
+ * @brief Register a handler for VBUS being plugged in or removed
+ * @param callback Called with the new VBUS_PRESENT_STAT, or NULL to clear
+ */
+void Adafruit_BQ25798::onVBUSPresentChanged(bq25798_state_callback_t callback) {
+  vbus_present_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for power good changes
+ * @param callback Called with the new PG_STAT, or NULL to clear
+ */
+void Adafruit_BQ25798::onPowerGoodChanged(bq25798_state_callback_t callback) {
+  power_good_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for charge state transitions
+ * @param callback Called with the new CHG_STAT, or NULL to clear
+ */
+void Adafruit_BQ25798::onChargeStateChanged(
+    bq25798_chg_stat_callback_t callback) {
+  chg_stat_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for charge termination
+ * @param callback Called when CHG_STAT reaches termination done, or NULL
+ */
+void Adafruit_BQ25798::onChargeDone(bq25798_callback_t callback) {
+  chg_done_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for watchdog expiry
+ * @param callback Called when the I2C watchdog timer expires, or NULL
+ */
+void Adafruit_BQ25798::onWatchdogExpired(bq25798_callback_t callback) {
+  wdt_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for thermal shutdown
+ * @param callback Called when the die enters thermal shutdown, or NULL
+ */
+void Adafruit_BQ25798::onTSHUT(bq25798_callback_t callback) {
+  tshut_cb = callback;
+}
+
+/*!
+ * @brief Register a handler for any protection fault
+ * @param callback Called with FAULT_FLAG_0 | (FAULT_FLAG_1 << 8), or NULL
+ */
+void Adafruit_BQ25798::onFault(bq25798_fault_callback_t callback) {
+  fault_cb = callback;
+}
+
+/*!
+ * @brief Register a catch-all handler that sees every flag raised
+ * @param callback Called with the BQ25798_FLAG_* bitset, or NULL to clear
+ */
+void Adafruit_BQ25798::onEvent(bq25798_event_callback_t callback) {
+  event_cb = callback;
+}
+
 /*!
  * @brief Reset all registers to default values
  * @return True if successful
  */
 bool Adafruit_BQ25798::reset() {
-  Adafruit_BusIO_Register term_reg = Adafruit_BusIO_Register(i2c_dev, BQ25798_REG_TERMINATION_CONTROL);
-  Adafruit_BusIO_RegisterBits reg_rst_bit = Adafruit_BusIO_RegisterBits(&term_reg, 1, 6);
+  if (!writeField<BQ25798_FIELD_REG_RST>(1)) {
+    return false;
+  }
   
-  reg_rst_bit.write(1);
+  // Every config register is back at its default, so reload the shadow
+  if (cache_enabled || batching) {
+    resyncCache();
+  }
   
   return true;
 }
\ No newline at end of file
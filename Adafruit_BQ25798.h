@@ -26,9 +26,7 @@
 #ifndef __ADAFRUIT_BQ25798_H__
 #define __ADAFRUIT_BQ25798_H__
 
-#include "Arduino.h"
-#include <Adafruit_BusIO_Register.h>
-#include <Adafruit_I2CDevice.h>
+#include "Adafruit_BQ25798_Transport.h"
 
 #define BQ25798_DEFAULT_ADDR 0x6B ///< Default I2C address
 
@@ -91,6 +89,81 @@
 #define BQ25798_REG_DPDM_DRIVER 0x47                ///< DPDM Driver
 #define BQ25798_REG_PART_INFORMATION 0x48           ///< Part Information
 
+#define BQ25798_NUM_REGS (BQ25798_REG_PART_INFORMATION + 1) ///< Map size
+#define BQ25798_CACHE_SIZE 35 ///< Shadowed bytes: 0x00-0x18, 0x28-0x30, 0x47
+
+#define BQ25798_CONFIG_VERSION 1 ///< saveConfig() blob format version
+#define BQ25798_CONFIG_SIZE                                                    \
+  (BQ25798_CACHE_SIZE + 3) ///< saveConfig() blob: version, registers, CRC16
+
+// Build with -DBQ25798_NO_FLOAT to drop the float volt/amp API and keep only
+// the integer millivolt/milliamp one, e.g. on parts without an FPU
+
+// Build with -DBQ25798_BUS_STATS to count every bus transaction
+#define BQ25798_LATENCY_BUCKETS 16 ///< log2(us) latency histogram buckets
+
+#ifndef BQ25798_XFER_TIMEOUT_US
+// Longest a transfer may stay in flight; a full-map burst at 100kHz is ~7ms
+#define BQ25798_XFER_TIMEOUT_US 25000 ///< Asynchronous transfer timeout
+#endif
+
+// Event bitset: bit ((reg - CHARGER_FLAG_0) * 8 + bit) of the flag registers.
+// The mask registers (0x28-0x2D) use the identical layout.
+#define BQ25798_FLAG_VBUS_PRESENT (1ULL << 0)  ///< VBUS present changed
+#define BQ25798_FLAG_AC1_PRESENT (1ULL << 1)   ///< VAC1 present changed
+#define BQ25798_FLAG_AC2_PRESENT (1ULL << 2)   ///< VAC2 present changed
+#define BQ25798_FLAG_PG (1ULL << 3)            ///< Power good changed
+#define BQ25798_FLAG_POORSRC (1ULL << 4)       ///< Poor source detected
+#define BQ25798_FLAG_WD (1ULL << 5)            ///< Watchdog timer expired
+#define BQ25798_FLAG_VINDPM (1ULL << 6)        ///< Entered VINDPM/VOTG reg
+#define BQ25798_FLAG_IINDPM (1ULL << 7)        ///< Entered IINDPM/IOTG reg
+#define BQ25798_FLAG_BC12_DONE (1ULL << 8)     ///< BC1.2 detection done
+#define BQ25798_FLAG_VBAT_PRESENT (1ULL << 9)  ///< Battery present changed
+#define BQ25798_FLAG_TREG (1ULL << 10)         ///< Thermal regulation
+#define BQ25798_FLAG_VBUS (1ULL << 12)         ///< VBUS status changed
+#define BQ25798_FLAG_ICO (1ULL << 14)          ///< ICO status changed
+#define BQ25798_FLAG_CHG (1ULL << 15)          ///< Charge status changed
+#define BQ25798_FLAG_TOPOFF_TMR (1ULL << 16)   ///< Top-off timer expired
+#define BQ25798_FLAG_PRECHG_TMR (1ULL << 17)   ///< Precharge timer expired
+#define BQ25798_FLAG_TRICHG_TMR (1ULL << 18)   ///< Trickle timer expired
+#define BQ25798_FLAG_CHG_TMR (1ULL << 19)      ///< Fast charge timer expired
+#define BQ25798_FLAG_VSYS (1ULL << 20)         ///< VSYSMIN regulation changed
+#define BQ25798_FLAG_ADC_DONE (1ULL << 21)     ///< One-shot ADC conversion done
+#define BQ25798_FLAG_DPDM_DONE (1ULL << 22)    ///< D+/D- detection done
+#define BQ25798_FLAG_TS_HOT (1ULL << 24)       ///< TS crossed hot threshold
+#define BQ25798_FLAG_TS_WARM (1ULL << 25)      ///< TS crossed warm threshold
+#define BQ25798_FLAG_TS_COOL (1ULL << 26)      ///< TS crossed cool threshold
+#define BQ25798_FLAG_TS_COLD (1ULL << 27)      ///< TS crossed cold threshold
+#define BQ25798_FLAG_VBATOTG_LOW (1ULL << 28)  ///< VBAT too low for OTG
+#define BQ25798_FLAG_VAC1_OVP (1ULL << 32)     ///< VAC1 over-voltage
+#define BQ25798_FLAG_VAC2_OVP (1ULL << 33)     ///< VAC2 over-voltage
+#define BQ25798_FLAG_CONV_OCP (1ULL << 34)     ///< Converter over-current
+#define BQ25798_FLAG_IBAT_OCP (1ULL << 35)     ///< IBAT over-current
+#define BQ25798_FLAG_IBUS_OCP (1ULL << 36)     ///< IBUS over-current
+#define BQ25798_FLAG_VBAT_OVP (1ULL << 37)     ///< VBAT over-voltage
+#define BQ25798_FLAG_VBUS_OVP (1ULL << 38)     ///< VBUS over-voltage
+#define BQ25798_FLAG_IBAT_REG (1ULL << 39)     ///< Battery discharge reg
+#define BQ25798_FLAG_TSHUT (1ULL << 42)        ///< Thermal shutdown
+#define BQ25798_FLAG_OTG_UVP (1ULL << 44)      ///< OTG under-voltage
+#define BQ25798_FLAG_OTG_OVP (1ULL << 45)      ///< OTG over-voltage
+#define BQ25798_FLAG_VSYS_OVP (1ULL << 46)     ///< VSYS over-voltage
+#define BQ25798_FLAG_VSYS_SHORT (1ULL << 47)   ///< VSYS short circuit
+#define BQ25798_FLAG_ALL 0x0000F4FF1F7FD7FFULL ///< Every defined event bit
+
+// ADC channel mask for configureADC(), in result register order (0x31-0x45)
+#define BQ25798_ADC_CH_IBUS (1 << 0)    ///< IBUS current
+#define BQ25798_ADC_CH_IBAT (1 << 1)    ///< IBAT current
+#define BQ25798_ADC_CH_VBUS (1 << 2)    ///< VBUS voltage
+#define BQ25798_ADC_CH_VAC1 (1 << 3)    ///< VAC1 voltage
+#define BQ25798_ADC_CH_VAC2 (1 << 4)    ///< VAC2 voltage
+#define BQ25798_ADC_CH_VBAT (1 << 5)    ///< VBAT voltage
+#define BQ25798_ADC_CH_VSYS (1 << 6)    ///< VSYS voltage
+#define BQ25798_ADC_CH_TS (1 << 7)      ///< TS pin voltage
+#define BQ25798_ADC_CH_TDIE (1 << 8)    ///< Die temperature
+#define BQ25798_ADC_CH_DPLUS (1 << 9)   ///< D+ voltage
+#define BQ25798_ADC_CH_DMINUS (1 << 10) ///< D- voltage
+#define BQ25798_ADC_CH_ALL 0x07FF       ///< Every channel
+
 /*!
  * @brief Battery voltage threshold for precharge to fast charge transition
  */
@@ -273,6 +346,352 @@ typedef enum {
   BQ25798_TSHUT_85C = 0x03         ///< 85°C
 } bq25798_tshut_t;
 
+/*!
+ * @brief Charge cycle state (CHG_STAT)
+ */
+typedef enum {
+  BQ25798_CHG_STAT_NOT_CHARGING = 0x00, ///< Not charging
+  BQ25798_CHG_STAT_TRICKLE = 0x01,      ///< Trickle charge
+  BQ25798_CHG_STAT_PRECHARGE = 0x02,    ///< Pre-charge
+  BQ25798_CHG_STAT_FAST = 0x03,         ///< Fast charge (CC mode)
+  BQ25798_CHG_STAT_TAPER = 0x04,        ///< Taper charge (CV mode)
+  BQ25798_CHG_STAT_TOPOFF = 0x06,       ///< Top-off timer active
+  BQ25798_CHG_STAT_DONE = 0x07          ///< Charge termination done
+} bq25798_chg_stat_t;
+
+/*!
+ * @brief Why the most recent driver call failed, see getLastError()
+ */
+typedef enum {
+  BQ25798_OK = 0,        ///< Success
+  BQ25798_ERR_BUS,       ///< Transfer NAKed or failed on every attempt
+  BQ25798_ERR_NO_DEVICE, ///< No transport, or begin() did not find the part
+  BQ25798_ERR_INVALID,   ///< Value out of range, field read-only or unknown,
+                         ///< or a corrupt saveConfig() blob
+  BQ25798_ERR_BUSY,      ///< A configuration batch is already open
+  BQ25798_ERR_TIMEOUT    ///< A transfer stayed in flight past
+                         ///< BQ25798_XFER_TIMEOUT_US
+} bq25798_error_t;
+
+#ifdef BQ25798_BUS_STATS
+/*!
+ * @brief Bus cost counters, only compiled in with BQ25798_BUS_STATS
+ */
+typedef struct {
+  uint32_t reads[BQ25798_NUM_REGS];  ///< Read transactions starting at reg
+  uint32_t writes[BQ25798_NUM_REGS]; ///< Write transactions starting at reg
+  uint32_t bytes[BQ25798_NUM_REGS];  ///< Bytes moved to or from reg
+  uint32_t latency[BQ25798_LATENCY_BUCKETS]; ///< Bucket n counts
+                                             ///< transactions of 2^n to
+                                             ///< 2^(n+1)-1 us (last: longer)
+  uint32_t total_reads;  ///< All read transactions
+  uint32_t total_writes; ///< All write transactions
+  uint32_t total_bytes;  ///< All register bytes moved
+  uint32_t errors;       ///< Transactions the transport reported as failed
+  uint32_t retries;      ///< Transactions repeated after a failure
+  uint32_t recoveries;   ///< Bus recoveries the transport carried out
+  uint32_t busy_us;      ///< Total time spent inside the transport
+} bq25798_bus_stats_t;
+#endif
+
+/*!
+ * @brief Input source type detected on VBUS (VBUS_STAT)
+ */
+typedef enum {
+  BQ25798_VBUS_STAT_NONE = 0x00,          ///< No input or BHOT/BCOLD in OTG
+  BQ25798_VBUS_STAT_USB_SDP = 0x01,       ///< USB SDP (500mA)
+  BQ25798_VBUS_STAT_USB_CDP = 0x02,       ///< USB CDP (1.5A)
+  BQ25798_VBUS_STAT_USB_DCP = 0x03,       ///< USB DCP (3.25A)
+  BQ25798_VBUS_STAT_HVDCP = 0x04,         ///< Adjustable high voltage DCP
+  BQ25798_VBUS_STAT_UNKNOWN = 0x05,       ///< Unknown adapter (3A)
+  BQ25798_VBUS_STAT_NON_STANDARD = 0x06,  ///< Non-standard adapter
+  BQ25798_VBUS_STAT_OTG = 0x07,           ///< In OTG mode
+  BQ25798_VBUS_STAT_NOT_QUALIFIED = 0x08, ///< Not qualified adapter
+  BQ25798_VBUS_STAT_DIRECT = 0x0B,        ///< Powered directly from VBUS
+  BQ25798_VBUS_STAT_BACKUP = 0x0C         ///< Backup mode
+} bq25798_vbus_stat_t;
+
+/*!
+ * @brief Input current optimizer state (ICO_STAT)
+ */
+typedef enum {
+  BQ25798_ICO_STAT_DISABLED = 0x00,    ///< ICO disabled
+  BQ25798_ICO_STAT_IN_PROGRESS = 0x01, ///< ICO optimization in progress
+  BQ25798_ICO_STAT_DONE = 0x02         ///< Maximum input current detected
+} bq25798_ico_stat_t;
+
+/*!
+ * @brief Decoded CHARGER_STATUS_0..4 and FAULT_STATUS_0/1 (0x1B-0x21)
+ */
+typedef struct {
+  // CHARGER_STATUS_0
+  bool iindpm;       ///< In IINDPM or IOTG regulation
+  bool vindpm;       ///< In VINDPM or VOTG regulation
+  bool wd_expired;   ///< Watchdog timer expired
+  bool power_good;   ///< Input power good
+  bool ac2_present;  ///< VAC2 present
+  bool ac1_present;  ///< VAC1 present
+  bool vbus_present; ///< VBUS present
+  // CHARGER_STATUS_1
+  bq25798_chg_stat_t chg_stat;   ///< Charge cycle state
+  bq25798_vbus_stat_t vbus_stat; ///< Input source type
+  bool bc12_done;                ///< BC1.2 or non-standard detection done
+  // CHARGER_STATUS_2
+  bq25798_ico_stat_t ico_stat; ///< Input current optimizer state
+  bool treg;                   ///< In thermal regulation
+  bool dpdm_ongoing;           ///< D+/D- detection in progress
+  bool vbat_present;           ///< Battery present
+  // CHARGER_STATUS_3
+  bool acrb2;      ///< ACFET2-RBFET2 placed
+  bool acrb1;      ///< ACFET1-RBFET1 placed
+  bool adc_done;   ///< One-shot ADC conversion complete
+  bool vsys_reg;   ///< In VSYSMIN regulation (battery below VSYSMIN)
+  bool chg_tmr;    ///< Fast charge safety timer expired
+  bool trichg_tmr; ///< Trickle charge safety timer expired
+  bool prechg_tmr; ///< Precharge safety timer expired
+  // CHARGER_STATUS_4
+  bool vbatotg_low; ///< Battery too low to enable OTG
+  bool ts_cold;     ///< TS in cold range
+  bool ts_cool;     ///< TS in cool range
+  bool ts_warm;     ///< TS in warm range
+  bool ts_hot;      ///< TS in hot range
+  // FAULT_STATUS_0
+  bool ibat_reg; ///< In battery discharge current regulation
+  bool vbus_ovp; ///< VBUS over-voltage
+  bool vbat_ovp; ///< VBAT over-voltage
+  bool ibus_ocp; ///< IBUS over-current
+  bool ibat_ocp; ///< IBAT over-current
+  bool conv_ocp; ///< Converter over-current
+  bool vac2_ovp; ///< VAC2 over-voltage
+  bool vac1_ovp; ///< VAC1 over-voltage
+  // FAULT_STATUS_1
+  bool vsys_short; ///< VSYS short circuit
+  bool vsys_ovp;   ///< VSYS over-voltage
+  bool otg_ovp;    ///< OTG over-voltage
+  bool otg_uvp;    ///< OTG under-voltage
+  bool tshut;      ///< In thermal shutdown
+} bq25798_status_t;
+
+typedef void (*bq25798_callback_t)(void); ///< Event with no payload
+typedef void (*bq25798_state_callback_t)(bool state); ///< New on/off state
+typedef void (*bq25798_chg_stat_callback_t)(
+    bq25798_chg_stat_t state); ///< New charge state
+typedef void (*bq25798_fault_callback_t)(
+    uint16_t faults); ///< FAULT_FLAG_0 (low byte) / FAULT_FLAG_1 (high byte)
+typedef void (*bq25798_event_callback_t)(
+    uint64_t flags); ///< Every flag raised, see BQ25798_FLAG_*
+
+/*!
+ * @brief One coherent snapshot of every ADC channel in integer units
+ */
+typedef struct {
+  int16_t ibus;    ///< IBUS current in mA (negative when sourcing in OTG)
+  int16_t ibat;    ///< IBAT current in mA (positive charging, negative
+                   ///< discharging)
+  uint16_t vbus;   ///< VBUS voltage in mV
+  uint16_t vac1;   ///< VAC1 voltage in mV
+  uint16_t vac2;   ///< VAC2 voltage in mV
+  uint16_t vbat;   ///< VBAT voltage in mV
+  uint16_t vsys;   ///< VSYS voltage in mV
+  uint16_t ts;     ///< TS pin voltage in 0.01% of REGN
+  int16_t tdie;    ///< Die temperature in 0.1 degrees C
+  uint16_t dplus;  ///< D+ voltage in mV
+  uint16_t dminus; ///< D- voltage in mV
+} bq25798_adc_fixed_t;
+
+#ifndef BQ25798_NO_FLOAT
+/*!
+ * @brief One coherent snapshot of every ADC channel, decoded to SI units
+ */
+typedef struct {
+  float ibus;   ///< IBUS current in amps (negative when sourcing in OTG)
+  float ibat;   ///< IBAT current in amps (positive charging, negative
+                ///< discharging)
+  float vbus;   ///< VBUS voltage in volts
+  float vac1;   ///< VAC1 voltage in volts
+  float vac2;   ///< VAC2 voltage in volts
+  float vbat;   ///< VBAT voltage in volts
+  float vsys;   ///< VSYS voltage in volts
+  float ts;     ///< TS pin voltage as a percentage of REGN
+  float tdie;   ///< Die temperature in degrees C
+  float dplus;  ///< D+ voltage in volts
+  float dminus; ///< D- voltage in volts
+} bq25798_adc_t;
+#endif
+
+/*!
+ * @brief ADC sample resolution (ADC_SAMPLE). Lower resolution converts
+ *        faster: roughly 24ms, 12ms, 6ms and 3ms per channel.
+ */
+typedef enum {
+  BQ25798_ADC_RES_15BIT = 0x00, ///< 15 bit effective resolution
+  BQ25798_ADC_RES_14BIT = 0x01, ///< 14 bit effective resolution
+  BQ25798_ADC_RES_13BIT = 0x02, ///< 13 bit effective resolution
+  BQ25798_ADC_RES_12BIT = 0x03  ///< 12 bit effective resolution
+} bq25798_adc_resolution_t;
+
+/*!
+ * @brief One streamed ADC snapshot, see Adafruit_BQ25798::poll()
+ */
+typedef struct {
+  uint32_t timestamp_us;   ///< micros() when the burst read was issued
+  uint16_t channels;       ///< BQ25798_ADC_CH_* mask of valid fields in adc
+  bq25798_adc_fixed_t adc; ///< Decoded values, disabled channels read 0
+} bq25798_adc_sample_t;
+
+#define BQ25798_FIELD_SIGNED 0x01 ///< Field is two's complement
+#define BQ25798_FIELD_RO 0x02     ///< Field cannot be written
+#define BQ25798_FIELD_RO_SIGNED                                                \
+  (BQ25798_FIELD_RO | BQ25798_FIELD_SIGNED) ///< Read-only two's complement
+#define BQ25798_FIELD_NAME_MAX 17 ///< Longest field name plus its NUL
+
+/*!
+ * @brief Every register field the driver knows about, in register order.
+ *        Columns: name, register, register width in bytes, field bits,
+ *        shift, units per LSB, units at raw 0, min and max setting, flags.
+ *        Units are mV, mA, 0.1C for TDIE, and raw counts for enums,
+ *        booleans and TS_ADC. The field enum, descriptor table and accessor
+ *        engine are all generated from this list.
+ */
+#define BQ25798_FIELD_LIST(X)                                                  \
+  X(VSYSMIN, 0x00, 1, 6, 0, 250, 2500, 2500, 16000, 0)                         \
+  X(VREG, 0x01, 2, 11, 0, 10, 0, 3000, 18800, 0)                               \
+  X(ICHG, 0x03, 2, 9, 0, 10, 0, 50, 5000, 0)                                   \
+  X(VINDPM, 0x05, 1, 8, 0, 100, 0, 3600, 22000, 0)                             \
+  X(IINDPM, 0x06, 2, 9, 0, 10, 0, 100, 3300, 0)                                \
+  X(VBAT_LOWV, 0x08, 1, 2, 6, 1, 0, 0, 3, 0)                                   \
+  X(IPRECHG, 0x08, 1, 6, 0, 40, 0, 40, 2000, 0)                                \
+  X(STOP_WD_CHG, 0x09, 1, 1, 5, 1, 0, 0, 1, 0)                                 \
+  X(REG_RST, 0x09, 1, 1, 6, 1, 0, 0, 1, 0)                                     \
+  X(ITERM, 0x09, 1, 5, 0, 40, 0, 40, 1000, 0)                                  \
+  X(CELL, 0x0A, 1, 2, 6, 1, 0, 0, 3, 0)                                        \
+  X(TRECHG, 0x0A, 1, 2, 4, 1, 0, 0, 3, 0)                                      \
+  X(VRECHG, 0x0A, 1, 4, 0, 50, 50, 50, 800, 0)                                 \
+  X(VOTG, 0x0B, 2, 11, 0, 10, 2800, 2800, 22000, 0)                            \
+  X(PRECHG_TMR, 0x0D, 1, 1, 7, 1, 0, 0, 1, 0)                                  \
+  X(IOTG, 0x0D, 1, 7, 0, 40, 0, 160, 3360, 0)                                  \
+  X(TOPOFF_TMR, 0x0E, 1, 2, 6, 1, 0, 0, 3, 0)                                  \
+  X(EN_TRICHG_TMR, 0x0E, 1, 1, 5, 1, 0, 0, 1, 0)                               \
+  X(EN_PRECHG_TMR, 0x0E, 1, 1, 4, 1, 0, 0, 1, 0)                               \
+  X(EN_CHG_TMR, 0x0E, 1, 1, 3, 1, 0, 0, 1, 0)                                  \
+  X(CHG_TMR, 0x0E, 1, 2, 1, 1, 0, 0, 3, 0)                                     \
+  X(TMR2X_EN, 0x0E, 1, 1, 0, 1, 0, 0, 1, 0)                                    \
+  X(EN_AUTO_IBATDIS, 0x0F, 1, 1, 7, 1, 0, 0, 1, 0)                             \
+  X(FORCE_IBATDIS, 0x0F, 1, 1, 6, 1, 0, 0, 1, 0)                               \
+  X(EN_CHG, 0x0F, 1, 1, 5, 1, 0, 0, 1, 0)                                      \
+  X(EN_ICO, 0x0F, 1, 1, 4, 1, 0, 0, 1, 0)                                      \
+  X(FORCE_ICO, 0x0F, 1, 1, 3, 1, 0, 0, 1, 0)                                   \
+  X(EN_HIZ, 0x0F, 1, 1, 2, 1, 0, 0, 1, 0)                                      \
+  X(EN_TERM, 0x0F, 1, 1, 1, 1, 0, 0, 1, 0)                                     \
+  X(EN_BACKUP, 0x0F, 1, 1, 0, 1, 0, 0, 1, 0)                                   \
+  X(VBUS_BACKUP, 0x10, 1, 2, 6, 1, 0, 0, 3, 0)                                 \
+  X(VAC_OVP, 0x10, 1, 2, 4, 1, 0, 0, 3, 0)                                     \
+  X(WD_RST, 0x10, 1, 1, 3, 1, 0, 0, 1, 0)                                      \
+  X(WATCHDOG, 0x10, 1, 3, 0, 1, 0, 0, 7, 0)                                    \
+  X(FORCE_INDET, 0x11, 1, 1, 7, 1, 0, 0, 1, 0)                                 \
+  X(AUTO_INDET_EN, 0x11, 1, 1, 6, 1, 0, 0, 1, 0)                               \
+  X(EN_12V, 0x11, 1, 1, 5, 1, 0, 0, 1, 0)                                      \
+  X(EN_9V, 0x11, 1, 1, 4, 1, 0, 0, 1, 0)                                       \
+  X(HVDCP_EN, 0x11, 1, 1, 3, 1, 0, 0, 1, 0)                                    \
+  X(SDRV_CTRL, 0x11, 1, 2, 1, 1, 0, 0, 3, 0)                                   \
+  X(SDRV_DLY, 0x11, 1, 1, 0, 1, 0, 0, 1, 0)                                    \
+  X(DIS_ACDRV, 0x12, 1, 1, 7, 1, 0, 0, 1, 0)                                   \
+  X(EN_OTG, 0x12, 1, 1, 6, 1, 0, 0, 1, 0)                                      \
+  X(PFM_OTG_DIS, 0x12, 1, 1, 5, 1, 0, 0, 1, 0)                                 \
+  X(PFM_FWD_DIS, 0x12, 1, 1, 4, 1, 0, 0, 1, 0)                                 \
+  X(WKUP_DLY, 0x12, 1, 1, 3, 1, 0, 0, 1, 0)                                    \
+  X(DIS_LDO, 0x12, 1, 1, 2, 1, 0, 0, 1, 0)                                     \
+  X(DIS_OTG_OOA, 0x12, 1, 1, 1, 1, 0, 0, 1, 0)                                 \
+  X(DIS_FWD_OOA, 0x12, 1, 1, 0, 1, 0, 0, 1, 0)                                 \
+  X(EN_ACDRV2, 0x13, 1, 1, 7, 1, 0, 0, 1, 0)                                   \
+  X(EN_ACDRV1, 0x13, 1, 1, 6, 1, 0, 0, 1, 0)                                   \
+  X(PWM_FREQ, 0x13, 1, 1, 5, 1, 0, 0, 1, 0)                                    \
+  X(DIS_STAT, 0x13, 1, 1, 4, 1, 0, 0, 1, 0)                                    \
+  X(DIS_VSYS_SHORT, 0x13, 1, 1, 3, 1, 0, 0, 1, 0)                              \
+  X(DIS_VOTG_UVP, 0x13, 1, 1, 2, 1, 0, 0, 1, 0)                                \
+  X(FORCE_VINDPM_DET, 0x13, 1, 1, 1, 1, 0, 0, 1, 0)                            \
+  X(EN_IBUS_OCP, 0x13, 1, 1, 0, 1, 0, 0, 1, 0)                                 \
+  X(SFET_PRESENT, 0x14, 1, 1, 7, 1, 0, 0, 1, 0)                                \
+  X(EN_IBAT, 0x14, 1, 1, 5, 1, 0, 0, 1, 0)                                     \
+  X(IBAT_REG, 0x14, 1, 2, 3, 1, 0, 0, 3, 0)                                    \
+  X(EN_IINDPM, 0x14, 1, 1, 2, 1, 0, 0, 1, 0)                                   \
+  X(EN_EXTILIM, 0x14, 1, 1, 1, 1, 0, 0, 1, 0)                                  \
+  X(EN_BATOC, 0x14, 1, 1, 0, 1, 0, 0, 1, 0)                                    \
+  X(VOC_PCT, 0x15, 1, 3, 5, 1, 0, 0, 7, 0)                                     \
+  X(VOC_DLY, 0x15, 1, 2, 3, 1, 0, 0, 3, 0)                                     \
+  X(VOC_RATE, 0x15, 1, 2, 1, 1, 0, 0, 3, 0)                                    \
+  X(EN_MPPT, 0x15, 1, 1, 0, 1, 0, 0, 1, 0)                                     \
+  X(TREG, 0x16, 1, 2, 6, 1, 0, 0, 3, 0)                                        \
+  X(TSHUT, 0x16, 1, 2, 4, 1, 0, 0, 3, 0)                                       \
+  X(VBUS_PD_EN, 0x16, 1, 1, 3, 1, 0, 0, 1, 0)                                  \
+  X(VAC1_PD_EN, 0x16, 1, 1, 2, 1, 0, 0, 1, 0)                                  \
+  X(VAC2_PD_EN, 0x16, 1, 1, 1, 1, 0, 0, 1, 0)                                  \
+  X(BKUP_ACFET1_ON, 0x16, 1, 1, 0, 1, 0, 0, 1, 0)                              \
+  X(ADC_EN, 0x2E, 1, 1, 7, 1, 0, 0, 1, 0)                                      \
+  X(IBUS_ADC, 0x31, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO_SIGNED)             \
+  X(IBAT_ADC, 0x33, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO_SIGNED)             \
+  X(VBUS_ADC, 0x35, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                    \
+  X(VAC1_ADC, 0x37, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                    \
+  X(VAC2_ADC, 0x39, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                    \
+  X(VBAT_ADC, 0x3B, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                    \
+  X(VSYS_ADC, 0x3D, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                    \
+  X(TS_ADC, 0x3F, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                      \
+  X(TDIE_ADC, 0x41, 2, 16, 0, 5, 0, 0, 0, BQ25798_FIELD_RO_SIGNED)             \
+  X(DPLUS_ADC, 0x43, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)                   \
+  X(DMINUS_ADC, 0x45, 2, 16, 0, 1, 0, 0, 0, BQ25798_FIELD_RO)
+
+/*!
+ * @brief Expands one BQ25798_FIELD_LIST row into its bq25798_field_t name
+ */
+#define BQ25798_FIELD_ENUM(name, reg, width, bits, shift, scale, offset, min,  \
+                           max, flags)                                         \
+  BQ25798_FIELD_##name,
+
+/*!
+ * @brief Register field identifiers, named after the datasheet bit fields
+ */
+typedef enum {
+  BQ25798_FIELD_LIST(BQ25798_FIELD_ENUM) BQ25798_FIELD_COUNT ///< Field count
+} bq25798_field_t;
+
+/*!
+ * @brief Location and scaling of one register field
+ */
+typedef struct {
+  uint8_t reg;     ///< Register address, the MSB for 16-bit registers
+  uint8_t width;   ///< Register width in bytes (1 or 2)
+  uint8_t bits;    ///< Field width in bits
+  uint8_t shift;   ///< Bit position of the field's LSB
+  uint16_t scale;  ///< Units per LSB
+  uint16_t offset; ///< Units at raw 0
+  uint16_t min;    ///< Lowest accepted setting
+  uint16_t max;    ///< Highest accepted setting
+  uint8_t flags;   ///< BQ25798_FIELD_SIGNED and/or BQ25798_FIELD_RO
+} bq25798_field_desc_t;
+
+typedef void (*bq25798_async_callback_t)(
+    bool ok, void *context); ///< Queued operation finished, see tick()
+
+/*!
+ * @brief Queue slot for one asynchronous operation. The caller supplies an
+ *        array of these to setAsyncQueue(); the fields are internal.
+ */
+typedef struct {
+  uint8_t kind;                      ///< Operation type
+  uint8_t reg;                       ///< First register
+  uint8_t len;                       ///< Register count
+  uint8_t field;                     ///< bq25798_field_t of field operations
+  uint8_t phase;                     ///< 1 once a read-modify-write has read
+  uint8_t tries;                     ///< Failed attempts at this transfer
+  uint8_t raw[2];                    ///< Register bytes of field operations
+  uint16_t value;                    ///< Encoded field bits to write
+  void *data;                        ///< Caller buffer or result struct
+  bq25798_async_callback_t callback; ///< Completion callback, may be NULL
+  void *context;                     ///< Passed back to callback
+} bq25798_async_op_t;
+
+class Adafruit_BQ25798_ADCRing;
+
 /*!
  * @brief BQ25798 I2C controlled buck-boost battery charger
  */
@@ -281,34 +700,65 @@ public:
   Adafruit_BQ25798();
   ~Adafruit_BQ25798();
 
+#ifdef ARDUINO
   bool begin(uint8_t i2c_addr = BQ25798_DEFAULT_ADDR, TwoWire *wire = &Wire);
+#endif
+  bool begin(Adafruit_BQ25798_Transport *bus);
 
+#ifndef BQ25798_NO_FLOAT
   float getMinSystemV();
   bool setMinSystemV(float voltage);
+#endif
+  uint16_t getMinSystem_mV();
+  bool setMinSystem_mV(uint16_t millivolts);
 
+#ifndef BQ25798_NO_FLOAT
   float getChargeLimitV();
   bool setChargeLimitV(float voltage);
+#endif
+  uint16_t getChargeLimit_mV();
+  bool setChargeLimit_mV(uint16_t millivolts);
 
+#ifndef BQ25798_NO_FLOAT
   float getChargeLimitA();
   bool setChargeLimitA(float current);
+#endif
+  uint16_t getChargeLimit_mA();
+  bool setChargeLimit_mA(uint16_t milliamps);
 
+#ifndef BQ25798_NO_FLOAT
   float getInputLimitV();
   bool setInputLimitV(float voltage);
+#endif
+  uint16_t getInputLimit_mV();
+  bool setInputLimit_mV(uint16_t millivolts);
 
+#ifndef BQ25798_NO_FLOAT
   float getInputLimitA();
   bool setInputLimitA(float current);
+#endif
+  uint16_t getInputLimit_mA();
+  bool setInputLimit_mA(uint16_t milliamps);
 
   bq25798_vbat_lowv_t getVBatLowV();
   bool setVBatLowV(bq25798_vbat_lowv_t threshold);
 
+#ifndef BQ25798_NO_FLOAT
   float getPrechargeLimitA();
   bool setPrechargeLimitA(float current);
+#endif
+  uint16_t getPrechargeLimit_mA();
+  bool setPrechargeLimit_mA(uint16_t milliamps);
 
   bool getStopOnWDT();
   bool setStopOnWDT(bool stopOnWDT);
 
+#ifndef BQ25798_NO_FLOAT
   float getTerminationA();
   bool setTerminationA(float current);
+#endif
+  uint16_t getTermination_mA();
+  bool setTermination_mA(uint16_t milliamps);
 
   bq25798_cell_count_t getCellCount();
   bool setCellCount(bq25798_cell_count_t cellCount);
@@ -316,17 +766,29 @@ public:
   bq25798_trechg_time_t getRechargeDeglitchTime();
   bool setRechargeDeglitchTime(bq25798_trechg_time_t deglitchTime);
 
+#ifndef BQ25798_NO_FLOAT
   float getRechargeThreshOffsetV();
   bool setRechargeThreshOffsetV(float voltage);
+#endif
+  uint16_t getRechargeThreshOffset_mV();
+  bool setRechargeThreshOffset_mV(uint16_t millivolts);
 
+#ifndef BQ25798_NO_FLOAT
   float getOTGV();
   bool setOTGV(float voltage);
+#endif
+  uint16_t getOTG_mV();
+  bool setOTG_mV(uint16_t millivolts);
 
   bq25798_prechg_timer_t getPrechargeTimer();
   bool setPrechargeTimer(bq25798_prechg_timer_t timer);
 
+#ifndef BQ25798_NO_FLOAT
   float getOTGLimitA();
   bool setOTGLimitA(float current);
+#endif
+  uint16_t getOTGLimit_mA();
+  bool setOTGLimit_mA(uint16_t milliamps);
 
   bq25798_topoff_timer_t getTopOffTimer();
   bool setTopOffTimer(bq25798_topoff_timer_t timer);
@@ -377,6 +839,9 @@ public:
   bool setVACOVP(bq25798_vac_ovp_t threshold);
 
   bool resetWDT();
+  bool getWDTStatus();
+  void setWDTPiggyback(bool enable);
+  uint32_t getLastWDTReset();
 
   bq25798_wdt_t getWDT();
   bool setWDT(bq25798_wdt_t timer);
@@ -500,8 +965,157 @@ public:
 
   bool reset();
 
+#ifndef BQ25798_NO_FLOAT
+  bool readAllADC(bq25798_adc_t &adc);
+#endif
+  bool readAllADC(bq25798_adc_fixed_t &adc);
+
+  bool getStatus(bq25798_status_t &status);
+
+  bool configureADC(bool continuous,
+                    bq25798_adc_resolution_t resolution = BQ25798_ADC_RES_15BIT,
+                    bool averaging = false,
+                    uint16_t channels = BQ25798_ADC_CH_ALL);
+  bool disableADC();
+  bool getADCEnable();
+  void setADCStream(Adafruit_BQ25798_ADCRing *ring);
+  bool poll();
+
+  bool setInterruptMask(uint64_t mask);
+  uint64_t getInterruptMask();
+  bool handleInterrupt(uint64_t *flags = NULL);
+
+  void onVBUSPresentChanged(bq25798_state_callback_t callback);
+  void onPowerGoodChanged(bq25798_state_callback_t callback);
+  void onChargeStateChanged(bq25798_chg_stat_callback_t callback);
+  void onChargeDone(bq25798_callback_t callback);
+  void onWatchdogExpired(bq25798_callback_t callback);
+  void onTSHUT(bq25798_callback_t callback);
+  void onFault(bq25798_fault_callback_t callback);
+  void onEvent(bq25798_event_callback_t callback);
+
+#ifdef BQ25798_BUS_STATS
+  void getBusStats(bq25798_bus_stats_t &stats);
+  void resetBusStats();
+#endif
+
+  bool beginBatch();
+  bool commit();
+  void abortBatch();
+
+  bool saveConfig(uint8_t *buffer);
+  bool restoreConfig(const uint8_t *buffer, uint8_t *changed = NULL);
+  static uint16_t crc16(const uint8_t *data, uint8_t len);
+
+  int32_t getField(bq25798_field_t field);
+  bool getField(bq25798_field_t field, int32_t &value);
+  bool setField(bq25798_field_t field, int32_t value);
+  bool getFields(const bq25798_field_t *fields, int32_t *values,
+                 uint8_t count);
+  static bool getFieldInfo(bq25798_field_t field, bq25798_field_desc_t &desc);
+  static bool getFieldName(bq25798_field_t field, char *buffer, uint8_t len);
+  static bq25798_field_t findField(const char *name);
+
+  void setAsyncQueue(bq25798_async_op_t *ops, uint8_t capacity);
+  bool readAsync(uint8_t reg, uint8_t *buffer, uint8_t len,
+                 bq25798_async_callback_t callback = NULL,
+                 void *context = NULL);
+  bool writeAsync(uint8_t reg, const uint8_t *buffer, uint8_t len,
+                  bq25798_async_callback_t callback = NULL,
+                  void *context = NULL);
+  bool getFieldAsync(bq25798_field_t field, int32_t *value,
+                     bq25798_async_callback_t callback = NULL,
+                     void *context = NULL);
+  bool setFieldAsync(bq25798_field_t field, int32_t value,
+                     bq25798_async_callback_t callback = NULL,
+                     void *context = NULL);
+  bool getStatusAsync(bq25798_status_t *status,
+                      bq25798_async_callback_t callback = NULL,
+                      void *context = NULL);
+  bool readAllADCAsync(bq25798_adc_fixed_t *adc,
+                       bq25798_async_callback_t callback = NULL,
+                       void *context = NULL);
+  bool tick();
+  uint8_t asyncPending();
+
+  void setRetryPolicy(uint8_t attempts, uint16_t backoff_us = 100,
+                      bool recover = true);
+  bq25798_error_t getLastError();
+
+  bool enableCache(bool enable = true);
+  bool resyncCache();
+  void invalidateCache();
+
 private:
-  Adafruit_I2CDevice *i2c_dev; ///< Pointer to I2C bus interface
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len);
+  bool transfer(bool write, uint8_t reg, uint8_t *buffer, uint8_t len);
+  uint16_t readBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                    uint8_t width = 1);
+  bool readBits(uint8_t reg, uint8_t bits, uint8_t shift, uint8_t width,
+                uint16_t &value);
+  bool writeBits(uint8_t reg, uint8_t bits, uint8_t shift, uint16_t value,
+                 uint8_t width = 1);
+  template <bq25798_field_t F> int32_t readField();
+  template <bq25798_field_t F> bool writeField(int32_t value);
+  void syncShadow(bool write, uint8_t reg, const uint8_t *buffer,
+                  uint8_t len);
+  bool cacheHit(uint8_t reg, uint8_t len);
+  bool isDirty(int8_t idx);
+  bool fillShadow();
+  bool readADCChannels(uint16_t channels, bq25798_adc_fixed_t &adc);
+  bool asyncPush(uint8_t kind, uint8_t reg, uint8_t len, void *data,
+                 bq25798_async_callback_t callback, void *context);
+  bool asyncStart();
+  void asyncFinish(bool ok);
+  bool readConfigImage(uint8_t *image);
+#ifdef BQ25798_BUS_STATS
+  void recordTransaction(bool write, uint8_t reg, uint8_t len, bool ok,
+                         uint32_t start_us);
+#endif
+
+  Adafruit_BQ25798_Transport *transport; ///< Register access backend
+  bool owns_transport; ///< True if begin() allocated the transport
+
+  uint8_t retry_attempts;     ///< Tries per transfer, at least 1
+  uint16_t retry_backoff_us;  ///< Wait before the first retry, doubling
+  bool retry_recover;         ///< Ask the transport to recover the bus
+  bq25798_error_t last_error; ///< Outcome of the last transfer or setting
+
+  bool wdt_piggyback;    ///< Set WD_RST in every CHARGER_CONTROL_1 write
+  uint32_t wdt_reset_ms; ///< millis() of the last write carrying WD_RST
+
+  uint8_t shadow_regs[BQ25798_CACHE_SIZE]; ///< Shadow copy of config registers
+  bool cache_enabled; ///< True if the shadow cache has been opted in to
+  bool cache_valid;   ///< True if shadow_regs matches the chip
+  bool batching;      ///< True between beginBatch() and commit()
+  bool resync_pending; ///< resyncCache() deferred until commit()
+  uint8_t shadow_dirty[(BQ25798_CACHE_SIZE + 7) / 8]; ///< Staged registers
+
+  Adafruit_BQ25798_ADCRing *adc_ring; ///< Destination for poll() samples
+  uint16_t adc_channels; ///< BQ25798_ADC_CH_* enabled by configureADC()
+  bool adc_oneshot;      ///< True if poll() must re-arm each conversion
+  bq25798_async_op_t *async_ops; ///< Caller provided queue storage
+  uint8_t async_capacity;         ///< Slots in async_ops
+  uint8_t async_head;             ///< Slot of the oldest queued operation
+  uint8_t async_count;            ///< Queued operations, including in flight
+  bool async_busy;                ///< True while a queued transfer is in flight
+  bool async_timed_out;           ///< Transfer in flight overran the timeout
+  bool async_write;               ///< Direction of the transfer in flight
+  uint32_t async_start_us;        ///< micros() the transfer in flight began
+
+#ifdef BQ25798_BUS_STATS
+  bq25798_bus_stats_t bus_stats; ///< Accumulated bus cost counters
+#endif
+
+  bq25798_state_callback_t vbus_present_cb; ///< VBUS_PRESENT_FLAG handler
+  bq25798_state_callback_t power_good_cb;   ///< PG_FLAG handler
+  bq25798_chg_stat_callback_t chg_stat_cb;  ///< CHG_FLAG handler
+  bq25798_callback_t chg_done_cb;           ///< CHG_FLAG into DONE handler
+  bq25798_callback_t wdt_cb;                ///< WD_FLAG handler
+  bq25798_callback_t tshut_cb;              ///< TSHUT_FLAG handler
+  bq25798_fault_callback_t fault_cb;        ///< FAULT_FLAG_0/1 handler
+  bq25798_event_callback_t event_cb;        ///< Catch-all handler
 };
 
 #endif // __ADAFRUIT_BQ25798_H__
\ No newline at end of file
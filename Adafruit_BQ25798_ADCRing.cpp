@@ -0,0 +1,116 @@
+/*!
+ * @file Adafruit_BQ25798_ADCRing.cpp
+ *
+ * Lock-free SPSC ring buffer for streamed BQ25798 ADC samples.
+ *
+ * head and tail run freely and are masked on use, so all capacity slots are
+ * usable and full/empty are told apart by head - tail. Each index is written
+ * by only one side and published with release ordering after the slot it
+ * guards, and read by the other side with acquire ordering.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_ADCRing.h"
+
+/*!
+ * @brief  Wrap caller provided storage in a ring buffer
+ * @param  storage Array of capacity samples, must outlive the ring
+ * @param  capacity Number of slots, a power of two
+ */
+Adafruit_BQ25798_ADCRing::Adafruit_BQ25798_ADCRing(
+    bq25798_adc_sample_t *storage, bq25798_ring_index_t capacity) {
+  slots = storage;
+  mask = capacity - 1;
+  head = 0;
+  tail = 0;
+  overruns = 0;
+}
+
+/*!
+ * @brief  Append a sample. Producer side only.
+ * @param  sample Sample to copy into the ring
+ * @return True if queued, false if the ring was full (the sample is counted
+ *         in dropped())
+ */
+bool Adafruit_BQ25798_ADCRing::push(const bq25798_adc_sample_t &sample) {
+  bq25798_ring_index_t h = head;
+  bq25798_ring_index_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+
+  if ((bq25798_ring_index_t)(h - t) > mask) {
+    overruns++;
+    return false;
+  }
+
+  slots[h & mask] = sample;
+  __atomic_store_n(&head, (bq25798_ring_index_t)(h + 1), __ATOMIC_RELEASE);
+  return true;
+}
+
+/*!
+ * @brief  Remove the oldest sample. Consumer side only.
+ * @param  sample Filled with the oldest queued sample
+ * @return True if a sample was returned, false if the ring was empty
+ */
+bool Adafruit_BQ25798_ADCRing::pop(bq25798_adc_sample_t &sample) {
+  if (!peek(sample)) {
+    return false;
+  }
+
+  __atomic_store_n(&tail, (bq25798_ring_index_t)(tail + 1), __ATOMIC_RELEASE);
+  return true;
+}
+
+/*!
+ * @brief  Copy the oldest sample without removing it. Consumer side only.
+ * @param  sample Filled with the oldest queued sample
+ * @return True if a sample was returned, false if the ring was empty
+ */
+bool Adafruit_BQ25798_ADCRing::peek(bq25798_adc_sample_t &sample) {
+  bq25798_ring_index_t t = tail;
+  bq25798_ring_index_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+
+  if (h == t) {
+    return false;
+  }
+
+  sample = slots[t & mask];
+  return true;
+}
+
+/*!
+ * @brief  Number of samples waiting. Exact on the consumer side, a lower
+ *         bound on the producer side.
+ * @return Queued sample count
+ */
+bq25798_ring_index_t Adafruit_BQ25798_ADCRing::available() {
+  return (bq25798_ring_index_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) -
+                                __atomic_load_n(&tail, __ATOMIC_ACQUIRE));
+}
+
+/*!
+ * @brief  Total number of slots
+ * @return Capacity in samples
+ */
+bq25798_ring_index_t Adafruit_BQ25798_ADCRing::capacity() {
+  return mask + 1;
+}
+
+/*!
+ * @brief  Samples the producer discarded because the consumer fell behind
+ * @return Overrun count since construction or clear()
+ */
+uint32_t Adafruit_BQ25798_ADCRing::dropped() {
+  return overruns;
+}
+
+/*!
+ * @brief  Discard everything queued and zero the overrun count. Only safe
+ *         while neither side is running.
+ */
+void Adafruit_BQ25798_ADCRing::clear() {
+  head = 0;
+  tail = 0;
+  overruns = 0;
+}
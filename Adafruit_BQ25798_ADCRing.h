@@ -0,0 +1,74 @@
+/*!
+ * @file Adafruit_BQ25798_ADCRing.h
+ *
+ * Fixed-capacity single-producer/single-consumer ring buffer for streamed
+ * BQ25798 ADC samples.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_ADCRING_H__
+#define __ADAFRUIT_BQ25798_ADCRING_H__
+
+#include "Adafruit_BQ25798.h"
+
+// Indices must be loaded and stored in a single instruction so the producer
+// and consumer never see a torn value. AVR only guarantees that for bytes.
+#if defined(__AVR__)
+typedef uint8_t bq25798_ring_index_t; ///< Natively atomic index type
+#else
+typedef uint32_t bq25798_ring_index_t; ///< Natively atomic index type
+#endif
+
+/*!
+ * @brief Lock-free SPSC queue of bq25798_adc_sample_t. Exactly one context
+ *        (e.g. the charger control task calling Adafruit_BQ25798::poll())
+ *        may push, and exactly one other context (e.g. a data logger task)
+ *        may pop. No locks are taken and interrupts are never disabled.
+ *
+ *        The storage is supplied by the caller; see Adafruit_BQ25798_ADCBuffer
+ *        for a version that carries its own.
+ */
+class Adafruit_BQ25798_ADCRing {
+public:
+  Adafruit_BQ25798_ADCRing(bq25798_adc_sample_t *storage,
+                           bq25798_ring_index_t capacity);
+
+  bool push(const bq25798_adc_sample_t &sample);
+  bool pop(bq25798_adc_sample_t &sample);
+  bool peek(bq25798_adc_sample_t &sample);
+
+  bq25798_ring_index_t available();
+  bq25798_ring_index_t capacity();
+  uint32_t dropped();
+  void clear();
+
+private:
+  bq25798_adc_sample_t *slots; ///< Caller provided storage
+  bq25798_ring_index_t mask;   ///< capacity - 1, capacity is a power of two
+  bq25798_ring_index_t head;   ///< Next slot to write, owned by the producer
+  bq25798_ring_index_t tail;   ///< Next slot to read, owned by the consumer
+  uint32_t overruns;           ///< Samples discarded because the ring was full
+};
+
+/*!
+ * @brief Adafruit_BQ25798_ADCRing with inline storage for N samples
+ * @tparam N Capacity in samples, a power of two (at most 128 on AVR)
+ */
+template <bq25798_ring_index_t N>
+class Adafruit_BQ25798_ADCBuffer : public Adafruit_BQ25798_ADCRing {
+public:
+  /*!
+   * @brief  Create an empty buffer
+   */
+  Adafruit_BQ25798_ADCBuffer() : Adafruit_BQ25798_ADCRing(storage, N) {}
+
+private:
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+  static_assert((bq25798_ring_index_t)(N * 2) != 0, "N is too large");
+
+  bq25798_adc_sample_t storage[N]; ///< Sample slots
+};
+
+#endif // __ADAFRUIT_BQ25798_ADCRING_H__
@@ -0,0 +1,430 @@
+/*!
+ * @file Adafruit_BQ25798_Arbiter.cpp
+ *
+ * Dual-input source arbiter for the BQ25798.
+ *
+ * With both ACFET-RBFET pairs fitted the chip powers from whichever of
+ * VAC1/VAC2 the host enables with EN_ACDRV1/EN_ACDRV2, but never decides
+ * between them itself. This reads both input voltages and the input status
+ * and moves between the pairs under a policy, with debouncing on both
+ * sides of a switch and a dead time so the two inputs are never shorted
+ * together through the pairs.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Arbiter.h"
+
+/*!
+ * @brief  Create an arbiter for a charger. Does not touch the bus.
+ * @param  charger Charger to arbitrate, already started with begin()
+ */
+Adafruit_BQ25798_Arbiter::Adafruit_BQ25798_Arbiter(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  policy = BQ25798_ARBITER_HIGHER_VOLTAGE;
+  solar = BQ25798_INPUT_VAC2;
+  cost[0] = cost[1] = 0;
+  vac[0] = vac[1] = 0;
+  valid[0] = valid[1] = false;
+  changed_ms[0] = changed_ms[1] = 0;
+  min_voltage = 4500;
+  qualify = 500;
+  brownout = 200;
+  hysteresis = 500;
+  dwell = 10000;
+  dead_time = 10;
+  interval = 250;
+  active = BQ25798_INPUT_NONE;
+  pending = BQ25798_INPUT_NONE;
+  verified = false;
+  lost = false;
+  running = false;
+  primed = false;
+  break_ms = 0;
+  make_ms = 0;
+  last_ms = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+/*!
+ * @brief  Start arbitrating. Checks both pairs are fitted, lets the chip
+ *         drive ACDRV, and enables the ADC in continuous mode for VAC1 and
+ *         VAC2 if it is not already running; if it is, both must be among
+ *         its channels. An input that is already on stays on until the
+ *         policy says otherwise.
+ * @param  policy How to choose between two qualified inputs
+ * @param  interval_ms Minimum time between samples
+ * @return True if successful, false if a pair is missing or on a bus error
+ */
+bool Adafruit_BQ25798_Arbiter::begin(bq25798_arbiter_policy_t policy,
+                                     uint16_t interval_ms) {
+  bq25798_status_t status;
+  if (!charger->getStatus(status) || !status.acrb1 || !status.acrb2) {
+    return false;
+  }
+  if (!charger->setACenable(true)) {
+    return false;
+  }
+  if (!charger->getADCEnable() &&
+      !charger->configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                             BQ25798_ADC_CH_VAC1 | BQ25798_ADC_CH_VAC2)) {
+    return false;
+  }
+
+  bool on1 = charger->getACDRV1enable();
+  bool on2 = charger->getACDRV2enable();
+  if (charger->getLastError() != BQ25798_OK) {
+    return false;
+  }
+  // Never carry on with both pairs on
+  if (on1 && on2 && !charger->setACDRV2enable(false)) {
+    return false;
+  }
+
+  setPolicy(policy);
+  interval = interval_ms;
+  active = on1   ? BQ25798_INPUT_VAC1
+           : on2 ? BQ25798_INPUT_VAC2
+                 : BQ25798_INPUT_NONE;
+  pending = BQ25798_INPUT_NONE;
+  verified = true;
+  lost = false;
+  primed = false;
+  // Let the policy act on the first sample rather than after a dwell
+  make_ms = millis() - dwell;
+  memset(&stats, 0, sizeof(stats));
+  running = true;
+  return true;
+}
+
+/*!
+ * @brief  Finish a switch in progress, or once per interval sample both
+ *         inputs and switch if the policy or a brownout calls for it.
+ *         Calls between intervals return without touching the bus.
+ * @return False before begin() or on a bus error
+ */
+bool Adafruit_BQ25798_Arbiter::update() {
+  if (!running) {
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (pending != BQ25798_INPUT_NONE) {
+    return finish(now);
+  }
+  if (primed && (uint32_t)(now - last_ms) < interval) {
+    return true;
+  }
+
+  static const bq25798_field_t fields[] = {BQ25798_FIELD_VAC1_ADC,
+                                           BQ25798_FIELD_VAC2_ADC};
+  int32_t values[2];
+  bq25798_status_t status;
+  if (!charger->getStatus(status) || !charger->getFields(fields, values, 2)) {
+    return false;
+  }
+  sample(0, status.ac1_present, values[0], now);
+  sample(1, status.ac2_present, values[1], now);
+  primed = true;
+  last_ms = now;
+  stats.samples++;
+  stats.vac1_mV = vac[0];
+  stats.vac2_mV = vac[1];
+
+  if (active != BQ25798_INPUT_NONE) {
+    uint8_t a = active - 1;
+    if (lost && eligible(a, now)) {
+      // Back for a full qualify time: try it again
+      lost = false;
+      make_ms = now;
+    }
+    if (!lost && !verified) {
+      if (status.power_good) {
+        verified = true;
+      } else if ((uint32_t)(now - make_ms) >= qualify) {
+        lost = true;
+        changed_ms[a] = now;
+        stats.failed++;
+      }
+    }
+    if (!lost && !valid[a] && (uint32_t)(now - changed_ms[a]) >= brownout) {
+      lost = true;
+      stats.brownouts++;
+    }
+  }
+
+  bq25798_input_t want = choose(now);
+  if (want == BQ25798_INPUT_NONE || want == active) {
+    return true;
+  }
+  // Only a lost input is given up before the dwell time is over
+  if (up() && (uint32_t)(now - make_ms) < dwell) {
+    return true;
+  }
+  return start(want, now);
+}
+
+/*!
+ * @brief  Switch input now, with the usual dead time, regardless of the
+ *         policy. update() is free to choose again afterwards.
+ * @param  input Input to use, or BQ25798_INPUT_NONE to turn both pairs off
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Arbiter::select(bq25798_input_t input) {
+  if (input > BQ25798_INPUT_VAC2) {
+    return false;
+  }
+  uint32_t now = millis();
+  if (input == BQ25798_INPUT_NONE) {
+    if (active != BQ25798_INPUT_NONE && !drive(active, false)) {
+      return false;
+    }
+    active = BQ25798_INPUT_NONE;
+    pending = BQ25798_INPUT_NONE;
+    return true;
+  }
+  if (input == active) {
+    return true;
+  }
+  return start(input, now);
+}
+
+/*!
+ * @brief  Set how to choose between two qualified inputs
+ * @param  policy Policy to use from the next sample
+ */
+void Adafruit_BQ25798_Arbiter::setPolicy(bq25798_arbiter_policy_t policy) {
+  if (policy <= BQ25798_ARBITER_CHEAPEST) {
+    this->policy = policy;
+  }
+}
+
+/*!
+ * @brief  Get the arbitration policy
+ * @return Current policy
+ */
+bq25798_arbiter_policy_t Adafruit_BQ25798_Arbiter::getPolicy() {
+  return policy;
+}
+
+/*!
+ * @brief  Set which input the solar panel is on, for PREFER_SOLAR
+ * @param  input BQ25798_INPUT_VAC1 or BQ25798_INPUT_VAC2 (the default)
+ */
+void Adafruit_BQ25798_Arbiter::setSolarInput(bq25798_input_t input) {
+  if (input == BQ25798_INPUT_VAC1 || input == BQ25798_INPUT_VAC2) {
+    solar = input;
+  }
+}
+
+/*!
+ * @brief  Set the cost of an input for CHEAPEST, in any unit as long as
+ *         both use the same one, e.g. cents per kWh. Both default to 0.
+ * @param  input BQ25798_INPUT_VAC1 or BQ25798_INPUT_VAC2
+ * @param  cost Cost of drawing from the input
+ */
+void Adafruit_BQ25798_Arbiter::setCost(bq25798_input_t input, uint16_t cost) {
+  if (input == BQ25798_INPUT_VAC1 || input == BQ25798_INPUT_VAC2) {
+    this->cost[input - 1] = cost;
+  }
+}
+
+/*!
+ * @brief  Set the lowest input voltage counted as usable
+ * @param  min_mV Threshold in mV, 4500 by default
+ */
+void Adafruit_BQ25798_Arbiter::setMinimum(uint16_t min_mV) {
+  min_voltage = min_mV;
+}
+
+/*!
+ * @brief  Set the debounce times
+ * @param  qualify_ms How long an input must be usable before it is
+ *         switched to, and how long power good may take to follow a switch;
+ *         500 by default
+ * @param  brownout_ms How long the active input must stay unusable before
+ *         it is given up; 200 by default
+ */
+void Adafruit_BQ25798_Arbiter::setDebounce(uint16_t qualify_ms,
+                                           uint16_t brownout_ms) {
+  qualify = qualify_ms;
+  brownout = brownout_ms;
+}
+
+/*!
+ * @brief  Set how much higher the other input must be before
+ *         HIGHER_VOLTAGE (or CHEAPEST, on a cost tie) moves to it
+ * @param  hysteresis_mV Margin in mV, 500 by default
+ */
+void Adafruit_BQ25798_Arbiter::setHysteresis(uint16_t hysteresis_mV) {
+  hysteresis = hysteresis_mV;
+}
+
+/*!
+ * @brief  Set the minimum time on an input before the policy may move off
+ *         it. A lost input is given up regardless.
+ * @param  dwell_ms Time in ms, 10000 by default
+ */
+void Adafruit_BQ25798_Arbiter::setDwell(uint32_t dwell_ms) {
+  dwell = dwell_ms;
+}
+
+/*!
+ * @brief  Set how long both pairs stay off between turning one off and the
+ *         other on. It must cover the FET turn-off time; the battery has to
+ *         carry the system load for this long.
+ * @param  dead_ms Time in ms, 10 by default
+ */
+void Adafruit_BQ25798_Arbiter::setDeadTime(uint16_t dead_ms) {
+  dead_time = dead_ms;
+}
+
+/*!
+ * @brief  Get the input whose pair is on
+ * @return Active input, BQ25798_INPUT_NONE while none is or during the dead
+ *         time of a switch
+ */
+bq25798_input_t Adafruit_BQ25798_Arbiter::getActive() {
+  return active;
+}
+
+/*!
+ * @brief  Copy out the arbitration statistics
+ * @param  stats Struct to fill
+ */
+void Adafruit_BQ25798_Arbiter::getStats(bq25798_arbiter_stats_t &stats) {
+  stats = this->stats;
+}
+
+/*!
+ * @brief  Record one input's reading and when its usability last changed
+ * @param  i 0 for VAC1, 1 for VAC2
+ * @param  present VACx_PRESENT_STAT
+ * @param  vac VACx_ADC reading in mV
+ * @param  now millis() of the reading
+ */
+void Adafruit_BQ25798_Arbiter::sample(uint8_t i, bool present, int32_t vac,
+                                      uint32_t now) {
+  this->vac[i] = vac;
+  bool usable = present && vac >= min_voltage;
+  if (!primed) {
+    // Whatever is there at begin() counts as settled
+    valid[i] = usable;
+    changed_ms[i] = now - qualify;
+    return;
+  }
+  if (usable == valid[i]) {
+    return;
+  }
+  if (usable && active == i + 1 && !lost &&
+      (uint32_t)(now - changed_ms[i]) < brownout) {
+    stats.dips++;
+  }
+  valid[i] = usable;
+  changed_ms[i] = now;
+}
+
+/*!
+ * @brief  Check whether an input may be switched to
+ * @param  i 0 for VAC1, 1 for VAC2
+ * @param  now Current millis()
+ * @return True if the input has been usable for the qualify time
+ */
+bool Adafruit_BQ25798_Arbiter::eligible(uint8_t i, uint32_t now) {
+  return valid[i] && (uint32_t)(now - changed_ms[i]) >= qualify;
+}
+
+/*!
+ * @brief  Check whether the active input is still in use, i.e. usable or
+ *         within the brownout debounce
+ * @return True if there is an active input and it has not been lost
+ */
+bool Adafruit_BQ25798_Arbiter::up() {
+  return active != BQ25798_INPUT_NONE && !lost;
+}
+
+/*!
+ * @brief  Apply the policy
+ * @param  now Current millis()
+ * @return Input to use, or BQ25798_INPUT_NONE if neither is usable
+ */
+bq25798_input_t Adafruit_BQ25798_Arbiter::choose(uint32_t now) {
+  bool ok[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    ok[i] = active == i + 1 ? up() : eligible(i, now);
+  }
+  if (!ok[0] && !ok[1]) {
+    return BQ25798_INPUT_NONE;
+  }
+  if (ok[0] != ok[1]) {
+    return ok[0] ? BQ25798_INPUT_VAC1 : BQ25798_INPUT_VAC2;
+  }
+
+  if (policy == BQ25798_ARBITER_PREFER_SOLAR) {
+    return solar;
+  }
+  if (policy == BQ25798_ARBITER_CHEAPEST && cost[0] != cost[1]) {
+    return cost[0] < cost[1] ? BQ25798_INPUT_VAC1 : BQ25798_INPUT_VAC2;
+  }
+
+  uint8_t hi = vac[1] > vac[0] ? 1 : 0;
+  if (active != BQ25798_INPUT_NONE && active != hi + 1 &&
+      vac[hi] <= (uint32_t)vac[active - 1] + hysteresis) {
+    return active;
+  }
+  return (bq25798_input_t)(hi + 1);
+}
+
+/*!
+ * @brief  Break: turn the active pair off and schedule the new one
+ * @param  input Input to switch to
+ * @param  now Current millis()
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Arbiter::start(bq25798_input_t input, uint32_t now) {
+  if (active != BQ25798_INPUT_NONE) {
+    if (!drive(active, false)) {
+      return false;
+    }
+    active = BQ25798_INPUT_NONE;
+    break_ms = now;
+  } else {
+    // Nothing to break, no need to wait
+    break_ms = now - dead_time;
+  }
+  pending = input;
+  return finish(now);
+}
+
+/*!
+ * @brief  Make: turn the pending pair on once the dead time has passed
+ * @param  now Current millis()
+ * @return True if successful or still waiting
+ */
+bool Adafruit_BQ25798_Arbiter::finish(uint32_t now) {
+  if ((uint32_t)(now - break_ms) < dead_time) {
+    return true;
+  }
+  if (!drive(pending, true)) {
+    return false;
+  }
+  active = pending;
+  pending = BQ25798_INPUT_NONE;
+  make_ms = now;
+  verified = false;
+  lost = false;
+  stats.switches++;
+  return true;
+}
+
+/*!
+ * @brief  Turn one pair on or off
+ * @param  input Pair to drive
+ * @param  on True to turn it on
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Arbiter::drive(bq25798_input_t input, bool on) {
+  return input == BQ25798_INPUT_VAC1 ? charger->setACDRV1enable(on)
+                                     : charger->setACDRV2enable(on);
+}
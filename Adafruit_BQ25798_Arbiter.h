@@ -0,0 +1,121 @@
+/*!
+ * @file Adafruit_BQ25798_Arbiter.h
+ *
+ * Dual-input source arbiter for the BQ25798: picks VAC1 or VAC2 under a
+ * policy and switches the ACFET-RBFET pairs without overlap.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_ARBITER_H__
+#define __ADAFRUIT_BQ25798_ARBITER_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Charger input behind an ACFET-RBFET pair
+ */
+typedef enum {
+  BQ25798_INPUT_NONE, ///< Both pairs off
+  BQ25798_INPUT_VAC1, ///< VAC1 through ACFET1-RBFET1 (ACDRV1)
+  BQ25798_INPUT_VAC2  ///< VAC2 through ACFET2-RBFET2 (ACDRV2)
+} bq25798_input_t;
+
+/*!
+ * @brief How to choose between two qualified inputs
+ */
+typedef enum {
+  BQ25798_ARBITER_PREFER_SOLAR,   ///< The solar input whenever it qualifies
+  BQ25798_ARBITER_HIGHER_VOLTAGE, ///< The input with the higher voltage
+  BQ25798_ARBITER_CHEAPEST        ///< The input with the lower cost, then
+                                  ///< the higher voltage
+} bq25798_arbiter_policy_t;
+
+/*!
+ * @brief Arbitration statistics, accumulated since begin()
+ */
+typedef struct {
+  uint32_t samples;   ///< Status and VAC readings taken
+  uint32_t switches;  ///< Inputs brought up
+  uint32_t brownouts; ///< Active input lost for longer than the debounce
+  uint32_t dips;      ///< Active input lost for less than the debounce
+  uint32_t failed;    ///< Switches after which power good never came
+  uint16_t vac1_mV;   ///< Latest VAC1 reading
+  uint16_t vac2_mV;   ///< Latest VAC2 reading
+} bq25798_arbiter_stats_t;
+
+/*!
+ * @brief Chooses between the two inputs of a dual-input board and drives
+ *        EN_ACDRV1/EN_ACDRV2. Needs both ACFET-RBFET pairs fitted.
+ *
+ *        An input qualifies once it has been present and above the minimum
+ *        voltage for the qualify time. The active input is only given up
+ *        after staying below that for the brownout time, so short dips do
+ *        not cause a switch, and a switch the policy merely prefers waits
+ *        for the dwell time. Switching turns the old pair off, waits the
+ *        dead time with both pairs off (the battery carries the system),
+ *        then turns the new pair on; if power good does not follow within
+ *        the qualify time the input is treated as lost.
+ *
+ *        Call update() from the main loop; it samples at most once per
+ *        interval and costs a status burst read and a VAC burst read.
+ */
+class Adafruit_BQ25798_Arbiter {
+public:
+  Adafruit_BQ25798_Arbiter(Adafruit_BQ25798 *charger);
+
+  bool begin(bq25798_arbiter_policy_t policy = BQ25798_ARBITER_HIGHER_VOLTAGE,
+             uint16_t interval_ms = 250);
+  bool update();
+  bool select(bq25798_input_t input);
+
+  void setPolicy(bq25798_arbiter_policy_t policy);
+  bq25798_arbiter_policy_t getPolicy();
+  void setSolarInput(bq25798_input_t input);
+  void setCost(bq25798_input_t input, uint16_t cost);
+  void setMinimum(uint16_t min_mV);
+  void setDebounce(uint16_t qualify_ms, uint16_t brownout_ms);
+  void setHysteresis(uint16_t hysteresis_mV);
+  void setDwell(uint32_t dwell_ms);
+  void setDeadTime(uint16_t dead_ms);
+
+  bq25798_input_t getActive();
+  void getStats(bq25798_arbiter_stats_t &stats);
+
+private:
+  void sample(uint8_t i, bool present, int32_t vac, uint32_t now);
+  bool eligible(uint8_t i, uint32_t now);
+  bool up();
+  bq25798_input_t choose(uint32_t now);
+  bool start(bq25798_input_t input, uint32_t now);
+  bool finish(uint32_t now);
+  bool drive(bq25798_input_t input, bool on);
+
+  Adafruit_BQ25798 *charger;       ///< Charger being arbitrated
+  bq25798_arbiter_policy_t policy; ///< How to choose
+  bq25798_input_t solar;           ///< Input the panel is on
+  uint16_t cost[2];                ///< Cost of VAC1 and VAC2
+  uint16_t vac[2];                 ///< Latest VAC1 and VAC2 in mV
+  bool valid[2];                   ///< Present and above the minimum
+  uint32_t changed_ms[2];          ///< millis() valid last changed
+  uint16_t min_voltage;            ///< Lowest usable input in mV
+  uint16_t qualify;                ///< Time valid before use, ms
+  uint16_t brownout;               ///< Time lost before giving up, ms
+  uint16_t hysteresis;             ///< HIGHER_VOLTAGE margin in mV
+  uint32_t dwell;                  ///< Minimum time between choices, ms
+  uint16_t dead_time;              ///< Both-off time when switching, ms
+  uint16_t interval;               ///< Minimum time between samples, ms
+  bq25798_input_t active;          ///< Input whose pair is on
+  bq25798_input_t pending;         ///< Input to turn on after dead time
+  bool verified;                   ///< Power good seen since make
+  bool lost;                       ///< Active input counted as lost
+  bool running;                    ///< True after begin()
+  bool primed;                     ///< True once a sample was taken
+  uint32_t break_ms;               ///< millis() the old pair went off
+  uint32_t make_ms;                ///< millis() the active pair came on
+  uint32_t last_ms;                ///< millis() of the latest sample
+  bq25798_arbiter_stats_t stats;   ///< Statistics
+};
+
+#endif // __ADAFRUIT_BQ25798_ARBITER_H__
@@ -0,0 +1,275 @@
+/*!
+ * @file Adafruit_BQ25798_Budget.cpp
+ *
+ * Input power budget manager for the BQ25798.
+ *
+ * With a fixed charge current, a shared adapter is pushed past its rating
+ * whenever the system load peaks while the battery charges, and the
+ * adapter folds back or browns out. IINDPM alone does not help much: once
+ * the input is limited the chip supplements the system from the battery,
+ * which is still being charged at the same time. Here the charge current
+ * follows the load instead, so the sum stays inside the budget.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Budget.h"
+
+#define BQ25798_BUDGET_LSB_MA 10       ///< ICHG and IINDPM resolution
+#define BQ25798_BUDGET_ICHG_MIN 50     ///< Lowest ICHG setting
+#define BQ25798_BUDGET_ICHG_MAX 5000   ///< Highest ICHG setting
+#define BQ25798_BUDGET_IINDPM_MIN 100  ///< Lowest IINDPM setting
+#define BQ25798_BUDGET_IINDPM_MAX 3300 ///< Highest IINDPM setting
+
+/*!
+ * @brief  Create a budget manager for a charger. Does not touch the bus.
+ * @param  charger Charger to manage, already started with begin()
+ */
+Adafruit_BQ25798_Budget::Adafruit_BQ25798_Budget(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  budget = 0;
+  headroom = 200;
+  min_charge = BQ25798_BUDGET_ICHG_MIN;
+  max_charge = 0;
+  input_max = 0;
+  slew = 200;
+  interval = 500;
+  charge_cap = 0;
+  input_cap = 0;
+  ichg = 0;
+  iindpm = 0;
+  running = false;
+  primed = false;
+  last_ms = 0;
+  resetStats();
+}
+
+/*!
+ * @brief  Start managing. The charge current and input limit set at this
+ *         point become the ceilings, unless setChargeRange() or
+ *         setInputMax() gave others. Enables the ADC in continuous mode
+ *         for IBUS, IBAT, VBUS and VSYS if it is not already running.
+ * @param  budget_mW Input power budget in mW
+ * @param  interval_ms Minimum time between updates
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Budget::begin(uint32_t budget_mW, uint16_t interval_ms) {
+  ichg = charger->getChargeLimit_mA();
+  iindpm = charger->getInputLimit_mA();
+  if (!ichg || !iindpm) {
+    return false;
+  }
+
+  if (!charger->getADCEnable() &&
+      !charger->configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                             BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_IBAT |
+                                 BQ25798_ADC_CH_VBUS | BQ25798_ADC_CH_VSYS)) {
+    return false;
+  }
+
+  budget = budget_mW;
+  interval = interval_ms;
+  charge_cap = max_charge ? max_charge : ichg;
+  input_cap = input_max ? input_max : iindpm;
+  primed = false;
+  running = true;
+  resetStats();
+  stats.ichg_mA = ichg;
+  stats.iindpm_mA = iindpm;
+  return true;
+}
+
+/*!
+ * @brief  Once per interval, measure the load and reallocate the charge
+ *         current and input limit. Calls between intervals return without
+ *         touching the bus.
+ * @return False before begin() or on a bus error
+ */
+bool Adafruit_BQ25798_Budget::update() {
+  if (!running) {
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (primed && (uint32_t)(now - last_ms) < interval) {
+    return true;
+  }
+
+  // Neighbours in 0x31-0x3E, so this is a single burst read
+  static const bq25798_field_t fields[] = {
+      BQ25798_FIELD_IBUS_ADC, BQ25798_FIELD_IBAT_ADC, BQ25798_FIELD_VBUS_ADC,
+      BQ25798_FIELD_VSYS_ADC};
+  int32_t values[4];
+  if (!charger->getFields(fields, values, 4)) {
+    return false;
+  }
+  primed = true;
+  last_ms = now;
+
+  int32_t ibus = values[0] > 0 ? values[0] : 0;
+  int32_t ibat = values[1];
+  int32_t vbus = values[2];
+  int32_t vsys = values[3];
+
+  int32_t input = vbus * ibus / 1000;
+  int32_t charge = vsys * ibat / 1000;
+  int32_t load = input > charge ? input - charge : 0;
+
+  stats.samples++;
+  stats.input_mW = input;
+  stats.load_mW = load;
+  stats.charge_mW = charge;
+  if ((uint32_t)input > stats.peak_mW) {
+    stats.peak_mW = input;
+  }
+  if ((uint32_t)input > budget) {
+    stats.over++;
+  }
+
+  // Charge current: what the load leaves of the budget, cut at once but
+  // raised at most one slew step per update
+  int32_t spare = (int32_t)budget - headroom - load;
+  uint32_t target = spare > 0 && vsys > 0 ? (uint32_t)spare * 1000 / vsys : 0;
+  if (target > (uint32_t)ichg + slew) {
+    target = ichg + slew;
+  }
+  if (target > charge_cap) {
+    target = charge_cap;
+  }
+  if (target < min_charge) {
+    target = min_charge;
+  }
+  bool ok = adjust(false, target);
+
+  // Input limit: the whole budget at the present VBUS, as a backstop for
+  // load steps between updates
+  if (vbus > 0) {
+    target = budget * 1000 / vbus;
+    if (target > input_cap) {
+      target = input_cap;
+    }
+    if (target < BQ25798_BUDGET_IINDPM_MIN) {
+      target = BQ25798_BUDGET_IINDPM_MIN;
+    }
+    ok = adjust(true, target) && ok;
+  }
+  return ok;
+}
+
+/*!
+ * @brief  Change the budget. Takes effect at the next update.
+ * @param  budget_mW Input power budget in mW
+ */
+void Adafruit_BQ25798_Budget::setBudget(uint32_t budget_mW) {
+  budget = budget_mW;
+}
+
+/*!
+ * @brief  Get the budget
+ * @return Input power budget in mW
+ */
+uint32_t Adafruit_BQ25798_Budget::getBudget() {
+  return budget;
+}
+
+/*!
+ * @brief  Set how much of the budget is kept back from charging to absorb
+ *         load steps between updates
+ * @param  headroom_mW Reserve in mW, 200 by default
+ */
+void Adafruit_BQ25798_Budget::setHeadroom(uint16_t headroom_mW) {
+  headroom = headroom_mW;
+}
+
+/*!
+ * @brief  Set the range the charge current is allocated in. When the load
+ *         takes the whole budget, charging carries on at the minimum.
+ * @param  min_mA Lowest charge current, at least 50
+ * @param  max_mA Highest charge current, 0 for the setting at begin()
+ */
+void Adafruit_BQ25798_Budget::setChargeRange(uint16_t min_mA,
+                                             uint16_t max_mA) {
+  if (min_mA < BQ25798_BUDGET_ICHG_MIN) {
+    min_mA = BQ25798_BUDGET_ICHG_MIN;
+  }
+  if (max_mA > BQ25798_BUDGET_ICHG_MAX) {
+    max_mA = BQ25798_BUDGET_ICHG_MAX;
+  }
+  min_charge = min_mA;
+  max_charge = max_mA;
+  if (running) {
+    charge_cap = max_charge ? max_charge : charge_cap;
+  }
+}
+
+/*!
+ * @brief  Set the adapter's current rating, the ceiling for IINDPM
+ * @param  max_mA Rating in mA, 0 for the setting at begin()
+ */
+void Adafruit_BQ25798_Budget::setInputMax(uint16_t max_mA) {
+  if (max_mA > BQ25798_BUDGET_IINDPM_MAX) {
+    max_mA = BQ25798_BUDGET_IINDPM_MAX;
+  }
+  input_max = max_mA;
+  if (running) {
+    input_cap = input_max ? input_max : input_cap;
+  }
+}
+
+/*!
+ * @brief  Set how far the charge current may rise per update. Raising it
+ *         gently gives the adapter time to follow; cuts are not limited.
+ * @param  step_mA Largest raise in mA, 200 by default
+ */
+void Adafruit_BQ25798_Budget::setSlew(uint16_t step_mA) {
+  slew = step_mA < BQ25798_BUDGET_LSB_MA ? BQ25798_BUDGET_LSB_MA : step_mA;
+}
+
+/*!
+ * @brief  Copy out the budget statistics
+ * @param  stats Struct to fill
+ */
+void Adafruit_BQ25798_Budget::getStats(bq25798_budget_stats_t &stats) {
+  stats = this->stats;
+}
+
+/*!
+ * @brief  Clear the counters and the peak
+ */
+void Adafruit_BQ25798_Budget::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+  stats.ichg_mA = ichg;
+  stats.iindpm_mA = iindpm;
+}
+
+/*!
+ * @brief  Write a new ICHG or IINDPM if it differs from the last one by
+ *         more than one LSB
+ * @param  input True for IINDPM, false for ICHG
+ * @param  target New setting in mA
+ * @return True if successful or nothing needed writing
+ */
+bool Adafruit_BQ25798_Budget::adjust(bool input, uint16_t target) {
+  uint16_t &setting = input ? iindpm : ichg;
+  target -= target % BQ25798_BUDGET_LSB_MA;
+
+  uint16_t change = target > setting ? target - setting : setting - target;
+  if (change <= BQ25798_BUDGET_LSB_MA) {
+    return true;
+  }
+
+  bool ok = input ? charger->setInputLimit_mA(target)
+                  : charger->setChargeLimit_mA(target);
+  if (!ok) {
+    return false;
+  }
+  setting = target;
+  stats.writes++;
+  if (input) {
+    stats.iindpm_mA = target;
+  } else {
+    stats.ichg_mA = target;
+  }
+  return true;
+}
@@ -0,0 +1,84 @@
+/*!
+ * @file Adafruit_BQ25798_Budget.h
+ *
+ * Input power budget manager for the BQ25798: splits a shared supply
+ * between the system load and battery charging.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_BUDGET_H__
+#define __ADAFRUIT_BQ25798_BUDGET_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Budget statistics, accumulated since begin() or resetStats()
+ */
+typedef struct {
+  uint32_t samples;   ///< ADC readings taken
+  uint32_t writes;    ///< ICHG and IINDPM writes made
+  uint32_t over;      ///< Readings with input power above the budget
+  uint32_t input_mW;  ///< Latest input power, VBUS * IBUS
+  uint32_t load_mW;   ///< Latest system load estimate
+  int32_t charge_mW;  ///< Latest battery power, VSYS * IBAT, < 0 when
+                      ///< the battery supplements the input
+  uint32_t peak_mW;   ///< Highest input power seen
+  uint16_t ichg_mA;   ///< Charge current allocated
+  uint16_t iindpm_mA; ///< Input current limit set
+} bq25798_budget_stats_t;
+
+/*!
+ * @brief Keeps the charger's input power under a budget by giving the
+ *        battery only what the system load leaves over.
+ *
+ *        Each update reads IBUS, IBAT, VBUS and VSYS in one burst. The
+ *        load is the input power minus the power going into the battery,
+ *        so it includes the converter losses; the charge current becomes
+ *        whatever is left of the budget, less a headroom, divided by VSYS.
+ *        Cuts apply at once, raises are limited to a slew per update, and
+ *        nothing is written unless the setting moves by more than one
+ *        10mA LSB. IINDPM is set to the budget at the present VBUS, capped
+ *        at the adapter rating, so the chip holds the line between
+ *        updates.
+ */
+class Adafruit_BQ25798_Budget {
+public:
+  Adafruit_BQ25798_Budget(Adafruit_BQ25798 *charger);
+
+  bool begin(uint32_t budget_mW, uint16_t interval_ms = 500);
+  bool update();
+
+  void setBudget(uint32_t budget_mW);
+  uint32_t getBudget();
+  void setHeadroom(uint16_t headroom_mW);
+  void setChargeRange(uint16_t min_mA, uint16_t max_mA);
+  void setInputMax(uint16_t max_mA);
+  void setSlew(uint16_t step_mA);
+
+  void getStats(bq25798_budget_stats_t &stats);
+  void resetStats();
+
+private:
+  bool adjust(bool input, uint16_t target);
+
+  Adafruit_BQ25798 *charger;    ///< Charger being managed
+  uint32_t budget;              ///< Input power budget in mW
+  uint16_t headroom;            ///< Budget kept back from charging, mW
+  uint16_t min_charge;          ///< Lowest charge current to allocate, mA
+  uint16_t max_charge;          ///< Highest charge current, 0 = at begin()
+  uint16_t input_max;           ///< IINDPM cap in mA, 0 = at begin()
+  uint16_t slew;                ///< Largest ICHG raise per update, mA
+  uint16_t interval;            ///< Minimum time between updates, ms
+  uint16_t charge_cap;          ///< Charge current ceiling in force, mA
+  uint16_t input_cap;           ///< IINDPM ceiling in force, mA
+  uint16_t ichg;                ///< ICHG last written, mA
+  uint16_t iindpm;              ///< IINDPM last written, mA
+  bool running;                 ///< True after begin()
+  bool primed;                  ///< True once a reading was taken
+  uint32_t last_ms;             ///< millis() of the latest reading
+  bq25798_budget_stats_t stats; ///< Statistics
+};
+
+#endif // __ADAFRUIT_BQ25798_BUDGET_H__
@@ -0,0 +1,216 @@
+/*!
+ * @file Adafruit_BQ25798_Energy.cpp
+ *
+ * Coulomb counter and energy accumulator for the BQ25798.
+ *
+ * Each pair of consecutive samples contributes the trapezoid
+ * (a + b) / 2 * dt. Integrating the straight line between samples rather
+ * than holding one value keeps the error second order in the sample
+ * interval, which is what lets the ADC be polled slowly.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Energy.h"
+
+#define BQ25798_ENERGY_PER_MICRO_HOUR 3600000ULL ///< mA*us per uAh, nJ per uWh
+
+/*!
+ * @brief  Add the trapezoid between two samples to a pair of one-sided
+ *         accumulators, splitting it where the line crosses zero
+ * @param  a Value at the start of the interval
+ * @param  b Value at the end of the interval
+ * @param  dt_us Interval length in us
+ * @param  div Divisor taking value*us to accumulator units
+ * @param  pos Accumulator for the area above zero
+ * @param  neg Accumulator for the area below zero, as a magnitude
+ */
+static void integrate(int32_t a, int32_t b, uint32_t dt_us, uint16_t div,
+                      uint64_t &pos, uint64_t &neg) {
+  if (a >= 0 && b >= 0) {
+    pos += ((uint64_t)a + b) * dt_us / 2 / div;
+  } else if (a <= 0 && b <= 0) {
+    neg += (uint64_t)(-(int64_t)a - b) * dt_us / 2 / div;
+  } else {
+    // The line crosses zero t0 into the interval, leaving two triangles
+    uint64_t mag_a = a < 0 ? -(int64_t)a : a;
+    uint64_t mag_b = b < 0 ? -(int64_t)b : b;
+    uint64_t t0 = dt_us * mag_a / (mag_a + mag_b);
+    uint64_t area_a = mag_a * t0 / 2 / div;
+    uint64_t area_b = mag_b * (dt_us - t0) / 2 / div;
+    if (a > 0) {
+      pos += area_a;
+      neg += area_b;
+    } else {
+      neg += area_a;
+      pos += area_b;
+    }
+  }
+}
+
+/*!
+ * @brief  Create an integrator with all totals at zero
+ * @param  charger Charger read by update(), or NULL to feed samples in by
+ *         hand with addSample()
+ */
+Adafruit_BQ25798_Energy::Adafruit_BQ25798_Energy(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  reset();
+}
+
+/*!
+ * @brief  Read IBUS, IBAT, VBUS and VBAT in one burst and integrate them.
+ *         The ADC must already be running, see
+ *         Adafruit_BQ25798::configureADC().
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Energy::update() {
+  bq25798_adc_fixed_t adc;
+
+  if (!charger || !charger->readAllADC(adc)) {
+    return false;
+  }
+
+  addSample(adc, micros());
+  return true;
+}
+
+/*!
+ * @brief  Integrate a sample streamed by Adafruit_BQ25798::poll(). Channels
+ *         missing from sample.channels count as 0, so stream at least IBAT
+ *         and VBAT, plus IBUS and VBUS for the input totals.
+ * @param  sample Timestamped ADC sample
+ */
+void Adafruit_BQ25798_Energy::addSample(const bq25798_adc_sample_t &sample) {
+  addSample(sample.adc, sample.timestamp_us);
+}
+
+/*!
+ * @brief  Integrate one ADC snapshot
+ * @param  adc Readings, only ibat, vbat, ibus and vbus are used
+ * @param  timestamp_us micros() at which the readings were taken
+ */
+void Adafruit_BQ25798_Energy::addSample(const bq25798_adc_fixed_t &adc,
+                                        uint32_t timestamp_us) {
+  // mV * mA = uW
+  int32_t pbat = (int32_t)adc.vbat * adc.ibat;
+  int32_t pbus = (int32_t)adc.vbus * adc.ibus;
+
+  if (primed) {
+    uint32_t dt = timestamp_us - last_us;
+    integrate(last_ibat, adc.ibat, dt, 1, bat_in_mAus, bat_out_mAus);
+    integrate(last_pbat, pbat, dt, 1000, bat_in_nJ, bat_out_nJ);
+    integrate(last_pbus, pbus, dt, 1000, bus_in_nJ, bus_out_nJ);
+    elapsed_us += dt;
+  }
+
+  primed = true;
+  last_us = timestamp_us;
+  last_ibat = adc.ibat;
+  last_pbat = pbat;
+  last_pbus = pbus;
+  samples++;
+}
+
+/*!
+ * @brief  Copy out the running totals in micro-amp-hours and
+ *         micro-watt-hours
+ * @param  totals Struct to fill
+ */
+void Adafruit_BQ25798_Energy::getTotals(bq25798_energy_totals_t &totals) {
+  totals.bat_in_uAh = bat_in_mAus / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.bat_out_uAh = bat_out_mAus / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.bat_in_uWh = bat_in_nJ / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.bat_out_uWh = bat_out_nJ / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.vbus_in_uWh = bus_in_nJ / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.vbus_out_uWh = bus_out_nJ / BQ25798_ENERGY_PER_MICRO_HOUR;
+  totals.elapsed_s = elapsed_us / 1000000;
+}
+
+/*!
+ * @brief  Net charge into the battery since reset(), the coulomb count
+ * @return Charge in minus charge out, in uAh
+ */
+int64_t Adafruit_BQ25798_Energy::getNetCharge_uAh() {
+  return ((int64_t)bat_in_mAus - (int64_t)bat_out_mAus) /
+         (int64_t)BQ25798_ENERGY_PER_MICRO_HOUR;
+}
+
+/*!
+ * @brief  Number of samples integrated since reset()
+ * @return Sample count
+ */
+uint32_t Adafruit_BQ25798_Energy::getSampleCount() {
+  return samples;
+}
+
+/*!
+ * @brief  Zero every total. The next sample starts a new interval.
+ */
+void Adafruit_BQ25798_Energy::reset() {
+  primed = false;
+  last_us = 0;
+  last_ibat = 0;
+  last_pbat = 0;
+  last_pbus = 0;
+  samples = 0;
+  bat_in_mAus = 0;
+  bat_out_mAus = 0;
+  bat_in_nJ = 0;
+  bat_out_nJ = 0;
+  bus_in_nJ = 0;
+  bus_out_nJ = 0;
+  elapsed_us = 0;
+}
+
+/*!
+ * @brief  Serialize the accumulators into a versioned, CRC-protected blob,
+ *         little endian so it reads back on any MCU, e.g. for EEPROM
+ * @param  buffer Destination, BQ25798_ENERGY_STATE_SIZE bytes
+ */
+void Adafruit_BQ25798_Energy::saveState(uint8_t *buffer) {
+  const uint64_t fields[] = {bat_in_mAus, bat_out_mAus, bat_in_nJ, bat_out_nJ,
+                             bus_in_nJ,   bus_out_nJ,   elapsed_us};
+
+  buffer[0] = BQ25798_ENERGY_VERSION;
+  for (uint8_t i = 0; i < 7; i++) {
+    for (uint8_t b = 0; b < 8; b++) {
+      buffer[1 + i * 8 + b] = fields[i] >> (b * 8);
+    }
+  }
+
+  uint16_t crc = Adafruit_BQ25798::crc16(buffer, BQ25798_ENERGY_STATE_SIZE - 2);
+  buffer[BQ25798_ENERGY_STATE_SIZE - 2] = crc >> 8;
+  buffer[BQ25798_ENERGY_STATE_SIZE - 1] = crc & 0xFF;
+}
+
+/*!
+ * @brief  Load accumulators saved by saveState(), e.g. after a reboot. The
+ *         time spent powered down is not integrated; the next sample
+ *         starts a new interval.
+ * @param  buffer Blob from saveState(), BQ25798_ENERGY_STATE_SIZE bytes
+ * @return True if successful, false if the blob is corrupt or from another
+ *         version (the totals are left alone)
+ */
+bool Adafruit_BQ25798_Energy::restoreState(const uint8_t *buffer) {
+  uint16_t crc = ((uint16_t)buffer[BQ25798_ENERGY_STATE_SIZE - 2] << 8) |
+                 buffer[BQ25798_ENERGY_STATE_SIZE - 1];
+  if (buffer[0] != BQ25798_ENERGY_VERSION ||
+      Adafruit_BQ25798::crc16(buffer, BQ25798_ENERGY_STATE_SIZE - 2) != crc) {
+    return false;
+  }
+
+  uint64_t *fields[] = {&bat_in_mAus, &bat_out_mAus, &bat_in_nJ, &bat_out_nJ,
+                        &bus_in_nJ,   &bus_out_nJ,   &elapsed_us};
+  for (uint8_t i = 0; i < 7; i++) {
+    uint64_t value = 0;
+    for (uint8_t b = 0; b < 8; b++) {
+      value |= (uint64_t)buffer[1 + i * 8 + b] << (b * 8);
+    }
+    *fields[i] = value;
+  }
+
+  primed = false;
+  return true;
+}
@@ -0,0 +1,79 @@
+/*!
+ * @file Adafruit_BQ25798_Energy.h
+ *
+ * Coulomb counter and energy accumulator for the BQ25798, integrating the
+ * IBAT/VBAT and IBUS/VBUS ADC readings over time.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_ENERGY_H__
+#define __ADAFRUIT_BQ25798_ENERGY_H__
+
+#include "Adafruit_BQ25798.h"
+
+#define BQ25798_ENERGY_VERSION 1 ///< saveState() blob format version
+#define BQ25798_ENERGY_STATE_SIZE                                              \
+  (1 + 7 * 8 + 2) ///< saveState() blob: version, accumulators, CRC16
+
+/*!
+ * @brief Running totals, see Adafruit_BQ25798_Energy::getTotals()
+ */
+typedef struct {
+  uint64_t bat_in_uAh;   ///< Charge into the battery
+  uint64_t bat_out_uAh;  ///< Charge drawn from the battery
+  uint64_t bat_in_uWh;   ///< Energy into the battery
+  uint64_t bat_out_uWh;  ///< Energy drawn from the battery
+  uint64_t vbus_in_uWh;  ///< Energy taken from the input
+  uint64_t vbus_out_uWh; ///< Energy sourced onto VBUS in OTG mode
+  uint32_t elapsed_s;    ///< Time covered by the totals
+} bq25798_energy_totals_t;
+
+/*!
+ * @brief Integrates battery charge and battery/input energy from ADC
+ *        samples using the trapezoidal rule over each sample's real
+ *        timestamp. Intervals in which the current changes direction are
+ *        split at the interpolated zero crossing, so charge in and charge
+ *        out are counted separately rather than cancelling.
+ *
+ *        Accumulators are 64-bit fixed point: charge in mA*us and energy in
+ *        nJ, good for decades at the chip's full current and power.
+ *        Samples must be less than 71 minutes apart (micros() wraps).
+ */
+class Adafruit_BQ25798_Energy {
+public:
+  Adafruit_BQ25798_Energy(Adafruit_BQ25798 *charger = NULL);
+
+  bool update();
+  void addSample(const bq25798_adc_sample_t &sample);
+  void addSample(const bq25798_adc_fixed_t &adc, uint32_t timestamp_us);
+
+  void getTotals(bq25798_energy_totals_t &totals);
+  int64_t getNetCharge_uAh();
+  uint32_t getSampleCount();
+  void reset();
+
+  void saveState(uint8_t *buffer);
+  bool restoreState(const uint8_t *buffer);
+
+private:
+  Adafruit_BQ25798 *charger; ///< Source for update(), may be NULL
+
+  bool primed;       ///< True once a previous sample exists
+  uint32_t last_us;  ///< Timestamp of the previous sample
+  int16_t last_ibat; ///< Previous IBAT in mA
+  int32_t last_pbat; ///< Previous battery power in uW
+  int32_t last_pbus; ///< Previous input power in uW
+  uint32_t samples;  ///< Samples taken since reset()
+
+  uint64_t bat_in_mAus;  ///< Charge in, mA*us
+  uint64_t bat_out_mAus; ///< Charge out, mA*us
+  uint64_t bat_in_nJ;    ///< Battery energy in, nJ
+  uint64_t bat_out_nJ;   ///< Battery energy out, nJ
+  uint64_t bus_in_nJ;    ///< Input energy in, nJ
+  uint64_t bus_out_nJ;   ///< OTG energy out, nJ
+  uint64_t elapsed_us;   ///< Time integrated over, us
+};
+
+#endif // __ADAFRUIT_BQ25798_ENERGY_H__
@@ -0,0 +1,255 @@
+/*!
+ * @file Adafruit_BQ25798_JEITA.cpp
+ *
+ * Temperature-banded charge profile for the BQ25798.
+ *
+ * The chip's JEITA support only has fixed cool and warm derating steps
+ * between the TS thresholds. Cells that want more bands, or a lower
+ * voltage when cold, are handled here by reading TS_ADC, converting it to
+ * a temperature and rewriting ICHG and VREG whenever the band changes.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_JEITA.h"
+
+/*!
+ * @brief  Create a profile driver for a charger. Does not touch the bus.
+ * @param  charger Charger to drive, already started with begin()
+ */
+Adafruit_BQ25798_JEITA::Adafruit_BQ25798_JEITA(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  bands = NULL;
+  count = 0;
+  hysteresis = 20;
+  interval = 1000;
+  band = BQ25798_JEITA_NONE;
+  temperature = 0;
+  primed = false;
+  last_ms = 0;
+  changes = 0;
+}
+
+/*!
+ * @brief  Start following a profile. Enables the ADC in continuous mode for
+ *         TS if it is not already running; if it is, TS must be one of its
+ *         channels. Nothing is written until the first reading.
+ * @param  bands Profile, ordered by rising max_dC. Must stay valid while in
+ *         use.
+ * @param  count Number of bands, 1 to BQ25798_JEITA_MAX_BANDS
+ * @param  hysteresis_dC How far past an edge the temperature must be before
+ *         moving to a band with a higher current or voltage, in 0.1C
+ * @param  interval_ms Minimum time between TS readings
+ * @return True if successful, false for a bad profile or a bus error
+ */
+bool Adafruit_BQ25798_JEITA::begin(const bq25798_jeita_band_t *bands,
+                                   uint8_t count, uint16_t hysteresis_dC,
+                                   uint16_t interval_ms) {
+  if (!bands || !count || count > BQ25798_JEITA_MAX_BANDS) {
+    return false;
+  }
+  for (uint8_t i = 1; i < count; i++) {
+    if (bands[i].max_dC <= bands[i - 1].max_dC) {
+      return false;
+    }
+  }
+
+  if (!charger->getADCEnable() &&
+      !charger->configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                             BQ25798_ADC_CH_TS)) {
+    return false;
+  }
+
+  this->bands = bands;
+  this->count = count;
+  hysteresis = hysteresis_dC;
+  interval = interval_ms;
+  band = BQ25798_JEITA_NONE;
+  primed = false;
+  changes = 0;
+  return true;
+}
+
+/*!
+ * @brief  Read TS once per interval and apply the matching band. Calls
+ *         between intervals return without touching the bus.
+ * @return False before begin(), if the read or a write failed, or if TS
+ *         has no conversion yet (reads as 0)
+ */
+bool Adafruit_BQ25798_JEITA::update() {
+  if (!count) {
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (primed && (uint32_t)(now - last_ms) < interval) {
+    return true;
+  }
+
+  int32_t raw;
+  if (!charger->getField(BQ25798_FIELD_TS_ADC, raw)) {
+    return false;
+  }
+  // A TS pin at GND would be a shorted thermistor, which the chip's own
+  // TS_HOT comparator already handles; 0 here means no conversion yet
+  if (raw <= 0) {
+    return false;
+  }
+  primed = true;
+  last_ms = now;
+
+  uint16_t ts = ((uint32_t)raw * 625 + 32) / 64;
+  return apply(ntc.toTemperature(ts));
+}
+
+/*!
+ * @brief  Apply the band for a temperature, e.g. one measured elsewhere.
+ *         update() calls this with the TS reading.
+ * @param  temperature_dC Battery temperature in 0.1 degrees C
+ * @return True if successful or nothing needed writing
+ */
+bool Adafruit_BQ25798_JEITA::apply(int16_t temperature_dC) {
+  if (!count) {
+    return false;
+  }
+  temperature = temperature_dC;
+
+  int8_t want = target(temperature_dC);
+  if (want == band) {
+    return true;
+  }
+
+  if (band != BQ25798_JEITA_NONE && !harsher(want, band)) {
+    // Relaxing: wait until the edge next to the current band is cleared
+    if (want > band) {
+      if (temperature_dC <= bands[band].max_dC + (int16_t)hysteresis) {
+        return true;
+      }
+    } else if (temperature_dC > bands[want].max_dC - (int16_t)hysteresis) {
+      return true;
+    }
+  }
+
+  return write(want);
+}
+
+/*!
+ * @brief  Get the band in force
+ * @return Index into the profile, the band count when above the last band
+ *         (charging stopped), or BQ25798_JEITA_NONE before the first
+ *         reading
+ */
+int8_t Adafruit_BQ25798_JEITA::getBand() {
+  return band;
+}
+
+/*!
+ * @brief  Get the latest temperature
+ * @return Temperature in 0.1 degrees C
+ */
+int16_t Adafruit_BQ25798_JEITA::getTemperature() {
+  return temperature;
+}
+
+/*!
+ * @brief  Get how many band changes were written since begin()
+ * @return Number of changes, including the first band applied
+ */
+uint32_t Adafruit_BQ25798_JEITA::getChanges() {
+  return changes;
+}
+
+/*!
+ * @brief  Get the thermistor converter, to give it the board's table or
+ *         beta model
+ * @return Converter used by update()
+ */
+Adafruit_BQ25798_NTC &Adafruit_BQ25798_JEITA::getNTC() {
+  return ntc;
+}
+
+/*!
+ * @brief  Find the band a temperature falls in, ignoring hysteresis
+ * @param  temperature Temperature in 0.1 degrees C
+ * @return Band index, or count above the last band
+ */
+int8_t Adafruit_BQ25798_JEITA::target(int16_t temperature) {
+  uint8_t i = 0;
+  while (i < count && temperature > bands[i].max_dC) {
+    i++;
+  }
+  return i;
+}
+
+/*!
+ * @brief  Charge current in a band
+ * @param  band Band index, or count for the cutoff
+ * @return Current in mA, 0 if charging is stopped
+ */
+uint16_t Adafruit_BQ25798_JEITA::current(int8_t band) {
+  return band < count ? bands[band].current_mA : 0;
+}
+
+/*!
+ * @brief  Charge voltage in a band
+ * @param  band Band index, or count for the cutoff
+ * @return Voltage in mV, 0 if charging is stopped
+ */
+uint16_t Adafruit_BQ25798_JEITA::voltage(int8_t band) {
+  return current(band) ? bands[band].voltage_mV : 0;
+}
+
+/*!
+ * @brief  Check whether one band charges more gently than another
+ * @param  a Band to check
+ * @param  b Band to compare against
+ * @return True if a has a lower current, or the same current and a lower
+ *         voltage
+ */
+bool Adafruit_BQ25798_JEITA::harsher(int8_t a, int8_t b) {
+  if (current(a) != current(b)) {
+    return current(a) < current(b);
+  }
+  return voltage(a) < voltage(b);
+}
+
+/*!
+ * @brief  Write the settings that differ between the band in force and a
+ *         new one. The band only changes once every write went through, so
+ *         a failed write is retried by the next reading.
+ * @param  band Band to switch to
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_JEITA::write(int8_t band) {
+  bool first = this->band == BQ25798_JEITA_NONE;
+  uint16_t was = first ? 0 : current(this->band);
+  uint16_t milliamps = current(band);
+
+  if (!milliamps) {
+    if (!charger->setChargeEnable(false)) {
+      return false;
+    }
+  } else {
+    // Write a lower current before the voltage and a higher one after it,
+    // so the setting in between never charges harder than both bands
+    bool volts = first || voltage(band) != voltage(this->band);
+    bool amps = first || milliamps != was;
+    if (amps && milliamps < was && !charger->setChargeLimit_mA(milliamps)) {
+      return false;
+    }
+    if (volts && !charger->setChargeLimit_mV(voltage(band))) {
+      return false;
+    }
+    if (amps && milliamps >= was && !charger->setChargeLimit_mA(milliamps)) {
+      return false;
+    }
+    if (!was && !charger->setChargeEnable(true)) {
+      return false;
+    }
+  }
+
+  this->band = band;
+  changes++;
+  return true;
+}
@@ -0,0 +1,81 @@
+/*!
+ * @file Adafruit_BQ25798_JEITA.h
+ *
+ * Temperature-banded charge profile for the BQ25798: picks the charge
+ * current and voltage from the battery temperature measured on TS.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_JEITA_H__
+#define __ADAFRUIT_BQ25798_JEITA_H__
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_NTC.h"
+
+#define BQ25798_JEITA_MAX_BANDS 16 ///< Most bands a profile may have
+#define BQ25798_JEITA_NONE -1      ///< getBand() before the first reading
+
+/*!
+ * @brief One temperature band of a charge profile. A band runs from the
+ *        previous band's max_dC (or from the coldest reading, for the
+ *        first band) up to and including its own.
+ */
+typedef struct {
+  int16_t max_dC;      ///< Upper edge of the band in 0.1 degrees C
+  uint16_t current_mA; ///< Charge current in the band, 0 to stop charging
+  uint16_t voltage_mV; ///< Charge voltage in the band
+} bq25798_jeita_band_t;
+
+/*!
+ * @brief Drives the charge current and voltage from a table of
+ *        temperature bands, like the chip's own JEITA cool/warm derating
+ *        but with as many bands and whatever limits the cell needs.
+ *        Above the last band charging is stopped.
+ *
+ *        Moving into a band with a lower current or voltage happens as
+ *        soon as its edge is crossed; moving back out needs the
+ *        temperature to clear the edge by the hysteresis, so a cell
+ *        sitting on an edge does not toggle. Registers are only written
+ *        on a band change, and then only the settings that differ.
+ *
+ *        The chip's own TS thresholds stay in force on top of the
+ *        profile.
+ */
+class Adafruit_BQ25798_JEITA {
+public:
+  Adafruit_BQ25798_JEITA(Adafruit_BQ25798 *charger);
+
+  bool begin(const bq25798_jeita_band_t *bands, uint8_t count,
+             uint16_t hysteresis_dC = 20, uint16_t interval_ms = 1000);
+
+  bool update();
+  bool apply(int16_t temperature_dC);
+
+  int8_t getBand();
+  int16_t getTemperature();
+  uint32_t getChanges();
+  Adafruit_BQ25798_NTC &getNTC();
+
+private:
+  int8_t target(int16_t temperature);
+  uint16_t current(int8_t band);
+  uint16_t voltage(int8_t band);
+  bool harsher(int8_t a, int8_t b);
+  bool write(int8_t band);
+
+  Adafruit_BQ25798 *charger;         ///< Charger being controlled
+  Adafruit_BQ25798_NTC ntc;          ///< TS to temperature conversion
+  const bq25798_jeita_band_t *bands; ///< Profile, caller owned
+  uint8_t count;                     ///< Bands in the profile
+  uint16_t hysteresis;               ///< Edge clearance to relax, 0.1C
+  uint16_t interval;                 ///< Minimum time between readings, ms
+  int8_t band;                       ///< Band in force, or NONE
+  int16_t temperature;               ///< Latest temperature in 0.1C
+  bool primed;                       ///< True once a reading was taken
+  uint32_t last_ms;                  ///< millis() of the latest reading
+  uint32_t changes;                  ///< Band changes written
+};
+
+#endif // __ADAFRUIT_BQ25798_JEITA_H__
@@ -0,0 +1,224 @@
+/*!
+ * @file Adafruit_BQ25798_LinuxI2C.cpp
+ *
+ * Linux i2c-dev transport for the Adafruit BQ25798 driver.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_LinuxI2C.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/*!
+ * @brief  Create a transport for one BQ25798 on an i2c-dev bus
+ * @param  device Path of the i2c-dev node, e.g. "/dev/i2c-1"
+ * @param  i2c_addr The I2C address to be used
+ */
+Adafruit_BQ25798_LinuxI2C::Adafruit_BQ25798_LinuxI2C(const char *device,
+                                                     uint8_t i2c_addr) {
+  this->device = device;
+  addr = i2c_addr;
+  fd = -1;
+  last_errno = 0;
+  pending = false;
+  stopping = false;
+  pending_write = false;
+  pending_reg = 0;
+  pending_len = 0;
+  pending_buffer = NULL;
+}
+
+/*!
+ * @brief  Stop the worker, after any transfer it is running, and close the
+ *         bus
+ */
+Adafruit_BQ25798_LinuxI2C::~Adafruit_BQ25798_LinuxI2C() {
+  if (worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+/*!
+ * @brief  Open the i2c-dev node
+ * @return True if the bus could be opened
+ */
+bool Adafruit_BQ25798_LinuxI2C::begin() {
+  if (fd >= 0) {
+    close(fd);
+  }
+
+  fd = open(device, O_RDWR);
+  if (fd < 0) {
+    last_errno = errno;
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Burst read as one combined write/repeated-start/read transaction
+ * @param  reg First register address
+ * @param  buffer Destination for the register contents
+ * @param  len Number of registers to read
+ * @return True if the transaction was acknowledged
+ */
+bool Adafruit_BQ25798_LinuxI2C::readRegisters(uint8_t reg, uint8_t *buffer,
+                                              uint8_t len) {
+  struct i2c_msg msgs[2];
+  msgs[0].addr = addr;
+  msgs[0].flags = 0;
+  msgs[0].len = 1;
+  msgs[0].buf = &reg;
+  msgs[1].addr = addr;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = len;
+  msgs[1].buf = buffer;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = msgs;
+  xfer.nmsgs = 2;
+
+  if (ioctl(fd, I2C_RDWR, &xfer) < 0) {
+    last_errno = errno;
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Burst write as a single message: register address then data
+ * @param  reg First register address
+ * @param  buffer Register contents to write
+ * @param  len Number of registers to write
+ * @return True if the transaction was acknowledged
+ */
+bool Adafruit_BQ25798_LinuxI2C::writeRegisters(uint8_t reg,
+                                               const uint8_t *buffer,
+                                               uint8_t len) {
+  uint8_t out[1 + 255];
+  out[0] = reg;
+  memcpy(out + 1, buffer, len);
+
+  struct i2c_msg msg;
+  msg.addr = addr;
+  msg.flags = 0;
+  msg.len = len + 1;
+  msg.buf = out;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = &msg;
+  xfer.nmsgs = 1;
+
+  if (ioctl(fd, I2C_RDWR, &xfer) < 0) {
+    last_errno = errno;
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Hand a burst read to the worker thread and return at once. The
+ *         driver polls transferStatus() for the result.
+ * @param  reg First register address
+ * @param  buffer Destination, must stay valid until the transfer ends
+ * @param  len Number of registers to read
+ * @return True if the transfer was started
+ */
+bool Adafruit_BQ25798_LinuxI2C::startRead(uint8_t reg, uint8_t *buffer,
+                                          uint8_t len) {
+  return post(false, reg, buffer, len);
+}
+
+/*!
+ * @brief  Hand a burst write to the worker thread and return at once
+ * @param  reg First register address
+ * @param  buffer Register contents, must stay valid until the transfer
+ *         ends
+ * @param  len Number of registers to write
+ * @return True if the transfer was started
+ */
+bool Adafruit_BQ25798_LinuxI2C::startWrite(uint8_t reg, const uint8_t *buffer,
+                                           uint8_t len) {
+  return post(true, reg, (uint8_t *)buffer, len);
+}
+
+/*!
+ * @brief  Post a transfer to the worker, starting it if needed
+ * @param  write True for a write
+ * @param  reg First register address
+ * @param  buffer Caller buffer
+ * @param  len Number of registers
+ * @return True if posted, false if the bus is not open or a transfer is
+ *         already in flight
+ */
+bool Adafruit_BQ25798_LinuxI2C::post(bool write, uint8_t reg, uint8_t *buffer,
+                                     uint8_t len) {
+  if (fd < 0 || transferStatus() == BQ25798_XFER_BUSY) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    pending = true;
+    pending_write = write;
+    pending_reg = reg;
+    pending_len = len;
+    pending_buffer = buffer;
+    xfer_status = BQ25798_XFER_BUSY;
+  }
+  if (!worker.joinable()) {
+    worker = std::thread(&Adafruit_BQ25798_LinuxI2C::run, this);
+  }
+  wake.notify_one();
+  return true;
+}
+
+/*!
+ * @brief  Worker thread: run posted transfers until told to stop
+ */
+void Adafruit_BQ25798_LinuxI2C::run() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    wake.wait(guard, [this] { return pending || stopping; });
+    if (stopping) {
+      return;
+    }
+    pending = false;
+    bool write = pending_write;
+    uint8_t reg = pending_reg;
+    uint8_t len = pending_len;
+    uint8_t *buffer = pending_buffer;
+
+    guard.unlock();
+    finishTransfer(write ? writeRegisters(reg, buffer, len)
+                         : readRegisters(reg, buffer, len));
+    guard.lock();
+  }
+}
+
+/*!
+ * @brief  Get the errno of the most recent failure
+ * @return errno value, or 0 if nothing has failed yet
+ */
+int Adafruit_BQ25798_LinuxI2C::lastErrno() {
+  return last_errno;
+}
+
+#endif // __linux__ && !ARDUINO
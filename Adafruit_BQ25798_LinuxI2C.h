@@ -0,0 +1,70 @@
+/*!
+ * @file Adafruit_BQ25798_LinuxI2C.h
+ *
+ * Linux i2c-dev transport for the Adafruit BQ25798 driver, for running the
+ * same API on Raspberry Pi class boards.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_LINUXI2C_H__
+#define __ADAFRUIT_BQ25798_LINUXI2C_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Register transport over /dev/i2c-N. Every read is a single
+ *        I2C_RDWR ioctl (address write + repeated-start read), and every
+ *        burst write goes out as one message, so a multi-register access
+ *        costs exactly one syscall.
+ *
+ *        Transfers from the driver's async queue run on a worker thread,
+ *        started on first use, so tick() returns while the ioctl is still
+ *        on the bus.
+ */
+class Adafruit_BQ25798_LinuxI2C : public Adafruit_BQ25798_Transport {
+public:
+  Adafruit_BQ25798_LinuxI2C(const char *device = "/dev/i2c-1",
+                            uint8_t i2c_addr = BQ25798_DEFAULT_ADDR);
+  ~Adafruit_BQ25798_LinuxI2C();
+
+  bool begin();
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len);
+
+  bool startRead(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool startWrite(uint8_t reg, const uint8_t *buffer, uint8_t len);
+
+  int lastErrno();
+
+private:
+  bool post(bool write, uint8_t reg, uint8_t *buffer, uint8_t len);
+  void run();
+
+  const char *device; ///< Path of the i2c-dev node
+  uint8_t addr;       ///< 7-bit device address
+  int fd;             ///< Open file descriptor, or -1
+  std::atomic<int> last_errno; ///< errno of the last failure, or 0
+
+  std::thread worker;           ///< Runs async transfers, started lazily
+  std::mutex lock;              ///< Guards the fields below
+  std::condition_variable wake; ///< Signals a posted transfer or shutdown
+  bool pending;                 ///< A transfer is waiting for the worker
+  bool stopping;                ///< Worker should exit
+  bool pending_write;           ///< Direction of the posted transfer
+  uint8_t pending_reg;          ///< First register of the posted transfer
+  uint8_t pending_len;          ///< Length of the posted transfer
+  uint8_t *pending_buffer;      ///< Caller buffer of the posted transfer
+};
+
+#endif // __linux__ && !ARDUINO
+
+#endif // __ADAFRUIT_BQ25798_LINUXI2C_H__
@@ -0,0 +1,329 @@
+/*!
+ * @file Adafruit_BQ25798_MPPT.cpp
+ *
+ * Host-side maximum power point tracker for the BQ25798.
+ *
+ * The charger pulls as much input current as VINDPM allows, so lowering
+ * VINDPM moves a panel's operating point toward its short-circuit current
+ * and raising it moves toward open circuit. Each update reads VBUS and IBUS,
+ * decides which way the power curve slopes and moves VINDPM one step.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_MPPT.h"
+
+#define BQ25798_VINDPM_MIN_MV 3600  ///< Lowest VINDPM setting
+#define BQ25798_VINDPM_MAX_MV 22000 ///< Highest VINDPM setting
+#define BQ25798_VINDPM_LSB_MV 100   ///< VINDPM resolution
+
+/*!
+ * @brief  Create a tracker for a charger. Does not touch the bus.
+ * @param  charger Charger to track, already started with begin()
+ */
+Adafruit_BQ25798_MPPT::Adafruit_BQ25798_MPPT(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  mode = BQ25798_MPPT_PERTURB_OBSERVE;
+  step = BQ25798_VINDPM_LSB_MV;
+  interval = 500;
+  deadband = 10;
+  min_vindpm = BQ25798_VINDPM_MIN_MV;
+  max_vindpm = BQ25798_VINDPM_MAX_MV;
+  vindpm = 0;
+  direction = 1;
+  hw_mppt = false;
+  primed = false;
+  last_ms = 0;
+  last_vbus = 0;
+  last_ibus = 0;
+  last_power = 0;
+  resetStats();
+}
+
+/*!
+ * @brief  Start tracking from the current VINDPM setting. Enables the ADC in
+ *         continuous mode for VBUS and IBUS if it is not already running.
+ * @param  mode Tracking algorithm
+ * @param  step_mV VINDPM step per update, rounded to 100mV
+ * @param  interval_ms Minimum time between updates; leave enough for the
+ *         converter to settle and the ADC to convert both channels
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MPPT::begin(bq25798_mppt_mode_t mode, uint16_t step_mV,
+                                  uint16_t interval_ms) {
+  setStep(step_mV);
+  setInterval(interval_ms);
+
+  hw_mppt = charger->getMPPTenable();
+  vindpm = charger->getInputLimit_mV();
+  if (!vindpm) {
+    return false;
+  }
+
+  if (!charger->getADCEnable() &&
+      !charger->configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                             BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_VBUS)) {
+    return false;
+  }
+
+  primed = false;
+  direction = 1;
+  resetStats();
+  return setMode(mode);
+}
+
+/*!
+ * @brief  Stop tracking and give EN_MPPT back the state it had at begin().
+ *         VINDPM is left at the last setpoint.
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MPPT::end() {
+  primed = false;
+  return charger->setMPPTenable(hw_mppt);
+}
+
+/*!
+ * @brief  Switch algorithm. The chip's VOC tracker rewrites VINDPM on its
+ *         own, so it is turned off for the host algorithms and on for
+ *         BQ25798_MPPT_VOC.
+ * @param  mode Tracking algorithm
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MPPT::setMode(bq25798_mppt_mode_t mode) {
+  if (mode > BQ25798_MPPT_VOC) {
+    return false;
+  }
+  if (!charger->setMPPTenable(mode == BQ25798_MPPT_VOC)) {
+    return false;
+  }
+  this->mode = mode;
+  return true;
+}
+
+/*!
+ * @brief  Get the tracking algorithm
+ * @return Current mode
+ */
+bq25798_mppt_mode_t Adafruit_BQ25798_MPPT::getMode() {
+  return mode;
+}
+
+/*!
+ * @brief  Set the VINDPM step taken per update. Larger steps find the MPP
+ *         faster but oscillate further around it.
+ * @param  step_mV Step in mV, rounded to the 100mV register resolution
+ */
+void Adafruit_BQ25798_MPPT::setStep(uint16_t step_mV) {
+  step = (step_mV + BQ25798_VINDPM_LSB_MV / 2) / BQ25798_VINDPM_LSB_MV *
+         BQ25798_VINDPM_LSB_MV;
+  if (!step) {
+    step = BQ25798_VINDPM_LSB_MV;
+  }
+}
+
+/*!
+ * @brief  Get the VINDPM step
+ * @return Step in mV
+ */
+uint16_t Adafruit_BQ25798_MPPT::getStep() {
+  return step;
+}
+
+/*!
+ * @brief  Set the minimum time between updates
+ * @param  interval_ms Interval in ms
+ */
+void Adafruit_BQ25798_MPPT::setInterval(uint16_t interval_ms) {
+  interval = interval_ms;
+}
+
+/*!
+ * @brief  Get the minimum time between updates
+ * @return Interval in ms
+ */
+uint16_t Adafruit_BQ25798_MPPT::getInterval() {
+  return interval;
+}
+
+/*!
+ * @brief  Set how large a power change must be to count. Keeps ADC noise
+ *         from flipping the search direction.
+ * @param  deadband_mW Power change in mW below which the curve is treated
+ *         as flat
+ */
+void Adafruit_BQ25798_MPPT::setDeadband(uint16_t deadband_mW) {
+  deadband = deadband_mW;
+}
+
+/*!
+ * @brief  Restrict the VINDPM range the tracker may use, e.g. to stay above
+ *         the panel's knee or below its open-circuit voltage
+ * @param  min_mV Lowest setpoint, at least 3600mV
+ * @param  max_mV Highest setpoint, at most 22000mV
+ */
+void Adafruit_BQ25798_MPPT::setLimits(uint16_t min_mV, uint16_t max_mV) {
+  if (min_mV < BQ25798_VINDPM_MIN_MV) {
+    min_mV = BQ25798_VINDPM_MIN_MV;
+  }
+  if (max_mV > BQ25798_VINDPM_MAX_MV) {
+    max_mV = BQ25798_VINDPM_MAX_MV;
+  }
+  if (max_mV < min_mV) {
+    max_mV = min_mV;
+  }
+  min_vindpm = min_mV;
+  max_vindpm = max_mV;
+}
+
+/*!
+ * @brief  Sample the input and, once per interval, move VINDPM one step
+ *         toward the maximum power point. Call it often; calls between
+ *         intervals return without touching the bus.
+ * @return False if a bus transaction failed, true otherwise
+ */
+bool Adafruit_BQ25798_MPPT::update() {
+  uint32_t now = millis();
+  if (primed && (uint32_t)(now - last_ms) < interval) {
+    return true;
+  }
+
+  uint16_t vbus;
+  int16_t ibus;
+  if (!sample(vbus, ibus, vindpm)) {
+    return false;
+  }
+
+  // Reverse current (OTG, backfeed) harvests nothing
+  uint16_t current = ibus > 0 ? ibus : 0;
+  uint32_t power = ((uint32_t)vbus * current + 500) / 1000;
+
+  stats.samples++;
+  stats.vbus_mV = vbus;
+  stats.ibus_mA = ibus;
+  stats.power_mW = power;
+  if (power > stats.peak_mW) {
+    stats.peak_mW = power;
+  }
+  if (primed) {
+    // mW * ms = uJ, trapezoid between the two samples
+    uint32_t dt = now - last_ms;
+    stats.energy_uJ += (uint64_t)(power + last_power) * dt / 2;
+    stats.elapsed_ms += dt;
+  }
+
+  if (mode != BQ25798_MPPT_VOC) {
+    int8_t dir = decide(vbus, current, power);
+    if (dir && dir != direction) {
+      stats.reversals++;
+      direction = dir;
+    }
+
+    int32_t target = (int32_t)vindpm + dir * step;
+    if (target < min_vindpm || target > max_vindpm) {
+      target = target < min_vindpm ? min_vindpm : max_vindpm;
+      if (mode == BQ25798_MPPT_PERTURB_OBSERVE) {
+        // Pinned at a limit, come back on the next step
+        direction = -direction;
+        stats.reversals++;
+      }
+    }
+    if (target != vindpm) {
+      if (!charger->setInputLimit_mV(target)) {
+        return false;
+      }
+      vindpm = target;
+      stats.steps++;
+    }
+  }
+  stats.vindpm_mV = vindpm;
+
+  last_ms = now;
+  last_vbus = vbus;
+  last_ibus = current;
+  last_power = power;
+  primed = true;
+  return true;
+}
+
+/*!
+ * @brief  Copy out the harvest statistics. Average input power is
+ *         energy_uJ / elapsed_ms in mW.
+ * @param  stats Struct to fill
+ */
+void Adafruit_BQ25798_MPPT::getStats(bq25798_mppt_stats_t &stats) {
+  stats = this->stats;
+}
+
+/*!
+ * @brief  Zero the harvest statistics. The tracker keeps its position and
+ *         the energy integral carries on from the last sample.
+ */
+void Adafruit_BQ25798_MPPT::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+  stats.vindpm_mV = vindpm;
+}
+
+/*!
+ * @brief  Read VBUS and IBUS in one burst. In BQ25798_MPPT_VOC mode the
+ *         chip owns VINDPM, so it is read back too.
+ * @param  vbus VBUS in mV
+ * @param  ibus IBUS in mA, negative when current flows out of VBUS
+ * @param  setpoint Updated with VINDPM in mV when the chip owns it
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MPPT::sample(uint16_t &vbus, int16_t &ibus,
+                                   uint16_t &setpoint) {
+  static const bq25798_field_t fields[] = {BQ25798_FIELD_VBUS_ADC,
+                                           BQ25798_FIELD_IBUS_ADC,
+                                           BQ25798_FIELD_VINDPM};
+  int32_t values[3];
+  uint8_t count = mode == BQ25798_MPPT_VOC ? 3 : 2;
+
+  if (!charger->getFields(fields, values, count)) {
+    return false;
+  }
+  vbus = values[0];
+  ibus = values[1];
+  if (count == 3) {
+    setpoint = values[2];
+  }
+  return true;
+}
+
+/*!
+ * @brief  Pick the next step direction
+ * @param  vbus VBUS in mV
+ * @param  ibus IBUS in mA, not negative
+ * @param  power Input power in mW
+ * @return +1 to raise VINDPM, -1 to lower it, 0 to hold
+ */
+int8_t Adafruit_BQ25798_MPPT::decide(uint16_t vbus, uint16_t ibus,
+                                     uint32_t power) {
+  if (!primed) {
+    return direction; // first perturbation, nothing to compare with yet
+  }
+
+  if (mode == BQ25798_MPPT_PERTURB_OBSERVE) {
+    // Keep stepping the same way unless the last step lost power
+    if ((int32_t)(power - last_power) < -(int32_t)deadband) {
+      return -direction;
+    }
+    return direction;
+  }
+
+  // Incremental conductance: dP/dV = I + V * dI/dV. Multiplying through by
+  // dV gives I * dV + V * dI in uW, whose sign flips with dV's.
+  int32_t dv = (int32_t)vbus - last_vbus;
+  int32_t di = (int32_t)ibus - last_ibus;
+  int32_t slope = (int32_t)ibus * dv + (int32_t)vbus * di;
+
+  if (slope <= (int32_t)deadband * 1000 &&
+      slope >= -(int32_t)deadband * 1000) {
+    return 0; // at the MPP
+  }
+  if (dv < 0) {
+    slope = -slope;
+  }
+  return slope > 0 ? 1 : -1;
+}
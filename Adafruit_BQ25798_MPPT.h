@@ -0,0 +1,96 @@
+/*!
+ * @file Adafruit_BQ25798_MPPT.h
+ *
+ * Host-side maximum power point tracker for solar panels on the BQ25798
+ * input. Steps VINDPM from VBUS/IBUS ADC readings.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_MPPT_H__
+#define __ADAFRUIT_BQ25798_MPPT_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Tracking algorithm
+ */
+typedef enum {
+  BQ25798_MPPT_PERTURB_OBSERVE, ///< Step, keep going while power rises
+  BQ25798_MPPT_INC_CONDUCTANCE, ///< Step toward dI/dV = -I/V, hold at MPP
+  BQ25798_MPPT_VOC              ///< Leave the chip's fractional VOC tracker
+                                ///< in charge and only collect statistics
+} bq25798_mppt_mode_t;
+
+/*!
+ * @brief Harvest statistics, accumulated since begin() or resetStats()
+ */
+typedef struct {
+  uint32_t samples;    ///< VBUS/IBUS readings taken
+  uint32_t steps;      ///< VINDPM changes written
+  uint32_t reversals;  ///< Times the search direction flipped
+  uint16_t vbus_mV;    ///< Latest VBUS reading
+  int16_t ibus_mA;     ///< Latest IBUS reading
+  uint16_t vindpm_mV;  ///< Current VINDPM setpoint
+  uint32_t power_mW;   ///< Latest input power
+  uint32_t peak_mW;    ///< Highest input power seen
+  uint32_t elapsed_ms; ///< Time covered by energy_uJ
+  uint64_t energy_uJ;  ///< Input energy, trapezoidal integral of VBUS*IBUS
+} bq25798_mppt_stats_t;
+
+/*!
+ * @brief Perturb-and-observe / incremental-conductance MPPT driving the
+ *        BQ25798 VINDPM setpoint. Tracking only has an effect while the
+ *        panel limits the input, i.e. the charger sits in VINDPM
+ *        regulation.
+ *
+ *        Call update() from the main loop; it samples and steps at most
+ *        once per interval and costs one ADC burst read plus, when the
+ *        setpoint moves, one register write.
+ */
+class Adafruit_BQ25798_MPPT {
+public:
+  Adafruit_BQ25798_MPPT(Adafruit_BQ25798 *charger);
+
+  bool begin(bq25798_mppt_mode_t mode = BQ25798_MPPT_PERTURB_OBSERVE,
+             uint16_t step_mV = 100, uint16_t interval_ms = 500);
+  bool end();
+
+  bool setMode(bq25798_mppt_mode_t mode);
+  bq25798_mppt_mode_t getMode();
+  void setStep(uint16_t step_mV);
+  uint16_t getStep();
+  void setInterval(uint16_t interval_ms);
+  uint16_t getInterval();
+  void setDeadband(uint16_t deadband_mW);
+  void setLimits(uint16_t min_mV, uint16_t max_mV);
+
+  bool update();
+
+  void getStats(bq25798_mppt_stats_t &stats);
+  void resetStats();
+
+private:
+  bool sample(uint16_t &vbus, int16_t &ibus, uint16_t &setpoint);
+  int8_t decide(uint16_t vbus, uint16_t ibus, uint32_t power);
+
+  Adafruit_BQ25798 *charger;  ///< Charger being tracked
+  bq25798_mppt_mode_t mode;   ///< Tracking algorithm
+  uint16_t step;              ///< VINDPM step in mV, a multiple of 100
+  uint16_t interval;          ///< Minimum time between updates in ms
+  uint16_t deadband;          ///< Power change treated as no change, in mW
+  uint16_t min_vindpm;        ///< Lowest VINDPM the tracker may set, in mV
+  uint16_t max_vindpm;        ///< Highest VINDPM the tracker may set, in mV
+  uint16_t vindpm;            ///< Current setpoint in mV
+  int8_t direction;           ///< +1 raising VINDPM, -1 lowering it
+  bool hw_mppt;               ///< EN_MPPT state to restore in end()
+  bool primed;                ///< True once a previous sample exists
+  uint32_t last_ms;           ///< millis() of the previous sample
+  uint16_t last_vbus;         ///< Previous VBUS in mV
+  uint16_t last_ibus;         ///< Previous IBUS in mA, clamped at 0
+  uint32_t last_power;        ///< Previous input power in mW
+  bq25798_mppt_stats_t stats; ///< Harvest statistics
+};
+
+#endif // __ADAFRUIT_BQ25798_MPPT_H__
@@ -0,0 +1,385 @@
+/*!
+ * @file Adafruit_BQ25798_Multi.cpp
+ *
+ * Manager for several BQ25798 chargers behind TCA9548A muxes and on
+ * separate buses.
+ *
+ * A TCA9548A has a single control register and takes it as the first (and
+ * only) byte of a write, which is exactly what a register transport sends
+ * for a zero-length writeRegisters(): the channel mask goes out as the
+ * "register address".
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Multi.h"
+
+static_assert(BQ25798_MULTI_MAX <= 16, "unit masks are 16 bits wide");
+
+#define BQ25798_MUX_UNKNOWN 0xFF ///< Mux mask not known, must be rewritten
+
+/*!
+ * @brief Destinations for the readings taken by poll()
+ */
+typedef struct {
+  bq25798_status_t *status; ///< Status per unit, or NULL
+  bq25798_adc_fixed_t *adc; ///< ADC readings per unit, or NULL
+} bq25798_multi_poll_t;
+
+/*!
+ * @brief  forEach() operation behind poll(): status and ADC bursts read
+ *         back to back while the unit's channel is open
+ * @param  charger The unit
+ * @param  unit Its index
+ * @param  context bq25798_multi_poll_t with the destinations
+ * @return True if both reads succeeded
+ */
+static bool pollUnit(Adafruit_BQ25798 &charger, uint8_t unit, void *context) {
+  bq25798_multi_poll_t *dest = (bq25798_multi_poll_t *)context;
+
+  if (dest->status && !charger.getStatus(dest->status[unit])) {
+    return false;
+  }
+  if (dest->adc && !charger.readAllADC(dest->adc[unit])) {
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Create an unattached port; the manager wires it up
+ */
+Adafruit_BQ25798_MultiPort::Adafruit_BQ25798_MultiPort() {
+  owner = NULL;
+  unit = 0;
+}
+
+/*!
+ * @brief  Open the unit's channel and bring up the shared bus transport
+ * @return True if the charger acknowledged
+ */
+bool Adafruit_BQ25798_MultiPort::begin() {
+  return owner && owner->select(unit) && owner->units[unit].bus->begin();
+}
+
+/*!
+ * @brief  Read registers from this unit, switching channels if needed
+ * @param  reg First register address
+ * @param  buffer Destination for the register contents
+ * @param  len Number of registers to read
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MultiPort::readRegisters(uint8_t reg, uint8_t *buffer,
+                                               uint8_t len) {
+  return owner && owner->select(unit) &&
+         owner->units[unit].bus->readRegisters(reg, buffer, len);
+}
+
+/*!
+ * @brief  Write registers on this unit, switching channels if needed
+ * @param  reg First register address
+ * @param  buffer Register contents to write
+ * @param  len Number of registers to write
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_MultiPort::writeRegisters(uint8_t reg,
+                                                const uint8_t *buffer,
+                                                uint8_t len) {
+  return owner && owner->select(unit) &&
+         owner->units[unit].bus->writeRegisters(reg, buffer, len);
+}
+
+/*!
+ * @brief  Recover the shared bus. The muxes on it may have seen garbage, so
+ *         their channels are rewritten on the next access.
+ * @return True if a recovery was carried out
+ */
+bool Adafruit_BQ25798_MultiPort::recoverBus() {
+  if (!owner) {
+    return false;
+  }
+  Adafruit_BQ25798_Transport *bus = owner->units[unit].bus;
+  bool ok = bus->recoverBus();
+  owner->invalidate(bus);
+  return ok;
+}
+
+/*!
+ * @brief  Create an empty manager
+ */
+Adafruit_BQ25798_Multi::Adafruit_BQ25798_Multi() {
+  count = 0;
+  mux_count = 0;
+  present = 0;
+  switches = 0;
+  reverse = false;
+}
+
+/*!
+ * @brief  Register a TCA9548A
+ * @param  control Transport at the mux's own address (0x70-0x77)
+ * @param  bus Transport at the charger address on the same bus, shared by
+ *         every unit behind this mux
+ * @return Mux index for addCharger(), or -1 if full
+ */
+int8_t Adafruit_BQ25798_Multi::addMux(Adafruit_BQ25798_Transport *control,
+                                      Adafruit_BQ25798_Transport *bus) {
+  if (mux_count >= BQ25798_MULTI_MAX_MUX || !control || !bus) {
+    return -1;
+  }
+  muxes[mux_count].control = control;
+  muxes[mux_count].bus = bus;
+  muxes[mux_count].mask = BQ25798_MUX_UNKNOWN;
+  return mux_count++;
+}
+
+/*!
+ * @brief  Add a charger wired straight to a bus. Any muxes on the same bus
+ *         are closed while it is in use.
+ * @param  bus Transport at the charger address
+ * @return Unit index, or -1 if full
+ */
+int8_t Adafruit_BQ25798_Multi::addCharger(Adafruit_BQ25798_Transport *bus) {
+  return add(bus, BQ25798_MUX_DIRECT, 0);
+}
+
+/*!
+ * @brief  Add a charger behind a mux channel
+ * @param  mux Index returned by addMux()
+ * @param  channel Mux channel, 0-7
+ * @return Unit index, or -1 if full or the arguments are out of range
+ */
+int8_t Adafruit_BQ25798_Multi::addCharger(uint8_t mux, uint8_t channel) {
+  if (mux >= mux_count || channel > 7) {
+    return -1;
+  }
+  return add(muxes[mux].bus, mux, channel);
+}
+
+/*!
+ * @brief  Bring up every mux and charger, in channel order
+ * @return Mask of the units found (bit n for unit n)
+ */
+uint16_t Adafruit_BQ25798_Multi::begin() {
+  for (uint8_t m = 0; m < mux_count; m++) {
+    muxes[m].control->begin();
+    muxes[m].mask = BQ25798_MUX_UNKNOWN;
+  }
+
+  present = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t unit = order[i];
+    if (chargers[unit].begin(&ports[unit])) {
+      present |= 1 << unit;
+    }
+  }
+  return present;
+}
+
+/*!
+ * @brief  Get the number of units added
+ * @return Unit count
+ */
+uint8_t Adafruit_BQ25798_Multi::getCount() {
+  return count;
+}
+
+/*!
+ * @brief  Get a unit's driver. Calls on it switch channels as needed, so it
+ *         can be used like a standalone charger.
+ * @param  unit Unit index
+ * @return The driver, or NULL if unit is out of range
+ */
+Adafruit_BQ25798 *Adafruit_BQ25798_Multi::getCharger(uint8_t unit) {
+  return unit < count ? &chargers[unit] : NULL;
+}
+
+/*!
+ * @brief  Get the units found by begin()
+ * @return Mask with bit n set if unit n answered
+ */
+uint16_t Adafruit_BQ25798_Multi::getPresent() {
+  return present;
+}
+
+/*!
+ * @brief  Get the number of mux control writes made so far, the overhead
+ *         the manager adds on top of the chargers' own traffic
+ * @return Mux write count
+ */
+uint32_t Adafruit_BQ25798_Multi::getSwitchCount() {
+  return switches;
+}
+
+/*!
+ * @brief  Run an operation on every unit found by begin(), one channel
+ *         switch per unit
+ * @param  fn Operation to run
+ * @param  context Passed through to fn
+ * @return Mask of the units on which fn returned true
+ */
+uint16_t Adafruit_BQ25798_Multi::forEach(bq25798_unit_fn_t fn, void *context) {
+  uint16_t ok = 0;
+
+  // Walk back the way we came every other sweep: the first unit visited is
+  // the one left selected by the previous sweep, saving a switch
+  bool backward = reverse;
+  reverse = !reverse;
+
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t unit = order[backward ? count - 1 - i : i];
+    if (!(present & (1 << unit)) || !select(unit)) {
+      continue;
+    }
+    if (fn(chargers[unit], unit, context)) {
+      ok |= 1 << unit;
+    }
+  }
+  return ok;
+}
+
+/*!
+ * @brief  Read the status and flag registers of every unit
+ * @param  status Array indexed by unit, getCount() entries
+ * @return Mask of the units read successfully
+ */
+uint16_t Adafruit_BQ25798_Multi::pollStatus(bq25798_status_t *status) {
+  return poll(status, NULL);
+}
+
+/*!
+ * @brief  Read every ADC channel of every unit
+ * @param  adc Array indexed by unit, getCount() entries
+ * @return Mask of the units read successfully
+ */
+uint16_t Adafruit_BQ25798_Multi::pollADC(bq25798_adc_fixed_t *adc) {
+  return poll(NULL, adc);
+}
+
+/*!
+ * @brief  Read status and ADC of every unit in a single sweep, both bursts
+ *         taken while the unit's channel is open
+ * @param  status Array indexed by unit, or NULL to skip status
+ * @param  adc Array indexed by unit, or NULL to skip the ADC
+ * @return Mask of the units read successfully
+ */
+uint16_t Adafruit_BQ25798_Multi::poll(bq25798_status_t *status,
+                                      bq25798_adc_fixed_t *adc) {
+  bq25798_multi_poll_t dest = {status, adc};
+  return forEach(pollUnit, &dest);
+}
+
+/*!
+ * @brief  Open the path to a unit: its mux channel on, every other mux on
+ *         the same bus off. Muxes already in the right state are not
+ *         written.
+ * @param  unit Unit index
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Multi::select(uint8_t unit) {
+  if (unit >= count) {
+    return false;
+  }
+
+  const bq25798_multi_unit_t &u = units[unit];
+  for (uint8_t m = 0; m < mux_count; m++) {
+    if (muxes[m].bus != u.bus) {
+      continue;
+    }
+    uint8_t mask = m == u.mux ? 1 << u.channel : 0;
+    if (muxes[m].mask != mask && !setMask(m, mask)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * @brief  Close every mux channel, e.g. before handing the buses to other
+ *         devices that share an address with the chargers
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Multi::deselectAll() {
+  bool ok = true;
+  for (uint8_t m = 0; m < mux_count; m++) {
+    if (muxes[m].mask && !setMask(m, 0)) {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+/*!
+ * @brief  Record a unit and slot it into the channel ordering
+ * @param  bus Transport at the charger address
+ * @param  mux Mux index, or BQ25798_MUX_DIRECT
+ * @param  channel Mux channel
+ * @return Unit index, or -1 if full
+ */
+int8_t Adafruit_BQ25798_Multi::add(Adafruit_BQ25798_Transport *bus,
+                                   uint8_t mux, uint8_t channel) {
+  if (count >= BQ25798_MULTI_MAX || !bus) {
+    return -1;
+  }
+
+  uint8_t unit = count++;
+  units[unit].bus = bus;
+  units[unit].mux = mux;
+  units[unit].channel = channel;
+  ports[unit].owner = this;
+  ports[unit].unit = unit;
+
+  // Keep order[] grouped by bus, then mux, then channel
+  uint16_t key = sortKey(unit);
+  uint8_t i = unit;
+  while (i > 0 && sortKey(order[i - 1]) > key) {
+    order[i] = order[i - 1];
+    i--;
+  }
+  order[i] = unit;
+  return unit;
+}
+
+/*!
+ * @brief  Ordering key for a unit: buses in the order first seen, then mux
+ *         (direct units last), then channel
+ * @param  unit Unit index
+ * @return Key, lower sorts first
+ */
+uint16_t Adafruit_BQ25798_Multi::sortKey(uint8_t unit) {
+  uint8_t bus = 0;
+  while (units[bus].bus != units[unit].bus) {
+    bus++;
+  }
+  return (uint16_t)bus << 11 | (uint16_t)units[unit].mux << 3 |
+         units[unit].channel;
+}
+
+/*!
+ * @brief  Write a mux's channel mask
+ * @param  mux Mux index
+ * @param  mask Channels to open, 0 for none
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Multi::setMask(uint8_t mux, uint8_t mask) {
+  switches++;
+  if (!muxes[mux].control->writeRegisters(mask, NULL, 0)) {
+    muxes[mux].mask = BQ25798_MUX_UNKNOWN;
+    return false;
+  }
+  muxes[mux].mask = mask;
+  return true;
+}
+
+/*!
+ * @brief  Forget the state of every mux on a bus
+ * @param  bus Charger transport of the bus
+ */
+void Adafruit_BQ25798_Multi::invalidate(Adafruit_BQ25798_Transport *bus) {
+  for (uint8_t m = 0; m < mux_count; m++) {
+    if (muxes[m].bus == bus) {
+      muxes[m].mask = BQ25798_MUX_UNKNOWN;
+    }
+  }
+}
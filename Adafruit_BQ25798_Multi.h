@@ -0,0 +1,129 @@
+/*!
+ * @file Adafruit_BQ25798_Multi.h
+ *
+ * Manager for several BQ25798 chargers sharing the fixed 0x6B address,
+ * spread over TCA9548A mux channels and separate I2C buses.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_MULTI_H__
+#define __ADAFRUIT_BQ25798_MULTI_H__
+
+#include "Adafruit_BQ25798.h"
+
+#ifndef BQ25798_MULTI_MAX
+#define BQ25798_MULTI_MAX 8 ///< Chargers one manager can hold, at most 16
+#endif
+#ifndef BQ25798_MULTI_MAX_MUX
+#define BQ25798_MULTI_MAX_MUX 4 ///< Muxes one manager can drive
+#endif
+
+#define BQ25798_MUX_DIRECT 0xFF ///< addCharger() mux for a unit on its bus
+
+/*!
+ * @brief Operation run on each unit by Adafruit_BQ25798_Multi::forEach()
+ */
+typedef bool (*bq25798_unit_fn_t)(
+    Adafruit_BQ25798 &charger, ///< The unit, already selected
+    uint8_t unit,              ///< Index returned by addCharger()
+    void *context);            ///< Pointer passed to forEach()
+
+/*!
+ * @brief Where a managed unit sits
+ */
+typedef struct {
+  Adafruit_BQ25798_Transport *bus; ///< Transport at 0x6B on its bus
+  uint8_t mux;                     ///< Mux index, or BQ25798_MUX_DIRECT
+  uint8_t channel;                 ///< Mux channel, 0-7
+} bq25798_multi_unit_t;
+
+/*!
+ * @brief One TCA9548A and the bus it sits on
+ */
+typedef struct {
+  Adafruit_BQ25798_Transport *control; ///< Transport at the mux address
+  Adafruit_BQ25798_Transport *bus;     ///< Charger transport on that bus
+  uint8_t mask;                        ///< Channels open, 0xFF if unknown
+} bq25798_multi_mux_t;
+
+class Adafruit_BQ25798_Multi;
+
+/*!
+ * @brief Per-unit transport handed to each managed charger. Opens the
+ *        unit's mux channel (closing any other path to 0x6B on the same
+ *        bus) before passing the transfer on to the shared bus transport.
+ */
+class Adafruit_BQ25798_MultiPort : public Adafruit_BQ25798_Transport {
+public:
+  Adafruit_BQ25798_MultiPort();
+
+  bool begin();
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len);
+  bool recoverBus();
+
+private:
+  friend class Adafruit_BQ25798_Multi;
+
+  Adafruit_BQ25798_Multi *owner; ///< Manager doing the channel switching
+  uint8_t unit;                  ///< Index of the unit this port serves
+};
+
+/*!
+ * @brief Owns up to BQ25798_MULTI_MAX chargers and switches TCA9548A
+ *        channels for them. A mux only gets written when the open channel
+ *        has to change, so every transaction a unit makes while it is
+ *        selected costs the same as on a lone charger.
+ *
+ *        The batch operations visit units sorted by bus, mux and channel,
+ *        alternating direction between sweeps, so polling N units takes N
+ *        channel switches per sweep rather than one per register access.
+ *        Nothing is heap allocated; transports are created by the caller.
+ */
+class Adafruit_BQ25798_Multi {
+public:
+  Adafruit_BQ25798_Multi();
+
+  int8_t addMux(Adafruit_BQ25798_Transport *control,
+                Adafruit_BQ25798_Transport *bus);
+  int8_t addCharger(Adafruit_BQ25798_Transport *bus);
+  int8_t addCharger(uint8_t mux, uint8_t channel);
+
+  uint16_t begin();
+
+  uint8_t getCount();
+  Adafruit_BQ25798 *getCharger(uint8_t unit);
+  uint16_t getPresent();
+  uint32_t getSwitchCount();
+
+  uint16_t forEach(bq25798_unit_fn_t fn, void *context = NULL);
+  uint16_t pollStatus(bq25798_status_t *status);
+  uint16_t pollADC(bq25798_adc_fixed_t *adc);
+  uint16_t poll(bq25798_status_t *status, bq25798_adc_fixed_t *adc);
+
+  bool select(uint8_t unit);
+  bool deselectAll();
+
+private:
+  friend class Adafruit_BQ25798_MultiPort;
+
+  int8_t add(Adafruit_BQ25798_Transport *bus, uint8_t mux, uint8_t channel);
+  uint16_t sortKey(uint8_t unit);
+  bool setMask(uint8_t mux, uint8_t mask);
+  void invalidate(Adafruit_BQ25798_Transport *bus);
+
+  Adafruit_BQ25798 chargers[BQ25798_MULTI_MAX];        ///< The units
+  Adafruit_BQ25798_MultiPort ports[BQ25798_MULTI_MAX]; ///< Their transports
+  bq25798_multi_unit_t units[BQ25798_MULTI_MAX];       ///< Their locations
+  uint8_t order[BQ25798_MULTI_MAX];                    ///< Units by channel
+  bq25798_multi_mux_t muxes[BQ25798_MULTI_MAX_MUX];    ///< The muxes
+  uint8_t count;                                       ///< Units added
+  uint8_t mux_count;                                   ///< Muxes added
+  uint16_t present;                                    ///< Units found
+  uint32_t switches;                                   ///< Mux writes made
+  bool reverse;                                        ///< Next sweep order
+};
+
+#endif // __ADAFRUIT_BQ25798_MULTI_H__
@@ -0,0 +1,152 @@
+/*!
+ * @file Adafruit_BQ25798_NTC.cpp
+ *
+ * Thermistor conversion for the BQ25798 TS pin.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_NTC.h"
+
+#ifndef BQ25798_NO_FLOAT
+#include <math.h>
+#endif
+
+/*! TS in 0.01% of REGN for -40C..100C in 5C steps, datasheet network */
+static const uint16_t default_table[] PROGMEM = {
+    8375, 8322, 8254, 8168, 8061, 7932, 7776, 7591, 7378, 7134,
+    6861, 6561, 6237, 5893, 5535, 5169, 4801, 4437, 4081, 3738,
+    3412, 3105, 2819, 2555, 2312, 2091, 1889, 1707, 1543};
+
+/*!
+ * @brief  Create a converter using the default table
+ */
+Adafruit_BQ25798_NTC::Adafruit_BQ25798_NTC() {
+#ifndef BQ25798_NO_FLOAT
+  r25 = 0;
+  beta = 0;
+  rt1 = 0;
+  rt2 = 0;
+#endif
+  setTable(default_table, sizeof(default_table) / sizeof(default_table[0]),
+           -400, 50);
+}
+
+/*!
+ * @brief  Use a different TS-vs-temperature table
+ * @param  table TS readings in 0.01% of REGN, in PROGMEM, one per
+ *         temperature point and strictly falling. Must stay valid while in
+ *         use.
+ * @param  points Number of entries, at least 2
+ * @param  first_dC Temperature of table[0] in 0.1 degrees C
+ * @param  step_dC Temperature between consecutive entries in 0.1 degrees C
+ */
+void Adafruit_BQ25798_NTC::setTable(const uint16_t *table, uint8_t points,
+                                    int16_t first_dC, uint8_t step_dC) {
+  this->table = table;
+  this->points = points;
+  first = first_dC;
+  step = step_dC;
+#ifndef BQ25798_NO_FLOAT
+  beta = 0;
+#endif
+}
+
+#ifndef BQ25798_NO_FLOAT
+/*!
+ * @brief  Convert with the beta model instead of a table, for networks
+ *         without one. Costs a logarithm per conversion.
+ * @param  r25 NTC resistance at 25C in ohms
+ * @param  beta NTC beta constant in K, e.g. 3435 or 3950
+ * @param  rt1 Resistor from REGN to TS in ohms
+ * @param  rt2 Resistor from TS to GND, across the NTC, in ohms; 0 if the
+ *         board has none
+ */
+void Adafruit_BQ25798_NTC::setBeta(uint32_t r25, uint16_t beta, uint32_t rt1,
+                                   uint32_t rt2) {
+  this->r25 = r25;
+  this->beta = beta;
+  this->rt1 = rt1;
+  this->rt2 = rt2;
+}
+#endif
+
+/*!
+ * @brief  Convert a TS reading to temperature. Readings beyond either end
+ *         of the table clamp to that end (-40C or 125C with the beta
+ *         model), so an open or shorted thermistor reads as the coldest or
+ *         hottest point.
+ * @param  ts TS voltage in 0.01% of REGN
+ * @return Temperature in 0.1 degrees C
+ */
+int16_t Adafruit_BQ25798_NTC::toTemperature(uint16_t ts) {
+#ifndef BQ25798_NO_FLOAT
+  if (beta) {
+    return betaTemperature(ts);
+  }
+#endif
+
+  uint16_t hi_ts = pgm_read_word(&table[0]);
+  if (ts >= hi_ts) {
+    return first;
+  }
+  if (ts <= pgm_read_word(&table[points - 1])) {
+    return first + (int16_t)(points - 1) * step;
+  }
+
+  // Find the pair with table[lo] > ts >= table[lo + 1]
+  uint8_t lo = 0, hi = points - 1;
+  while (hi - lo > 1) {
+    uint8_t mid = (lo + hi) / 2;
+    if (pgm_read_word(&table[mid]) > ts) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  hi_ts = pgm_read_word(&table[lo]);
+  uint16_t lo_ts = pgm_read_word(&table[hi]);
+  int32_t offset = (int32_t)(hi_ts - ts) * step / (hi_ts - lo_ts);
+  return first + (int16_t)lo * step + offset;
+}
+
+#ifndef BQ25798_NO_FLOAT
+/*!
+ * @brief  Beta model conversion: undo the RT1/RT2 divider to get the NTC
+ *         resistance, then 1/T = 1/T25 + ln(R/R25)/beta
+ * @param  ts TS voltage in 0.01% of REGN
+ * @return Temperature in 0.1 degrees C, clamped to -40C..125C
+ */
+int16_t Adafruit_BQ25798_NTC::betaTemperature(uint16_t ts) {
+  const int16_t coldest = -400, hottest = 1250;
+
+  if (ts >= 10000) {
+    return coldest;
+  }
+  if (ts == 0) {
+    return hottest;
+  }
+
+  // Resistance from TS to GND, then take RT2 back out of the parallel pair
+  float low = (float)rt1 * ts / (10000 - ts);
+  float ntc = low;
+  if (rt2) {
+    if (low >= rt2) {
+      return coldest;
+    }
+    ntc = low * rt2 / (rt2 - low);
+  }
+
+  float kelvin = 1.0f / (1.0f / 298.15f + logf(ntc / r25) / beta);
+  float tenths = (kelvin - 273.15f) * 10.0f;
+  if (tenths <= coldest) {
+    return coldest;
+  }
+  if (tenths >= hottest) {
+    return hottest;
+  }
+  return (int16_t)(tenths + (tenths < 0 ? -0.5f : 0.5f));
+}
+#endif
@@ -0,0 +1,55 @@
+/*!
+ * @file Adafruit_BQ25798_NTC.h
+ *
+ * Thermistor conversion for the BQ25798 TS pin: turns the TS ADC reading
+ * into a battery temperature.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_NTC_H__
+#define __ADAFRUIT_BQ25798_NTC_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Converts TS readings (0.01% of REGN, as in bq25798_adc_fixed_t::ts)
+ *        to temperature in 0.1 degrees C, either by interpolating a table
+ *        kept in flash or from the thermistor's beta model.
+ *
+ *        The default table is for the datasheet network: a 10k NTC with
+ *        beta 3435 from TS to GND, RT1 = 5.24k from REGN to TS and
+ *        RT2 = 30.31k across the NTC, covering -40C to 100C in 5C steps.
+ *        Boards with a different network pass their own table to
+ *        setTable(), or the part values to setBeta().
+ */
+class Adafruit_BQ25798_NTC {
+public:
+  Adafruit_BQ25798_NTC();
+
+  void setTable(const uint16_t *table, uint8_t points, int16_t first_dC,
+                uint8_t step_dC);
+#ifndef BQ25798_NO_FLOAT
+  void setBeta(uint32_t r25, uint16_t beta, uint32_t rt1 = 5240,
+               uint32_t rt2 = 30310);
+#endif
+  int16_t toTemperature(uint16_t ts);
+
+private:
+#ifndef BQ25798_NO_FLOAT
+  int16_t betaTemperature(uint16_t ts);
+
+  uint32_t r25;  ///< NTC resistance at 25C in ohms
+  uint16_t beta; ///< NTC beta in K, 0 when converting from the table
+  uint32_t rt1;  ///< REGN to TS resistor in ohms
+  uint32_t rt2;  ///< Resistor across the NTC in ohms, 0 if none
+#endif
+  const uint16_t *table; ///< TS per point in 0.01% of REGN, PROGMEM,
+                         ///< falling as temperature rises
+  uint8_t points;        ///< Entries in table
+  int16_t first;         ///< Temperature of table[0] in 0.1C
+  uint8_t step;          ///< Temperature between entries in 0.1C
+};
+
+#endif // __ADAFRUIT_BQ25798_NTC_H__
@@ -0,0 +1,318 @@
+/*!
+ * @file Adafruit_BQ25798_OTG.cpp
+ *
+ * OTG (reverse boost) supervisor for the BQ25798.
+ *
+ * In OTG mode the chip boosts the battery onto VBUS until a fault stops
+ * it, and its own battery check (VBATOTG_LOW) is a fixed threshold meant
+ * to gate turning OTG on. Left alone, a hub port drains the pack well
+ * past a sensible cutoff, and PWM mode burns its switching losses even
+ * with nothing plugged in. This samples the output and battery and handles
+ * both.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_OTG.h"
+
+#define BQ25798_OTG_CELL_CUTOFF_MV 3300 ///< Default cutoff per series cell
+
+/*!
+ * @brief  Create a supervisor for a charger. Does not touch the bus.
+ * @param  charger Charger to supervise, already started with begin()
+ */
+Adafruit_BQ25798_OTG::Adafruit_BQ25798_OTG(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  callback = NULL;
+  reason = BQ25798_OTG_OFF_NONE;
+  min_vbat = 0;
+  vbat_debounce = 2000;
+  light = 100;
+  heavy = 300;
+  overload = 0;
+  interval = 500;
+  cutoff = 0;
+  running = false;
+  primed = false;
+  pfm = false;
+  seen_otg = false;
+  low = false;
+  limited = false;
+  low_ms = 0;
+  limited_ms = 0;
+  last_ms = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+/*!
+ * @brief  Set up and turn on OTG, then supervise it. Enables the ADC in
+ *         continuous mode for VBUS, IBUS and VBAT if it is not already
+ *         running. Starts in PWM; the first update picks the mode.
+ * @param  voltage_mV OTG output voltage, 2800 to 22000
+ * @param  limit_mA OTG output current limit, 160 to 3360
+ * @param  interval_ms Minimum time between samples
+ * @return True if OTG is on, false if the battery is already below the
+ *         minimum (getReason() says so) or on a bus error
+ */
+bool Adafruit_BQ25798_OTG::begin(uint16_t voltage_mV, uint16_t limit_mA,
+                                 uint16_t interval_ms) {
+  cutoff = min_vbat;
+  if (!cutoff) {
+    uint8_t cells = (uint8_t)charger->getCellCount() + 1;
+    if (charger->getLastError() != BQ25798_OK) {
+      return false;
+    }
+    cutoff = cells * BQ25798_OTG_CELL_CUTOFF_MV;
+  }
+
+  if (!charger->getADCEnable() &&
+      !charger->configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                             BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_VBUS |
+                                 BQ25798_ADC_CH_VBAT)) {
+    return false;
+  }
+
+  int32_t vbat;
+  if (!charger->getField(BQ25798_FIELD_VBAT_ADC, vbat)) {
+    return false;
+  }
+  // 0 is no conversion yet rather than a flat battery
+  if (vbat && vbat < cutoff) {
+    reason = BQ25798_OTG_OFF_VBAT_LOW;
+    return false;
+  }
+
+  if (!charger->setOTG_mV(voltage_mV) || !charger->setOTGLimit_mA(limit_mA) ||
+      !charger->setOTGPFM(false) || !charger->setOTGenable(true)) {
+    return false;
+  }
+
+  interval = interval_ms;
+  reason = BQ25798_OTG_OFF_NONE;
+  pfm = false;
+  seen_otg = false;
+  low = false;
+  limited = false;
+  primed = false;
+  memset(&stats, 0, sizeof(stats));
+  running = true;
+  return true;
+}
+
+/*!
+ * @brief  Turn OTG off and stop supervising
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_OTG::end() {
+  return stop(BQ25798_OTG_OFF_REQUESTED);
+}
+
+/*!
+ * @brief  Once per interval, check the faults and the battery and pick
+ *         PFM or PWM. Calls between intervals return without touching the
+ *         bus.
+ * @return False if not running, OTG was just turned off, or on a bus
+ *         error
+ */
+bool Adafruit_BQ25798_OTG::update() {
+  if (!running) {
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (primed && (uint32_t)(now - last_ms) < interval) {
+    return true;
+  }
+
+  static const bq25798_field_t fields[] = {
+      BQ25798_FIELD_IBUS_ADC, BQ25798_FIELD_VBUS_ADC, BQ25798_FIELD_VBAT_ADC};
+  int32_t values[3];
+  bq25798_status_t status;
+  if (!charger->getStatus(status) || !charger->getFields(fields, values, 3)) {
+    return false;
+  }
+
+  // IBUS reads negative while sourcing
+  uint16_t load = values[0] < 0 ? -values[0] : 0;
+  uint16_t vbus = values[1];
+  uint16_t vbat = values[2];
+
+  stats.samples++;
+  stats.vbus_mV = vbus;
+  stats.load_mA = load;
+  stats.vbat_mV = vbat;
+  if (load > stats.peak_mA) {
+    stats.peak_mA = load;
+  }
+  if (primed) {
+    // mV * mA * ms / 1000 = uJ
+    uint32_t dt = now - last_ms;
+    stats.energy_uJ += (uint64_t)vbus * load * dt / 1000;
+    if (pfm) {
+      stats.pfm_ms += dt;
+    }
+  }
+  primed = true;
+  last_ms = now;
+
+  if (status.otg_ovp) {
+    return stop(BQ25798_OTG_OFF_OVP);
+  }
+  if (status.otg_uvp) {
+    return stop(BQ25798_OTG_OFF_UVP);
+  }
+  if (status.tshut) {
+    return stop(BQ25798_OTG_OFF_THERMAL);
+  }
+  if (status.vbatotg_low) {
+    return stop(BQ25798_OTG_OFF_VBAT_LOW);
+  }
+  // VBUS_STAT takes a moment to report OTG after EN_OTG is set
+  if (status.vbus_stat == BQ25798_VBUS_STAT_OTG) {
+    seen_otg = true;
+  } else if (seen_otg) {
+    return stop(BQ25798_OTG_OFF_STOPPED);
+  }
+
+  if (held(vbat && vbat < cutoff, low, low_ms, vbat_debounce, now)) {
+    return stop(BQ25798_OTG_OFF_VBAT_LOW);
+  }
+  if (overload && held(status.iindpm, limited, limited_ms, overload, now)) {
+    return stop(BQ25798_OTG_OFF_OVERLOAD);
+  }
+
+  bool want = pfm ? load <= heavy : load < light;
+  if (want != pfm) {
+    if (!charger->setOTGPFM(want)) {
+      return false;
+    }
+    pfm = want;
+    stats.pfm_changes++;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Set the battery cutoff. The battery sags under load pulses, so it
+ *         must stay below the cutoff for the debounce time.
+ * @param  vbat_mV Cutoff in mV, 0 for 3300mV per series cell
+ * @param  debounce_ms Time below the cutoff before OTG is turned off
+ */
+void Adafruit_BQ25798_OTG::setMinimum(uint16_t vbat_mV, uint16_t debounce_ms) {
+  min_vbat = vbat_mV;
+  vbat_debounce = debounce_ms;
+  if (running && min_vbat) {
+    cutoff = min_vbat;
+  }
+}
+
+/*!
+ * @brief  Set the loads PFM is switched at. Leave a gap between the two so
+ *         a load near one threshold does not toggle the mode.
+ * @param  light_mA PFM is turned on below this load, 100 by default
+ * @param  heavy_mA PFM is turned off above this load, 300 by default
+ */
+void Adafruit_BQ25798_OTG::setPFMThresholds(uint16_t light_mA,
+                                            uint16_t heavy_mA) {
+  light = light_mA;
+  heavy = heavy_mA < light_mA ? light_mA : heavy_mA;
+}
+
+/*!
+ * @brief  Turn OTG off when the output stays in IOTG current regulation,
+ *         i.e. the load wants more than the limit
+ * @param  overload_ms Time in regulation before stopping, 0 (the default)
+ *         to let the chip regulate indefinitely
+ */
+void Adafruit_BQ25798_OTG::setOverload(uint16_t overload_ms) {
+  overload = overload_ms;
+}
+
+/*!
+ * @brief  Set a function to call when the supervisor turns OTG off, other
+ *         than through end()
+ * @param  callback Handler, or NULL for none
+ */
+void Adafruit_BQ25798_OTG::onShutdown(bq25798_otg_callback_t callback) {
+  this->callback = callback;
+}
+
+/*!
+ * @brief  Check whether OTG is on and supervised
+ * @return True between a successful begin() and the shutdown
+ */
+bool Adafruit_BQ25798_OTG::isRunning() {
+  return running;
+}
+
+/*!
+ * @brief  Check which mode the boost converter is in
+ * @return True for PFM, false for PWM
+ */
+bool Adafruit_BQ25798_OTG::isPFM() {
+  return pfm;
+}
+
+/*!
+ * @brief  Get why OTG was last turned off
+ * @return Reason, BQ25798_OTG_OFF_NONE while running
+ */
+bq25798_otg_reason_t Adafruit_BQ25798_OTG::getReason() {
+  return reason;
+}
+
+/*!
+ * @brief  Copy out the output statistics
+ * @param  stats Struct to fill
+ */
+void Adafruit_BQ25798_OTG::getStats(bq25798_otg_stats_t &stats) {
+  stats = this->stats;
+}
+
+/*!
+ * @brief  Turn OTG off, record why and tell the callback
+ * @param  reason Why
+ * @return False, since OTG is no longer running, except for a successful
+ *         end()
+ */
+bool Adafruit_BQ25798_OTG::stop(bq25798_otg_reason_t reason) {
+  bool was_running = running;
+  running = false;
+  bool ok = charger->setOTGenable(false);
+
+  if (reason == BQ25798_OTG_OFF_REQUESTED) {
+    // Keep the reason of an earlier shutdown
+    if (was_running) {
+      this->reason = reason;
+    }
+    return ok;
+  }
+  this->reason = reason;
+  if (callback) {
+    callback(reason);
+  }
+  return false;
+}
+
+/*!
+ * @brief  Track how long a condition has held
+ * @param  condition Current state
+ * @param  active Whether it held at the previous sample, updated
+ * @param  since millis() it started holding, updated
+ * @param  limit Time it may hold, in ms
+ * @param  now Current millis()
+ * @return True once it has held for the limit
+ */
+bool Adafruit_BQ25798_OTG::held(bool condition, bool &active, uint32_t &since,
+                                uint16_t limit, uint32_t now) {
+  if (!condition) {
+    active = false;
+    return false;
+  }
+  if (!active) {
+    active = true;
+    since = now;
+  }
+  return (uint32_t)(now - since) >= limit;
+}
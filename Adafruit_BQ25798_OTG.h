@@ -0,0 +1,112 @@
+/*!
+ * @file Adafruit_BQ25798_OTG.h
+ *
+ * OTG (reverse boost) supervisor for the BQ25798: watches the output while
+ * the charger sources VBUS, picks PFM or PWM by load, and shuts OTG down
+ * before the battery runs flat.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_OTG_H__
+#define __ADAFRUIT_BQ25798_OTG_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Why OTG was turned off
+ */
+typedef enum {
+  BQ25798_OTG_OFF_NONE,      ///< Still running, or never started
+  BQ25798_OTG_OFF_REQUESTED, ///< end() was called
+  BQ25798_OTG_OFF_VBAT_LOW,  ///< Battery below the minimum, or VBATOTG_LOW
+  BQ25798_OTG_OFF_OVERLOAD,  ///< In IOTG regulation for too long
+  BQ25798_OTG_OFF_OVP,       ///< OTG over-voltage fault
+  BQ25798_OTG_OFF_UVP,       ///< OTG under-voltage fault (short or overload)
+  BQ25798_OTG_OFF_THERMAL,   ///< Thermal shutdown
+  BQ25798_OTG_OFF_STOPPED    ///< The chip left OTG mode on its own, e.g.
+                             ///< the battery hot or cold
+} bq25798_otg_reason_t;
+
+/*!
+ * @brief Called once when the supervisor turns OTG off
+ */
+typedef void (*bq25798_otg_callback_t)(bq25798_otg_reason_t reason);
+
+/*!
+ * @brief Output statistics, accumulated since begin()
+ */
+typedef struct {
+  uint32_t samples;     ///< Status and ADC readings taken
+  uint32_t pfm_changes; ///< Times PFM was switched on or off
+  uint32_t pfm_ms;      ///< Time spent in PFM
+  uint16_t vbus_mV;     ///< Latest output voltage
+  uint16_t load_mA;     ///< Latest output current
+  uint16_t peak_mA;     ///< Highest output current seen
+  uint16_t vbat_mV;     ///< Latest battery voltage
+  uint64_t energy_uJ;   ///< Energy delivered on VBUS
+} bq25798_otg_stats_t;
+
+/*!
+ * @brief Runs the charger as a VBUS source and keeps an eye on it.
+ *
+ *        Each update reads the status registers and VBUS, IBUS and VBAT.
+ *        PFM is switched on when the load falls below the light threshold
+ *        and off again above the heavy one, so an idle port costs little
+ *        quiescent power and a loaded one gets PWM's ripple and transient
+ *        response. OTG is turned off, and the reason kept for getReason()
+ *        and the shutdown callback, when the battery stays below the
+ *        minimum for the debounce time, the output sits in IOTG regulation
+ *        for too long, or the chip reports an OTG fault or leaves OTG mode.
+ *
+ *        Status registers are read rather than the flags, so
+ *        handleInterrupt() users still see every event.
+ */
+class Adafruit_BQ25798_OTG {
+public:
+  Adafruit_BQ25798_OTG(Adafruit_BQ25798 *charger);
+
+  bool begin(uint16_t voltage_mV = 5000, uint16_t limit_mA = 1000,
+             uint16_t interval_ms = 500);
+  bool end();
+  bool update();
+
+  void setMinimum(uint16_t vbat_mV, uint16_t debounce_ms = 2000);
+  void setPFMThresholds(uint16_t light_mA, uint16_t heavy_mA);
+  void setOverload(uint16_t overload_ms);
+  void onShutdown(bq25798_otg_callback_t callback);
+
+  bool isRunning();
+  bool isPFM();
+  bq25798_otg_reason_t getReason();
+  void getStats(bq25798_otg_stats_t &stats);
+
+private:
+  bool stop(bq25798_otg_reason_t reason);
+  bool held(bool condition, bool &active, uint32_t &since, uint16_t limit,
+            uint32_t now);
+
+  Adafruit_BQ25798 *charger;       ///< Charger in OTG mode
+  bq25798_otg_callback_t callback; ///< Shutdown handler, may be NULL
+  bq25798_otg_reason_t reason;     ///< Why OTG was last turned off
+  uint16_t min_vbat;               ///< Battery cutoff in mV, 0 = by cells
+  uint16_t vbat_debounce;          ///< Time below the cutoff to stop, ms
+  uint16_t light;                  ///< PFM below this load, mA
+  uint16_t heavy;                  ///< PWM above this load, mA
+  uint16_t overload;               ///< Time in IOTG to stop, ms, 0 = never
+  uint16_t interval;               ///< Minimum time between samples, ms
+  uint16_t cutoff;                 ///< Battery cutoff in force, mV
+  bool running;                    ///< True while supervising
+  bool primed;                     ///< True once a sample was taken
+  bool pfm;                        ///< PFM enabled
+  bool seen_otg;                   ///< VBUS_STAT has reported OTG
+  bool low;                        ///< Battery below the cutoff
+  bool limited;                    ///< Output in IOTG regulation
+  uint32_t low_ms;                 ///< millis() the battery went low
+  uint32_t limited_ms;             ///< millis() IOTG regulation began
+  uint32_t last_ms;                ///< millis() of the latest sample
+  bq25798_otg_stats_t stats;       ///< Statistics
+};
+
+#endif // __ADAFRUIT_BQ25798_OTG_H__
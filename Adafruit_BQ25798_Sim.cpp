@@ -0,0 +1,320 @@
+/*!
+ * @file Adafruit_BQ25798_Sim.cpp
+ *
+ * In-memory BQ25798 register file transport.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Sim.h"
+
+// Power-on defaults for a 1S PROG setting, from the datasheet register map.
+// Status, flag, ADC and ICO_ILIM registers power up as zero.
+static const uint8_t sim_defaults[BQ25798_NUM_REGS] = {
+    0x04, 0x01, 0xA4, 0x00, 0x64, 0x24, 0x01, 0x2C, // 0x00-0x07
+    0xC3, 0x05, 0x23, 0x00, 0xDC, 0x4C, 0x3D, 0xA2, // 0x08-0x0F
+    0xB5, 0x40, 0x00, 0x01, 0x1E, 0xAA, 0xC0, 0x7A, // 0x10-0x17
+    0x54, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x18-0x1F
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x20-0x27
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, // 0x28-0x2F
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x30-0x37
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x38-0x3F
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x40-0x47
+    0x19,                                           // 0x48
+};
+
+// Bits the host may change; everything else is read-only or reserved
+static const uint8_t sim_writable[BQ25798_NUM_REGS] = {
+    0x3F, 0x07, 0xFF, 0x01, 0xFF, 0xFF, 0x01, 0xFF, // 0x00-0x07
+    0xFF, 0x7F, 0xFF, 0x07, 0xFF, 0xFF, 0xFF, 0xFF, // 0x08-0x0F
+    0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFE, // 0x10-0x17
+    0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x18-0x1F
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x20-0x27
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x28-0x2F
+    0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x30-0x37
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x38-0x3F
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, // 0x40-0x47
+    0x00,                                           // 0x48
+};
+
+/*!
+ * @brief  Create a simulator in its power-on state
+ */
+Adafruit_BQ25798_Sim::Adafruit_BQ25798_Sim() {
+  powerOnReset();
+}
+
+/*!
+ * @brief  Return every register to its power-on value and clear the
+ *         transaction counters
+ */
+void Adafruit_BQ25798_Sim::powerOnReset() {
+  memcpy(regs, sim_defaults, sizeof(regs));
+  failures = 0;
+  recoveries = 0;
+  defer = false;
+  pending_buffer = NULL;
+  xfer_status = BQ25798_XFER_IDLE;
+  resetCounts();
+}
+
+/*!
+ * @brief  What REG_RST does: reload the writable registers with their
+ *         defaults. Status, flags and ADC results are left alone.
+ */
+void Adafruit_BQ25798_Sim::resetRegisters() {
+  for (uint8_t reg = 0; reg < BQ25798_NUM_REGS; reg++) {
+    if (sim_writable[reg]) {
+      regs[reg] = sim_defaults[reg];
+    }
+  }
+}
+
+/*!
+ * @brief  Burst read with auto-increment. Flag registers clear on read.
+ * @param  reg First register address
+ * @param  buffer Destination for the register contents
+ * @param  len Number of registers to read
+ * @return True if successful, false if the run goes past the register map
+ */
+bool Adafruit_BQ25798_Sim::readRegisters(uint8_t reg, uint8_t *buffer,
+                                         uint8_t len) {
+  if ((uint16_t)reg + len > BQ25798_NUM_REGS) {
+    return false;
+  }
+
+  reads++;
+  if (failures) {
+    failures--;
+    return false; // NAK before anything is transferred
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    uint8_t addr = reg + i;
+    buffer[i] = regs[addr];
+    if (addr >= BQ25798_REG_CHARGER_FLAG_0 &&
+        addr <= BQ25798_REG_FAULT_FLAG_1) {
+      regs[addr] = 0;
+    }
+  }
+  return true;
+}
+
+/*!
+ * @brief  Burst write with auto-increment. Read-only bits are preserved and
+ *         self-clearing strobes take effect immediately.
+ * @param  reg First register address
+ * @param  buffer Register contents to write
+ * @param  len Number of registers to write
+ * @return True if successful, false if the run goes past the register map
+ */
+bool Adafruit_BQ25798_Sim::writeRegisters(uint8_t reg, const uint8_t *buffer,
+                                          uint8_t len) {
+  if ((uint16_t)reg + len > BQ25798_NUM_REGS) {
+    return false;
+  }
+
+  writes++;
+  if (failures) {
+    failures--;
+    return false;
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    uint8_t addr = reg + i;
+    uint8_t mask = sim_writable[addr];
+    regs[addr] = (regs[addr] & ~mask) | (buffer[i] & mask);
+  }
+
+  // REG_RST reloads the defaults, which also clears REG_RST itself
+  if (regs[BQ25798_REG_TERMINATION_CONTROL] & 0x40) {
+    resetRegisters();
+  }
+
+  // WD_RST, FORCE_ICO and FORCE_INDET complete instantly in the model
+  regs[BQ25798_REG_CHARGER_CONTROL_1] &= ~0x08;
+  regs[BQ25798_REG_CHARGER_CONTROL_0] &= ~0x08;
+  regs[BQ25798_REG_CHARGER_CONTROL_2] &= ~0x80;
+
+  // So does a one-shot ADC conversion: ADC_EN clears and ADC_DONE is raised
+  if ((regs[BQ25798_REG_ADC_CONTROL] & 0xC0) == 0xC0) {
+    regs[BQ25798_REG_ADC_CONTROL] &= ~0x80;
+    regs[BQ25798_REG_CHARGER_STATUS_3] |= 0x20;
+    regs[BQ25798_REG_CHARGER_FLAG_2] |= 0x20;
+  }
+
+  return true;
+}
+
+/*!
+ * @brief  Inspect a register without side effects
+ * @param  reg Register address
+ * @return Register contents
+ */
+uint8_t Adafruit_BQ25798_Sim::peek(uint8_t reg) {
+  return reg < BQ25798_NUM_REGS ? regs[reg] : 0;
+}
+
+/*!
+ * @brief  Set a register directly, bypassing read-only masks. Use this to
+ *         model the chip updating its own status or ADC registers.
+ * @param  reg Register address
+ * @param  value New contents
+ */
+void Adafruit_BQ25798_Sim::poke(uint8_t reg, uint8_t value) {
+  if (reg < BQ25798_NUM_REGS) {
+    regs[reg] = value;
+  }
+}
+
+/*!
+ * @brief  Inspect a 16-bit MSB-first register pair without side effects
+ * @param  reg Address of the MSB
+ * @return Register pair contents
+ */
+uint16_t Adafruit_BQ25798_Sim::peek16(uint8_t reg) {
+  return ((uint16_t)peek(reg) << 8) | peek(reg + 1);
+}
+
+/*!
+ * @brief  Set a 16-bit MSB-first register pair directly, e.g. an ADC result
+ * @param  reg Address of the MSB
+ * @param  value New contents
+ */
+void Adafruit_BQ25798_Sim::poke16(uint8_t reg, uint16_t value) {
+  poke(reg, value >> 8);
+  poke(reg + 1, value & 0xFF);
+}
+
+/*!
+ * @brief  Latch event flags as if the chip had detected them
+ * @param  flags Bitset of BQ25798_FLAG_* events
+ */
+void Adafruit_BQ25798_Sim::raiseFlags(uint64_t flags) {
+  for (uint8_t i = 0;
+       i <= BQ25798_REG_FAULT_FLAG_1 - BQ25798_REG_CHARGER_FLAG_0; i++) {
+    regs[BQ25798_REG_CHARGER_FLAG_0 + i] |= (flags >> (i * 8)) & 0xFF;
+  }
+}
+
+/*!
+ * @brief  Number of read transactions since the last reset of the counters
+ * @return Read transaction count
+ */
+uint32_t Adafruit_BQ25798_Sim::readCount() {
+  return reads;
+}
+
+/*!
+ * @brief  Number of write transactions since the last reset of the counters
+ * @return Write transaction count
+ */
+uint32_t Adafruit_BQ25798_Sim::writeCount() {
+  return writes;
+}
+
+/*!
+ * @brief  Zero the transaction counters
+ */
+void Adafruit_BQ25798_Sim::resetCounts() {
+  reads = 0;
+  writes = 0;
+}
+
+/*!
+ * @brief  Make the next transactions fail as if the chip NAKed its address,
+ *         e.g. to exercise the driver's retry policy
+ * @param  count Number of transactions to fail
+ */
+void Adafruit_BQ25798_Sim::failTransfers(uint8_t count) {
+  failures = count;
+}
+
+/*!
+ * @brief  Pretend to clock the bus free; the model never gets stuck
+ * @return Always true
+ */
+bool Adafruit_BQ25798_Sim::recoverBus() {
+  recoveries++;
+  return true;
+}
+
+/*!
+ * @brief  Number of recoverBus() calls since powerOnReset()
+ * @return Recovery count
+ */
+uint32_t Adafruit_BQ25798_Sim::recoveryCount() {
+  return recoveries;
+}
+
+/*!
+ * @brief  Start an async burst read. Runs at once unless transfers are
+ *         deferred, in which case it stays in flight until
+ *         completeTransfer().
+ * @param  reg First register address
+ * @param  buffer Destination
+ * @param  len Number of registers to read
+ * @return True if the transfer was started
+ */
+bool Adafruit_BQ25798_Sim::startRead(uint8_t reg, uint8_t *buffer,
+                                     uint8_t len) {
+  if (!defer) {
+    return Adafruit_BQ25798_Transport::startRead(reg, buffer, len);
+  }
+  if (transferStatus() == BQ25798_XFER_BUSY) {
+    return false;
+  }
+  pending_write = false;
+  pending_reg = reg;
+  pending_len = len;
+  pending_buffer = buffer;
+  xfer_status = BQ25798_XFER_BUSY;
+  return true;
+}
+
+/*!
+ * @brief  Start an async burst write, deferred like startRead()
+ * @param  reg First register address
+ * @param  buffer Register contents
+ * @param  len Number of registers to write
+ * @return True if the transfer was started
+ */
+bool Adafruit_BQ25798_Sim::startWrite(uint8_t reg, const uint8_t *buffer,
+                                      uint8_t len) {
+  if (!defer) {
+    return Adafruit_BQ25798_Transport::startWrite(reg, buffer, len);
+  }
+  if (transferStatus() == BQ25798_XFER_BUSY) {
+    return false;
+  }
+  pending_write = true;
+  pending_reg = reg;
+  pending_len = len;
+  pending_buffer = (uint8_t *)buffer;
+  xfer_status = BQ25798_XFER_BUSY;
+  return true;
+}
+
+/*!
+ * @brief  Hold async transfers in flight, as a DMA or interrupt driven
+ *         transport would, until completeTransfer() is called
+ * @param  defer True to hold transfers, false to run them at once
+ */
+void Adafruit_BQ25798_Sim::deferTransfers(bool defer) {
+  this->defer = defer;
+}
+
+/*!
+ * @brief  Run the held transfer and mark it done
+ * @return True if a transfer was in flight
+ */
+bool Adafruit_BQ25798_Sim::completeTransfer() {
+  if (transferStatus() != BQ25798_XFER_BUSY || !pending_buffer) {
+    return false;
+  }
+  uint8_t *buffer = pending_buffer;
+  pending_buffer = NULL;
+  finishTransfer(pending_write
+                     ? writeRegisters(pending_reg, buffer, pending_len)
+                     : readRegisters(pending_reg, buffer, pending_len));
+  return true;
+}
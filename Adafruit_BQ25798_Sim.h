@@ -0,0 +1,72 @@
+/*!
+ * @file Adafruit_BQ25798_Sim.h
+ *
+ * In-memory BQ25798 register file that plugs in as a transport, so the
+ * driver can be exercised on a host without hardware.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_SIM_H__
+#define __ADAFRUIT_BQ25798_SIM_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Simulated BQ25798 register map. Models power-on defaults,
+ *        read-only and reserved bits, clear-on-read flag registers and the
+ *        self-clearing REG_RST/WD_RST/FORCE_ICO/FORCE_INDET strobes. One-shot
+ *        ADC conversions finish as soon as they are started. 16-bit fields
+ *        are stored MSB first, as on the real part. Transactions can be
+ *        made to fail on demand to exercise error handling, and async
+ *        transfers can be held in flight until the test completes them.
+ */
+class Adafruit_BQ25798_Sim : public Adafruit_BQ25798_Transport {
+public:
+  Adafruit_BQ25798_Sim();
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len);
+
+  bool startRead(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool startWrite(uint8_t reg, const uint8_t *buffer, uint8_t len);
+
+  void powerOnReset();
+
+  uint8_t peek(uint8_t reg);
+  void poke(uint8_t reg, uint8_t value);
+  uint16_t peek16(uint8_t reg);
+  void poke16(uint8_t reg, uint16_t value);
+
+  void raiseFlags(uint64_t flags);
+
+  uint32_t readCount();
+  uint32_t writeCount();
+  void resetCounts();
+
+  void failTransfers(uint8_t count);
+  bool recoverBus();
+  uint32_t recoveryCount();
+
+  void deferTransfers(bool defer);
+  bool completeTransfer();
+
+private:
+  void resetRegisters();
+
+  uint8_t regs[BQ25798_NUM_REGS]; ///< Current register contents
+  uint32_t reads;  ///< Number of readRegisters() transactions
+  uint32_t writes; ///< Number of writeRegisters() transactions
+
+  uint8_t failures;    ///< Transactions still to fail, see failTransfers()
+  uint32_t recoveries; ///< Number of recoverBus() calls
+
+  bool defer;              ///< Hold async transfers, see deferTransfers()
+  bool pending_write;      ///< Direction of the held transfer
+  uint8_t pending_reg;     ///< First register of the held transfer
+  uint8_t pending_len;     ///< Length of the held transfer
+  uint8_t *pending_buffer; ///< Caller buffer of the held transfer
+};
+
+#endif // __ADAFRUIT_BQ25798_SIM_H__
@@ -0,0 +1,334 @@
+/*!
+ * @file Adafruit_BQ25798_SoC.cpp
+ *
+ * State-of-charge estimator for the BQ25798.
+ *
+ * Coulomb counting is precise over minutes but drifts with IBAT offset and
+ * self-discharge; the OCV curve is absolute but only readable once the
+ * cell has relaxed. Counting between rests and snapping back to the curve
+ * during them gets the strengths of both.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_SoC.h"
+
+#define BQ25798_OCV_POINTS 11   ///< OCV table entries, 0% to 100% by 10%
+#define BQ25798_SOC_FULL 10000  ///< 100% in 0.01% units
+#define BQ25798_SOC_FLAT_MV 25  ///< Smallest OCV rise per 10% worth trusting
+#define BQ25798_SOC_COLD_DC 100 ///< Below this (0.1C) rest takes twice as long
+
+/*! Typical rested cell voltage in mV at 0%, 10%, ... 100% and 25C */
+static const uint16_t ocv_tables[][BQ25798_OCV_POINTS] PROGMEM = {
+    {3300, 3580, 3670, 3730, 3770, 3810, 3860, 3930, 4000, 4080, 4200},
+    {3300, 3600, 3700, 3760, 3810, 3860, 3930, 4010, 4100, 4200, 4350},
+    {2800, 3100, 3200, 3230, 3260, 3280, 3290, 3300, 3320, 3340, 3550}};
+
+/*!
+ * @brief  Create an estimator. Call begin() before feeding it samples.
+ * @param  charger Charger read by update(), or NULL to feed samples in by
+ *         hand with addSample()
+ */
+Adafruit_BQ25798_SoC::Adafruit_BQ25798_SoC(Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  ocv = ocv_tables[BQ25798_CHEM_LIION];
+  cells = 1;
+  unit = 1;
+  rest_threshold = 20;
+  rest_time = 1800;
+  resistance = 100;
+  temperature = 250;
+  corrections = 0;
+  seeded = false;
+  primed = false;
+  resting = false;
+  corrected = false;
+  charge = 0;
+  residual = 0;
+  last_us = 0;
+  last_ibat = 0;
+  rest_ms = 0;
+}
+
+/*!
+ * @brief  Set up the pack. The count is seeded from the next sample.
+ * @param  chemistry Cell chemistry
+ * @param  capacity_mAh Rated pack capacity
+ * @param  cells Cells in series, 1-4, or 0 to read the charger's CELL
+ *         setting
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_SoC::begin(bq25798_chemistry_t chemistry,
+                                 uint16_t capacity_mAh, uint8_t cells) {
+  if (chemistry > BQ25798_CHEM_LIFEPO4 || !capacity_mAh || cells > 4) {
+    return false;
+  }
+  if (!cells) {
+    if (!charger) {
+      return false;
+    }
+    cells = (uint8_t)charger->getCellCount() + 1;
+  }
+
+  ocv = ocv_tables[chemistry];
+  this->cells = cells;
+  // 0.01% of capacity_mAh * 3600 s
+  unit = ((int32_t)capacity_mAh * 36 + 50) / 100;
+  if (!unit) {
+    unit = 1;
+  }
+  seeded = false;
+  primed = false;
+  resting = false;
+  corrected = false;
+  residual = 0;
+  rest_ms = 0;
+  corrections = 0;
+  return true;
+}
+
+/*!
+ * @brief  Read IBAT, VBAT and TS in one burst and update the estimate.
+ *         The ADC must already be running with at least those channels,
+ *         see Adafruit_BQ25798::configureADC().
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_SoC::update() {
+  bq25798_adc_fixed_t adc;
+
+  if (!charger || !charger->readAllADC(adc)) {
+    return false;
+  }
+
+  addSample(adc, micros());
+  return true;
+}
+
+/*!
+ * @brief  Update the estimate from a sample streamed by
+ *         Adafruit_BQ25798::poll()
+ * @param  sample Timestamped ADC sample with IBAT, VBAT and TS enabled
+ */
+void Adafruit_BQ25798_SoC::addSample(const bq25798_adc_sample_t &sample) {
+  addSample(sample.adc, sample.timestamp_us);
+}
+
+/*!
+ * @brief  Update the estimate from one ADC snapshot
+ * @param  adc Readings, only ibat, vbat and ts are used. A ts of 0 (channel
+ *         off or TS ignored) is taken as 25C.
+ * @param  timestamp_us micros() at which the readings were taken
+ */
+void Adafruit_BQ25798_SoC::addSample(const bq25798_adc_fixed_t &adc,
+                                     uint32_t timestamp_us) {
+  temperature = adc.ts ? ntc.toTemperature(adc.ts) : 250;
+
+  // Internal resistance roughly doubles from 25C to 0C
+  int32_t r = resistance;
+  if (temperature < 250) {
+    r += r * (250 - temperature) / 250;
+  }
+  // mA * mOhm = uV; charging current lifts the terminal above the OCV
+  int32_t cell_ocv = (int32_t)adc.vbat / cells - (int32_t)adc.ibat * r / 1000;
+  if (cell_ocv < 0) {
+    cell_ocv = 0;
+  }
+
+  if (!primed) {
+    if (!seeded) {
+      charge = (int32_t)ocvToSoC(cell_ocv) * unit;
+      residual = 0;
+      seeded = true;
+    }
+    primed = true;
+    last_us = timestamp_us;
+    last_ibat = adc.ibat;
+    return;
+  }
+
+  // Whole ms only; the remainder stays in last_us for the next interval
+  uint32_t dt_ms = (timestamp_us - last_us) / 1000;
+  last_us += dt_ms * 1000;
+  integrate(adc.ibat, dt_ms);
+  last_ibat = adc.ibat;
+
+  if (adc.ibat < (int16_t)rest_threshold &&
+      adc.ibat > -(int16_t)rest_threshold) {
+    if (rest_ms < 0xFFFFFFFF - dt_ms) {
+      rest_ms += dt_ms;
+    }
+  } else {
+    rest_ms = 0;
+  }
+
+  uint32_t needed = (uint32_t)rest_time * 1000;
+  if (temperature < BQ25798_SOC_COLD_DC) {
+    needed *= 2;
+  }
+  resting = rest_ms >= needed;
+  if (!resting) {
+    corrected = false;
+    return;
+  }
+
+  uint16_t slope;
+  uint16_t soc = ocvToSoC(cell_ocv, &slope);
+  if (slope >= BQ25798_SOC_FLAT_MV) {
+    if (!corrected) {
+      corrections++;
+      corrected = true;
+    }
+    charge = (int32_t)soc * unit;
+    residual = 0;
+  }
+}
+
+/*!
+ * @brief  Get the state of charge
+ * @return SoC in 0.01% units, 0-10000
+ */
+uint16_t Adafruit_BQ25798_SoC::getSoC() {
+  return charge / unit;
+}
+
+/*!
+ * @brief  Get the charge left in the pack
+ * @return Remaining capacity in mAh
+ */
+uint16_t Adafruit_BQ25798_SoC::getRemaining_mAh() {
+  return (charge + 1800) / 3600;
+}
+
+/*!
+ * @brief  Get the battery temperature used for compensation
+ * @return Temperature in 0.1 degrees C from the latest sample
+ */
+int16_t Adafruit_BQ25798_SoC::getTemperature() {
+  return temperature;
+}
+
+/*!
+ * @brief  Check whether the battery has rested long enough for VBAT to be
+ *         taken as its open-circuit voltage
+ * @return True while resting
+ */
+bool Adafruit_BQ25798_SoC::isResting() {
+  return resting;
+}
+
+/*!
+ * @brief  Number of rest periods that pulled the count back to the OCV
+ *         curve since begin()
+ * @return Correction count
+ */
+uint32_t Adafruit_BQ25798_SoC::getCorrections() {
+  return corrections;
+}
+
+/*!
+ * @brief  Declare the pack full, e.g. from an
+ *         Adafruit_BQ25798::onChargeDone() callback. This is the only
+ *         correction LiFePO4 gets across most of its flat curve.
+ */
+void Adafruit_BQ25798_SoC::markFull() {
+  setSoC(BQ25798_SOC_FULL);
+}
+
+/*!
+ * @brief  Override the estimate, e.g. with a value saved before power
+ *         down. Takes the place of the OCV seed if called before the first
+ *         sample.
+ * @param  soc State of charge in 0.01% units, clamped to 10000
+ */
+void Adafruit_BQ25798_SoC::setSoC(uint16_t soc) {
+  if (soc > BQ25798_SOC_FULL) {
+    soc = BQ25798_SOC_FULL;
+  }
+  charge = (int32_t)soc * unit;
+  residual = 0;
+  seeded = true;
+}
+
+/*!
+ * @brief  Set when the battery counts as resting
+ * @param  threshold_mA |IBAT| must stay below this
+ * @param  time_s ...for this long, doubled below 10C. Li-ion needs around
+ *         30 minutes to relax to within a few mV of its OCV.
+ */
+void Adafruit_BQ25798_SoC::setRestDetection(uint16_t threshold_mA,
+                                            uint16_t time_s) {
+  rest_threshold = threshold_mA;
+  rest_time = time_s;
+}
+
+/*!
+ * @brief  Set the cell internal resistance used to estimate the OCV while
+ *         current flows, which is how the count is seeded
+ * @param  resistance_mOhm Per-cell resistance at 25C, including wiring
+ */
+void Adafruit_BQ25798_SoC::setCellResistance(uint16_t resistance_mOhm) {
+  resistance = resistance_mOhm;
+}
+
+/*!
+ * @brief  Access the TS converter, e.g. to install a table for a different
+ *         thermistor network
+ * @return The estimator's converter
+ */
+Adafruit_BQ25798_NTC &Adafruit_BQ25798_SoC::getNTC() {
+  return ntc;
+}
+
+/*!
+ * @brief  Look up the state of charge for a rested cell voltage
+ * @param  cell_mV Open-circuit voltage of one cell
+ * @param  slope If not NULL, receives the OCV rise in mV across the 10%
+ *         segment used, a measure of how much the answer can be trusted
+ * @return SoC in 0.01% units, 0-10000
+ */
+uint16_t Adafruit_BQ25798_SoC::ocvToSoC(uint16_t cell_mV, uint16_t *slope) {
+  uint8_t i = 1;
+  uint16_t lo = pgm_read_word(&ocv[0]);
+  uint16_t hi = pgm_read_word(&ocv[1]);
+  while (cell_mV >= hi && i < BQ25798_OCV_POINTS - 1) {
+    lo = hi;
+    hi = pgm_read_word(&ocv[++i]);
+  }
+
+  if (slope) {
+    *slope = hi - lo;
+  }
+  if (cell_mV <= lo) {
+    return (i - 1) * 1000;
+  }
+  if (cell_mV >= hi) {
+    return BQ25798_SOC_FULL;
+  }
+  return (i - 1) * 1000 + (uint32_t)(cell_mV - lo) * 1000 / (hi - lo);
+}
+
+/*!
+ * @brief  Count the charge moved since the previous sample, trapezoidal
+ *         between the two IBAT readings
+ * @param  ibat IBAT in mA
+ * @param  dt_ms Time since the previous sample
+ */
+void Adafruit_BQ25798_SoC::integrate(int16_t ibat, uint32_t dt_ms) {
+  int32_t sum = (int32_t)last_ibat + ibat;
+
+  // Chunks short enough for sum * chunk to stay within 32 bits
+  while (dt_ms) {
+    uint16_t chunk = dt_ms > 32767 ? 32767 : dt_ms;
+    residual += sum * chunk;
+    charge += residual / 2000;
+    residual %= 2000;
+    dt_ms -= chunk;
+  }
+
+  if (charge < 0) {
+    charge = 0;
+  } else if (charge > unit * BQ25798_SOC_FULL) {
+    charge = unit * BQ25798_SOC_FULL;
+  }
+}
@@ -0,0 +1,91 @@
+/*!
+ * @file Adafruit_BQ25798_SoC.h
+ *
+ * State-of-charge estimator for 1S-4S packs on the BQ25798, combining an
+ * open-circuit-voltage lookup with coulomb counting on IBAT.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_SOC_H__
+#define __ADAFRUIT_BQ25798_SOC_H__
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_NTC.h"
+
+/*!
+ * @brief Cell chemistry, selects the OCV-vs-SoC table
+ */
+typedef enum {
+  BQ25798_CHEM_LIION,  ///< Li-ion / LiPo, 4.2V full
+  BQ25798_CHEM_LIHV,   ///< High-voltage LiPo, 4.35V full
+  BQ25798_CHEM_LIFEPO4 ///< LiFePO4, 3.55V full
+} bq25798_chemistry_t;
+
+/*!
+ * @brief Tracks state of charge by counting the charge through IBAT and
+ *        pulling the count back to the open-circuit voltage curve whenever
+ *        the battery has rested long enough for VBAT to mean something.
+ *        The first sample seeds the count from VBAT, corrected for the
+ *        cell's internal resistance.
+ *
+ *        Corrections are skipped on the flat parts of a curve (most of
+ *        LiFePO4's), where a few mV of error would move the estimate by
+ *        tens of percent; there only the coulomb count and markFull()
+ *        apply. Cold cells get a higher internal resistance and twice the
+ *        rest time, since they relax more slowly.
+ *
+ *        update() costs one ADC burst read; the arithmetic is 32-bit
+ *        integer only, uses no heap and the tables live in flash.
+ */
+class Adafruit_BQ25798_SoC {
+public:
+  Adafruit_BQ25798_SoC(Adafruit_BQ25798 *charger = NULL);
+
+  bool begin(bq25798_chemistry_t chemistry, uint16_t capacity_mAh,
+             uint8_t cells = 0);
+
+  bool update();
+  void addSample(const bq25798_adc_sample_t &sample);
+  void addSample(const bq25798_adc_fixed_t &adc, uint32_t timestamp_us);
+
+  uint16_t getSoC();
+  uint16_t getRemaining_mAh();
+  int16_t getTemperature();
+  bool isResting();
+  uint32_t getCorrections();
+
+  void markFull();
+  void setSoC(uint16_t soc);
+  void setRestDetection(uint16_t threshold_mA, uint16_t time_s);
+  void setCellResistance(uint16_t resistance_mOhm);
+  Adafruit_BQ25798_NTC &getNTC();
+
+  uint16_t ocvToSoC(uint16_t cell_mV, uint16_t *slope = NULL);
+
+private:
+  void integrate(int16_t ibat, uint32_t dt_ms);
+
+  Adafruit_BQ25798 *charger; ///< Source for update(), may be NULL
+  Adafruit_BQ25798_NTC ntc;  ///< TS to temperature conversion
+  const uint16_t *ocv;       ///< OCV table in PROGMEM, mV per cell
+  uint8_t cells;             ///< Cells in series
+  int32_t unit;              ///< Charge per 0.01% SoC in mA*s
+  int32_t charge;            ///< Charge in the pack in mA*s
+  int32_t residual;          ///< Uncounted charge in mA*ms*2
+  uint16_t rest_threshold;   ///< |IBAT| below which the pack rests, mA
+  uint16_t rest_time;        ///< Rest needed before a correction, s
+  uint16_t resistance;       ///< Cell internal resistance at 25C, mOhm
+  int16_t temperature;       ///< Latest battery temperature in 0.1C
+  bool seeded;               ///< True once the count has a starting point
+  bool primed;               ///< True once a previous sample exists
+  bool resting;              ///< True while VBAT is trusted as OCV
+  bool corrected;            ///< True once this rest period has corrected
+  uint32_t last_us;          ///< Timestamp of the previous sample
+  int16_t last_ibat;         ///< Previous IBAT in mA
+  uint32_t rest_ms;          ///< Time IBAT has been below the threshold
+  uint32_t corrections;      ///< Rest periods that corrected the count
+};
+
+#endif // __ADAFRUIT_BQ25798_SOC_H__
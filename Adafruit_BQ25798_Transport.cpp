@@ -0,0 +1,130 @@
+/*!
+ * @file Adafruit_BQ25798_Transport.cpp
+ *
+ * Arduino TwoWire register transport for the Adafruit BQ25798 driver.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Transport.h"
+
+#ifdef ARDUINO
+
+/*!
+ * @brief  Create an I2C transport
+ * @param  i2c_addr The I2C address to be used
+ * @param  wire The Wire object to be used for I2C connections
+ */
+Adafruit_BQ25798_I2C::Adafruit_BQ25798_I2C(uint8_t i2c_addr, TwoWire *wire)
+    : i2c_dev(i2c_addr, wire) {
+  scl_pin = -1;
+  sda_pin = -1;
+}
+
+/*!
+ * @brief  Initialize the I2C bus and check the device acknowledges
+ * @return True if the device was found
+ */
+bool Adafruit_BQ25798_I2C::begin() {
+  return i2c_dev.begin();
+}
+
+/*!
+ * @brief  Read a run of consecutive registers, bursting as much as the bus
+ *         buffer allows
+ * @param  reg First register address
+ * @param  buffer Destination for the register contents
+ * @param  len Number of registers to read
+ * @return True if every transfer was acknowledged
+ */
+bool Adafruit_BQ25798_I2C::readRegisters(uint8_t reg, uint8_t *buffer,
+                                         uint8_t len) {
+  uint8_t chunk_max = i2c_dev.maxBufferSize();
+  uint8_t addr = reg;
+  while (len) {
+    uint8_t chunk = len > chunk_max ? chunk_max : len;
+    if (!i2c_dev.write_then_read(&addr, 1, buffer, chunk)) {
+      return false;
+    }
+    addr += chunk;
+    buffer += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Write a run of consecutive registers in as few bursts as possible
+ * @param  reg First register address
+ * @param  buffer Register contents to write
+ * @param  len Number of registers to write
+ * @return True if every transfer was acknowledged
+ */
+bool Adafruit_BQ25798_I2C::writeRegisters(uint8_t reg, const uint8_t *buffer,
+                                          uint8_t len) {
+  // One byte of every transfer is taken up by the register address
+  uint8_t chunk_max = i2c_dev.maxBufferSize() - 1;
+  uint8_t addr = reg;
+  if (!len) {
+    // Address byte alone, e.g. a TCA9548A mux taking its channel mask
+    return i2c_dev.write(&addr, 1);
+  }
+  while (len) {
+    uint8_t chunk = len > chunk_max ? chunk_max : len;
+    if (!i2c_dev.write(buffer, chunk, true, &addr, 1)) {
+      return false;
+    }
+    addr += chunk;
+    buffer += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
+/*!
+ * @brief  Name the pins behind the Wire instance so recoverBus() can drive
+ *         them. Wire has no portable way to report its own pins.
+ * @param  scl SCL pin number, or -1 to disable recovery
+ * @param  sda SDA pin number, or -1 to disable recovery
+ */
+void Adafruit_BQ25798_I2C::setRecoveryPins(int8_t scl, int8_t sda) {
+  scl_pin = scl;
+  sda_pin = sda;
+}
+
+/*!
+ * @brief  Clock SCL up to nine times until the slave lets go of SDA, send a
+ *         STOP, then hand the pins back to Wire
+ * @return True if the pins are known and recovery ran
+ */
+bool Adafruit_BQ25798_I2C::recoverBus() {
+  if (scl_pin < 0 || sda_pin < 0) {
+    return false;
+  }
+
+  // Open drain by hand: drive low, or float and let the pull-up win.
+  // 5us half periods keep the recovery clock at standard mode speed.
+  pinMode(sda_pin, INPUT_PULLUP);
+  pinMode(scl_pin, INPUT_PULLUP);
+  for (uint8_t i = 0; i < 9 && !digitalRead(sda_pin); i++) {
+    pinMode(scl_pin, OUTPUT);
+    digitalWrite(scl_pin, LOW);
+    delayMicroseconds(5);
+    pinMode(scl_pin, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+
+  // STOP: SDA rises while SCL is high
+  pinMode(sda_pin, OUTPUT);
+  digitalWrite(sda_pin, LOW);
+  delayMicroseconds(5);
+  pinMode(sda_pin, INPUT_PULLUP);
+  delayMicroseconds(5);
+
+  // Re-initialise Wire, which takes the pins back
+  i2c_dev.begin(false);
+  return true;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,209 @@
+/*!
+ * @file Adafruit_BQ25798_Transport.h
+ *
+ * Register transport interface for the Adafruit BQ25798 driver. The driver
+ * only ever talks to the chip through readRegisters()/writeRegisters() on one
+ * of these, so it can sit on Arduino I2C, a host-side simulator, or any other
+ * bus backend.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_TRANSPORT_H__
+#define __ADAFRUIT_BQ25798_TRANSPORT_H__
+
+#ifdef ARDUINO
+#include "Arduino.h"
+#include <Adafruit_I2CDevice.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// Minimal stand-ins for the Arduino timing calls on host builds
+
+/*!
+ * @brief  Microseconds since an arbitrary epoch, wrapping like Arduino's
+ * @return Monotonic microsecond count
+ */
+static inline uint32_t micros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+/*!
+ * @brief  Milliseconds since an arbitrary epoch, wrapping like Arduino's
+ * @return Monotonic millisecond count
+ */
+static inline uint32_t millis() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+}
+
+/*!
+ * @brief  Sleep for a number of microseconds
+ * @param  us Microseconds to wait
+ */
+static inline void delayMicroseconds(uint32_t us) {
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000L;
+  nanosleep(&ts, NULL);
+}
+
+/*!
+ * @brief  Sleep for a number of milliseconds
+ * @param  ms Milliseconds to wait
+ */
+static inline void delay(uint32_t ms) {
+  delayMicroseconds(ms * 1000);
+}
+
+// Hosts have a single address space, so flash tables are plain memory
+#define PROGMEM                                 ///< No-op section attribute
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))  ///< Read a flash byte
+#define pgm_read_word(addr) (*(const uint16_t *)(addr)) ///< Read a flash word
+#define memcpy_P memcpy                                 ///< Copy from flash
+#endif
+
+/*!
+ * @brief Progress of a transfer started with startRead()/startWrite()
+ */
+typedef enum {
+  BQ25798_XFER_IDLE,  ///< Nothing started yet
+  BQ25798_XFER_BUSY,  ///< Still on the bus
+  BQ25798_XFER_DONE,  ///< Finished and acknowledged
+  BQ25798_XFER_ERROR  ///< Finished with a NAK or bus error
+} bq25798_xfer_status_t;
+
+/*!
+ * @brief Abstract register access backend for the BQ25798
+ */
+class Adafruit_BQ25798_Transport {
+public:
+  Adafruit_BQ25798_Transport() : xfer_status(BQ25798_XFER_IDLE) {}
+  virtual ~Adafruit_BQ25798_Transport() {}
+
+  /*!
+   * @brief  Bring up the underlying bus
+   * @return True if the device is reachable
+   */
+  virtual bool begin() { return true; }
+
+  /*!
+   * @brief  Read consecutive registers, auto-incrementing the address
+   * @param  reg First register address
+   * @param  buffer Destination for the register contents
+   * @param  len Number of registers to read
+   * @return True if successful
+   */
+  virtual bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) = 0;
+
+  /*!
+   * @brief  Write consecutive registers, auto-incrementing the address
+   * @param  reg First register address
+   * @param  buffer Register contents to write
+   * @param  len Number of registers to write
+   * @return True if successful
+   */
+  virtual bool writeRegisters(uint8_t reg, const uint8_t *buffer,
+                              uint8_t len) = 0;
+
+  /*!
+   * @brief  Free a bus held low by a slave that lost sync mid-byte, by
+   *         clocking SCL until SDA is released and sending a STOP. Called
+   *         between retries, see Adafruit_BQ25798::setRetryPolicy().
+   * @return True if a recovery was carried out, false if unsupported
+   */
+  virtual bool recoverBus() {
+    return false;
+  }
+
+  /*!
+   * @brief  Start a read that may finish later, for the driver's async
+   *         queue. This default just calls readRegisters(), so the transfer
+   *         is over before it returns and tick() holds the CPU for it. A
+   *         DMA, interrupt or thread driven bus (e.g.
+   *         Adafruit_BQ25798_LinuxI2C) overrides it and startWrite() to set
+   *         BQ25798_XFER_BUSY, kick off the transfer and call
+   *         finishTransfer() on completion.
+   * @param  reg First register address
+   * @param  buffer Destination, must stay valid until the transfer ends
+   * @param  len Number of registers to read
+   * @return True if the transfer was started
+   */
+  virtual bool startRead(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    finishTransfer(readRegisters(reg, buffer, len));
+    return true;
+  }
+
+  /*!
+   * @brief  Start a write that may finish later, see startRead()
+   * @param  reg First register address
+   * @param  buffer Register contents, must stay valid until the transfer
+   *         ends
+   * @param  len Number of registers to write
+   * @return True if the transfer was started
+   */
+  virtual bool startWrite(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    finishTransfer(writeRegisters(reg, buffer, len));
+    return true;
+  }
+
+  /*!
+   * @brief  Check on the last transfer started with startRead()/startWrite()
+   * @return Its progress
+   */
+  bq25798_xfer_status_t transferStatus() {
+    uint8_t status = xfer_status;
+#ifndef ARDUINO
+    // Pairs with finishTransfer() on a worker thread
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+    return (bq25798_xfer_status_t)status;
+  }
+
+  /*!
+   * @brief  Report the transfer in flight as finished. Safe to call from an
+   *         interrupt handler.
+   * @param  ok True if every byte was acknowledged
+   */
+  void finishTransfer(bool ok) {
+#ifndef ARDUINO
+    // Make the received bytes visible before the status that announces them
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+    xfer_status = ok ? BQ25798_XFER_DONE : BQ25798_XFER_ERROR;
+  }
+
+protected:
+  volatile uint8_t xfer_status; ///< bq25798_xfer_status_t, set from ISRs
+};
+
+#ifdef ARDUINO
+/*!
+ * @brief Arduino TwoWire transport built on Adafruit_I2CDevice
+ */
+class Adafruit_BQ25798_I2C : public Adafruit_BQ25798_Transport {
+public:
+  Adafruit_BQ25798_I2C(uint8_t i2c_addr, TwoWire *wire = &Wire);
+
+  bool begin();
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len);
+
+  void setRecoveryPins(int8_t scl, int8_t sda);
+  bool recoverBus();
+
+private:
+  Adafruit_I2CDevice i2c_dev; ///< I2C bus interface
+  int8_t scl_pin;             ///< SCL pin for recoverBus(), or -1
+  int8_t sda_pin;             ///< SDA pin for recoverBus(), or -1
+};
+#endif
+
+#endif // __ADAFRUIT_BQ25798_TRANSPORT_H__
@@ -0,0 +1,202 @@
+/*!
+ * @file Adafruit_BQ25798_Watchdog.cpp
+ *
+ * Keepalive service for the BQ25798 I2C watchdog.
+ *
+ * When the watchdog expires the chip reloads most control registers with
+ * their defaults (charge current, input limits, watchdog period...) and
+ * sets WD_STAT. Nothing on the bus fails, so without checking WD_STAT the
+ * host keeps running against a charger that no longer has its settings.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_BQ25798_Watchdog.h"
+
+/*! Timeout in ms for each bq25798_wdt_t setting */
+static const uint32_t wdt_timeouts[] = {0,     500,   1000,  2000,
+                                        20000, 40000, 80000, 160000};
+
+/*!
+ * @brief  Create a keepalive service for a charger. Does not touch the bus.
+ * @param  charger Charger to keep alive, already started with begin()
+ */
+Adafruit_BQ25798_Watchdog::Adafruit_BQ25798_Watchdog(
+    Adafruit_BQ25798 *charger) {
+  this->charger = charger;
+  timeout = 0;
+  margin = 0;
+  check_interval = 10000;
+  last_reset = 0;
+  last_check = 0;
+  running = false;
+  memset(config, 0, sizeof(config));
+  memset(&health, 0, sizeof(health));
+}
+
+/*!
+ * @brief  Arm the watchdog and start keeping it fed. Turns on kick
+ *         piggybacking and captures the current configuration as the one
+ *         to restore after an expiry, so configure the charger first.
+ * @param  timeout Watchdog period, anything but BQ25798_WDT_DISABLE
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Watchdog::begin(bq25798_wdt_t timeout) {
+  if (timeout == BQ25798_WDT_DISABLE || timeout > BQ25798_WDT_160S) {
+    return false;
+  }
+
+  charger->setWDTPiggyback(true);
+  // Writes CHARGER_CONTROL_1, so this is also the first kick
+  if (!charger->setWDT(timeout) || !capture()) {
+    return false;
+  }
+
+  this->timeout = wdt_timeouts[timeout];
+  memset(&health, 0, sizeof(health));
+  last_reset = charger->getLastWDTReset();
+  last_check = millis();
+  running = true;
+  return true;
+}
+
+/*!
+ * @brief  Stop the service and disable the watchdog, so it does not expire
+ *         once nobody is feeding it
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Watchdog::end() {
+  running = false;
+  charger->setWDTPiggyback(false);
+  return charger->setWDT(BQ25798_WDT_DISABLE);
+}
+
+/*!
+ * @brief  Take the charger's current configuration as the one to restore
+ *         after an expiry. Call it after changing settings. Free when the
+ *         shadow cache is enabled, three burst reads otherwise.
+ * @return True if successful
+ */
+bool Adafruit_BQ25798_Watchdog::capture() {
+  return charger->saveConfig(config);
+}
+
+/*!
+ * @brief  Feed the watchdog if it is due and check on it if needed. Call it
+ *         from the main loop at least a few times per timeout period.
+ * @return False if a kick or check failed on the bus or a restore failed
+ */
+bool Adafruit_BQ25798_Watchdog::update() {
+  if (!running) {
+    return false;
+  }
+
+  uint32_t now = millis();
+
+  // Some other write to CHARGER_CONTROL_1 fed it since the last call
+  uint32_t reset = charger->getLastWDTReset();
+  if (reset != last_reset) {
+    health.piggybacked++;
+    noteReset(reset);
+  }
+
+  uint32_t lead = margin && margin < timeout ? margin : timeout / 4;
+  bool suspect = false;
+  bool ok = true;
+  if ((uint32_t)(now - last_reset) >= timeout - lead) {
+    suspect = (uint32_t)(now - last_reset) >= timeout;
+    if (charger->resetWDT()) {
+      health.kicks++;
+      noteReset(charger->getLastWDTReset());
+    } else {
+      health.failures++;
+      suspect = true;
+      ok = false;
+    }
+  }
+
+  if (suspect ||
+      (check_interval && (uint32_t)(now - last_check) >= check_interval)) {
+    ok = check() && ok;
+  }
+  return ok;
+}
+
+/*!
+ * @brief  Set how long before the timeout a kick goes out. Leave room for
+ *         the loop period and the watchdog's own tolerance.
+ * @param  margin_ms Lead time in ms, 0 for a quarter of the timeout
+ */
+void Adafruit_BQ25798_Watchdog::setMargin(uint32_t margin_ms) {
+  margin = margin_ms;
+}
+
+/*!
+ * @brief  Set how often WD_STAT is read when every kick has gone out on
+ *         time. It catches expiries the schedule cannot see, e.g. from the
+ *         host stalling or the chip being reset behind its back.
+ * @param  interval_ms Period in ms, 0 to only check after late or failed
+ *         kicks
+ */
+void Adafruit_BQ25798_Watchdog::setCheckInterval(uint32_t interval_ms) {
+  check_interval = interval_ms;
+}
+
+/*!
+ * @brief  Get the watchdog period armed by begin()
+ * @return Timeout in ms, 0 before begin()
+ */
+uint32_t Adafruit_BQ25798_Watchdog::getTimeout_ms() {
+  return timeout;
+}
+
+/*!
+ * @brief  Copy out the keepalive statistics
+ * @param  health Struct to fill
+ */
+void Adafruit_BQ25798_Watchdog::getHealth(bq25798_wdt_health_t &health) {
+  health = this->health;
+}
+
+/*!
+ * @brief  Read WD_STAT and, if the watchdog has expired, write back the
+ *         captured configuration and feed it again
+ * @return True if the watchdog is healthy or was recovered
+ */
+bool Adafruit_BQ25798_Watchdog::check() {
+  last_check = millis();
+  health.checks++;
+
+  bool expired = charger->getWDTStatus();
+  if (charger->getLastError() != BQ25798_OK) {
+    return false;
+  }
+  if (!expired) {
+    return true;
+  }
+  health.expiries++;
+
+  // restoreConfig() compares against the live registers, which went back
+  // to their defaults behind the shadow copy's back
+  uint8_t changed = 0;
+  if (!charger->restoreConfig(config, &changed) || !charger->resetWDT()) {
+    return false;
+  }
+  health.restores++;
+  health.restored = changed;
+  last_reset = charger->getLastWDTReset();
+  return true;
+}
+
+/*!
+ * @brief  Record a watchdog reset and the gap since the previous one
+ * @param  when millis() of the reset
+ */
+void Adafruit_BQ25798_Watchdog::noteReset(uint32_t when) {
+  uint32_t gap = when - last_reset;
+  if (gap > health.max_gap_ms) {
+    health.max_gap_ms = gap;
+  }
+  last_reset = when;
+}
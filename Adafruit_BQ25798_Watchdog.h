@@ -0,0 +1,72 @@
+/*!
+ * @file Adafruit_BQ25798_Watchdog.h
+ *
+ * Keepalive service for the BQ25798 I2C watchdog: feeds it on schedule and
+ * puts the configuration back if it ever expires.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef __ADAFRUIT_BQ25798_WATCHDOG_H__
+#define __ADAFRUIT_BQ25798_WATCHDOG_H__
+
+#include "Adafruit_BQ25798.h"
+
+/*!
+ * @brief Keepalive statistics, accumulated since begin()
+ */
+typedef struct {
+  uint32_t kicks;       ///< resetWDT() calls made by the service
+  uint32_t piggybacked; ///< Resets that rode on other 0x10 writes
+  uint32_t failures;    ///< Kicks the bus did not acknowledge
+  uint32_t checks;      ///< WD_STAT reads
+  uint32_t expiries;    ///< Times WD_STAT was found set
+  uint32_t restores;    ///< Successful configuration restores
+  uint8_t restored;     ///< Registers rewritten by the latest restore
+  uint32_t max_gap_ms;  ///< Longest time between two watchdog resets
+} bq25798_wdt_health_t;
+
+/*!
+ * @brief Keeps the chip's watchdog fed from the main loop. A kick is only
+ *        sent once the last reset is older than the timeout minus a
+ *        margin, and any write to CHARGER_CONTROL_1 made in the meantime
+ *        counts as a reset (see Adafruit_BQ25798::setWDTPiggyback()), so
+ *        with the short timeouts most loops cost nothing on the bus.
+ *
+ *        WD_STAT is read whenever a kick came late or failed, plus at a
+ *        slow health-check interval. If the watchdog has expired, the
+ *        configuration captured at begin() (or the last capture()) is
+ *        written back, touching only the registers the expiry reset.
+ */
+class Adafruit_BQ25798_Watchdog {
+public:
+  Adafruit_BQ25798_Watchdog(Adafruit_BQ25798 *charger);
+
+  bool begin(bq25798_wdt_t timeout = BQ25798_WDT_1S);
+  bool end();
+
+  bool capture();
+  bool update();
+
+  void setMargin(uint32_t margin_ms);
+  void setCheckInterval(uint32_t interval_ms);
+  uint32_t getTimeout_ms();
+  void getHealth(bq25798_wdt_health_t &health);
+
+private:
+  bool check();
+  void noteReset(uint32_t when);
+
+  Adafruit_BQ25798 *charger;           ///< Charger being kept alive
+  uint8_t config[BQ25798_CONFIG_SIZE]; ///< Configuration to restore
+  uint32_t timeout;                    ///< Watchdog timeout in ms
+  uint32_t margin;                     ///< Kick this long before expiry
+  uint32_t check_interval;             ///< WD_STAT poll period, 0 off
+  uint32_t last_reset;                 ///< Last reset seen, millis()
+  uint32_t last_check;                 ///< Last WD_STAT read, millis()
+  bool running;                        ///< True between begin and end
+  bq25798_wdt_health_t health;         ///< Statistics
+};
+
+#endif // __ADAFRUIT_BQ25798_WATCHDOG_H__
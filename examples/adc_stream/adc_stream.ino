@@ -0,0 +1,65 @@
+/*
+ * Continuous ADC streaming example for the Adafruit BQ25798 charger
+ *
+ * The ADC runs continuously with only the battery and input channels
+ * enabled. poll() takes a timestamped sample every 100ms and queues it in a
+ * lock-free ring buffer; the logging side drains the ring independently, so
+ * on an RTOS the two halves can live in separate tasks.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_ADCRing.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_ADCBuffer<16> samples;
+
+uint32_t last_poll = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 ADC stream"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  if (!bq.configureADC(true, BQ25798_ADC_RES_14BIT, false,
+                       BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_VBUS |
+                           BQ25798_ADC_CH_IBAT | BQ25798_ADC_CH_VBAT)) {
+    Serial.println(F("Failed to configure ADC"));
+    while (1);
+  }
+  bq.setADCStream(&samples);
+
+  Serial.println(F("time_us,vbus_mV,ibus_mA,vbat_mV,ibat_mA"));
+}
+
+void loop() {
+  // Producer: charger control side
+  if (millis() - last_poll >= 100) {
+    last_poll = millis();
+    bq.poll();
+  }
+
+  // Consumer: data logger side
+  bq25798_adc_sample_t sample;
+  while (samples.pop(sample)) {
+    Serial.print(sample.timestamp_us);
+    Serial.print(',');
+    Serial.print(sample.adc.vbus);
+    Serial.print(',');
+    Serial.print(sample.adc.ibus);
+    Serial.print(',');
+    Serial.print(sample.adc.vbat);
+    Serial.print(',');
+    Serial.println(sample.adc.ibat);
+  }
+
+  if (samples.dropped()) {
+    Serial.print(F("Dropped samples: "));
+    Serial.println(samples.dropped());
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * Asynchronous register access example for the Adafruit BQ25798 charger
+ *
+ * Once a second a status read and an ADC snapshot are queued instead of
+ * being read in place. tick() runs one bus transfer per call from loop(),
+ * so the rest of the loop (here, a blinking LED) never waits on a whole
+ * batch of transfers. The callbacks print the results when they arrive.
+ */
+
+#include <Adafruit_BQ25798.h>
+
+Adafruit_BQ25798 bq;
+bq25798_async_op_t queue[4];
+
+bq25798_status_t status;
+bq25798_adc_fixed_t adc;
+
+uint32_t last_request = 0;
+uint32_t last_blink = 0;
+
+void statusDone(bool ok, void *context) {
+  (void)context;
+  if (!ok) {
+    Serial.println(F("Status read failed"));
+    return;
+  }
+  Serial.print(F("Power good: "));
+  Serial.print(status.power_good ? F("yes") : F("no"));
+  Serial.print(F("  charge state: "));
+  Serial.println(status.chg_stat);
+}
+
+void adcDone(bool ok, void *context) {
+  (void)context;
+  if (!ok) {
+    Serial.println(F("ADC read failed"));
+    return;
+  }
+  Serial.print(F("VBUS "));
+  Serial.print(adc.vbus);
+  Serial.print(F("mV  IBUS "));
+  Serial.print(adc.ibus);
+  Serial.print(F("mA  VBAT "));
+  Serial.print(adc.vbat);
+  Serial.print(F("mV  IBAT "));
+  Serial.print(adc.ibat);
+  Serial.println(F("mA"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 async queue"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+  bq.configureADC(true);
+  bq.setAsyncQueue(queue, sizeof(queue) / sizeof(queue[0]));
+
+  pinMode(LED_BUILTIN, OUTPUT);
+}
+
+void loop() {
+  uint32_t now = millis();
+
+  if (now - last_request >= 1000 && !bq.asyncPending()) {
+    last_request = now;
+    bq.getStatusAsync(&status, statusDone);
+    bq.readAllADCAsync(&adc, adcDone);
+  }
+
+  bq.tick();
+
+  // Other cooperative work keeps running between transfers
+  if (now - last_blink >= 250) {
+    last_blink = now;
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Dual-input arbitration example for the Adafruit BQ25798 charger
+ *
+ * For boards with both ACFET-RBFET pairs fitted, a solar panel on VAC2 and
+ * a wall adapter on VAC1. The panel is used whenever it is up; the adapter
+ * takes over when the panel browns out. The active input and statistics
+ * are printed every 5 seconds.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_Arbiter.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_Arbiter arbiter(&bq);
+
+uint32_t last_report = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 dual-input arbiter"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  arbiter.setSolarInput(BQ25798_INPUT_VAC2);
+  // Panels sag under load: a 1 second brownout debounce rides out clouds
+  arbiter.setDebounce(2000, 1000);
+
+  if (!arbiter.begin(BQ25798_ARBITER_PREFER_SOLAR)) {
+    Serial.println(F("Failed to start, are both input FET pairs fitted?"));
+    while (1);
+  }
+}
+
+void loop() {
+  arbiter.update();
+
+  if (millis() - last_report < 5000) {
+    return;
+  }
+  last_report = millis();
+
+  bq25798_arbiter_stats_t stats;
+  arbiter.getStats(stats);
+  Serial.print(F("Active: "));
+  switch (arbiter.getActive()) {
+  case BQ25798_INPUT_VAC1:
+    Serial.print(F("VAC1"));
+    break;
+  case BQ25798_INPUT_VAC2:
+    Serial.print(F("VAC2"));
+    break;
+  default:
+    Serial.print(F("none"));
+    break;
+  }
+  Serial.print(F(", VAC1 "));
+  Serial.print(stats.vac1_mV);
+  Serial.print(F(" mV, VAC2 "));
+  Serial.print(stats.vac2_mV);
+  Serial.print(F(" mV, switches "));
+  Serial.print(stats.switches);
+  Serial.print(F(", brownouts "));
+  Serial.print(stats.brownouts);
+  Serial.print(F(", dips "));
+  Serial.println(stats.dips);
+}
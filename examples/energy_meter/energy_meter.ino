@@ -0,0 +1,87 @@
+/*
+ * Coulomb counter / energy meter example for the Adafruit BQ25798 charger
+ *
+ * Samples IBAT, VBAT, IBUS and VBUS every 10 seconds and integrates them
+ * into charge and energy totals. Trapezoidal integration keeps the totals
+ * accurate even at this slow rate. The state blob printed every minute is
+ * what you would write to EEPROM or flash and hand back to restoreState()
+ * after a reboot.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_Energy.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_Energy meter(&bq);
+
+uint32_t last_sample = 0;
+uint8_t sample_count = 0;
+
+void printMilli(uint64_t micro) {
+  // Totals are in micro-units; print them with three decimals of milli
+  Serial.print((uint32_t)(micro / 1000));
+  Serial.print('.');
+  uint16_t frac = micro % 1000;
+  if (frac < 100) Serial.print('0');
+  if (frac < 10) Serial.print('0');
+  Serial.print(frac);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 energy meter"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  if (!bq.configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                       BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_IBAT |
+                           BQ25798_ADC_CH_VBUS | BQ25798_ADC_CH_VBAT)) {
+    Serial.println(F("Failed to configure ADC"));
+    while (1);
+  }
+}
+
+void loop() {
+  if (millis() - last_sample < 10000) {
+    return;
+  }
+  last_sample = millis();
+
+  if (!meter.update()) {
+    Serial.println(F("ADC read failed"));
+    return;
+  }
+
+  bq25798_energy_totals_t totals;
+  meter.getTotals(totals);
+
+  Serial.print(F("Battery in "));
+  printMilli(totals.bat_in_uAh);
+  Serial.print(F(" mAh / "));
+  printMilli(totals.bat_in_uWh);
+  Serial.print(F(" mWh, out "));
+  printMilli(totals.bat_out_uAh);
+  Serial.print(F(" mAh / "));
+  printMilli(totals.bat_out_uWh);
+  Serial.print(F(" mWh, input "));
+  printMilli(totals.vbus_in_uWh);
+  Serial.println(F(" mWh"));
+
+  if (++sample_count >= 6) {
+    sample_count = 0;
+
+    uint8_t state[BQ25798_ENERGY_STATE_SIZE];
+    meter.saveState(state);
+    Serial.print(F("State: "));
+    for (uint8_t i = 0; i < sizeof(state); i++) {
+      if (state[i] < 0x10) Serial.print('0');
+      Serial.print(state[i], HEX);
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Field-by-name console for the Adafruit BQ25798 charger
+ *
+ * Type a datasheet field name to read it, NAME=value to write it, or ? to
+ * dump every field with a single bulk read. Values use the driver's field
+ * units: mV, mA, 0.1C for TDIE_ADC, and raw codes for enums and booleans.
+ *
+ *   VREG          -> VREG = 4200
+ *   ICHG=1500     -> ICHG = 1500
+ *   ?             -> every field
+ */
+
+#include <Adafruit_BQ25798.h>
+
+Adafruit_BQ25798 bq;
+
+char line[32];
+uint8_t line_len = 0;
+
+void printField(bq25798_field_t field, int32_t value) {
+  char name[BQ25798_FIELD_NAME_MAX];
+  Adafruit_BQ25798::getFieldName(field, name, sizeof(name));
+  Serial.print(name);
+  Serial.print(F(" = "));
+  Serial.println(value);
+}
+
+void dumpAll() {
+  bq25798_field_t fields[BQ25798_FIELD_COUNT];
+  int32_t values[BQ25798_FIELD_COUNT];
+
+  for (uint8_t i = 0; i < BQ25798_FIELD_COUNT; i++) {
+    fields[i] = (bq25798_field_t)i;
+  }
+  if (!bq.getFields(fields, values, BQ25798_FIELD_COUNT)) {
+    Serial.println(F("Read failed"));
+    return;
+  }
+  for (uint8_t i = 0; i < BQ25798_FIELD_COUNT; i++) {
+    printField(fields[i], values[i]);
+  }
+}
+
+void handleLine(char *cmd) {
+  if (!strcmp(cmd, "?")) {
+    dumpAll();
+    return;
+  }
+
+  char *eq = strchr(cmd, '=');
+  if (eq) {
+    *eq = 0;
+  }
+
+  bq25798_field_t field = Adafruit_BQ25798::findField(cmd);
+  if (field == BQ25798_FIELD_COUNT) {
+    Serial.println(F("Unknown field"));
+    return;
+  }
+
+  if (eq && !bq.setField(field, atol(eq + 1))) {
+    Serial.println(F("Rejected: read-only or out of range"));
+    return;
+  }
+  printField(field, bq.getField(field));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 field console"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+  bq.enableCache();
+
+  Serial.println(F("Enter NAME, NAME=value or ?"));
+}
+
+void loop() {
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == '\r' || c == '\n') {
+      if (line_len) {
+        line[line_len] = 0;
+        handleLine(line);
+        line_len = 0;
+      }
+    } else if (line_len < sizeof(line) - 1) {
+      line[line_len++] = c;
+    }
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Interrupt driven event example for the Adafruit BQ25798 charger
+ *
+ * Connect the BQ25798 INT pin to an interrupt capable pin. The chip pulses
+ * INT low for 256us whenever an unmasked flag is raised; the ISR only sets a
+ * flag and loop() services it over I2C.
+ */
+
+#include <Adafruit_BQ25798.h>
+
+#define BQ_INT_PIN 2
+
+Adafruit_BQ25798 bq;
+
+volatile bool bq_interrupt = false;
+
+void bqISR() {
+  bq_interrupt = true;
+}
+
+void vbusChanged(bool present) {
+  Serial.print(F("VBUS "));
+  Serial.println(present ? F("plugged in") : F("removed"));
+}
+
+void chargeDone() {
+  Serial.println(F("Charge complete"));
+}
+
+void thermalShutdown() {
+  Serial.println(F("Thermal shutdown!"));
+}
+
+void fault(uint16_t faults) {
+  Serial.print(F("Fault flags: 0x"));
+  Serial.println(faults, HEX);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 interrupt events"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  bq.onVBUSPresentChanged(vbusChanged);
+  bq.onChargeDone(chargeDone);
+  bq.onTSHUT(thermalShutdown);
+  bq.onFault(fault);
+
+  // Only pulse INT for the events we handle, plus every fault
+  uint64_t wanted = BQ25798_FLAG_VBUS_PRESENT | BQ25798_FLAG_CHG |
+                    BQ25798_FLAG_TSHUT | (0xFFFFULL << 32);
+  bq.setInterruptMask(BQ25798_FLAG_ALL & ~wanted);
+
+  // Discard anything latched before we were listening
+  bq.handleInterrupt();
+
+  pinMode(BQ_INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(BQ_INT_PIN), bqISR, FALLING);
+}
+
+void loop() {
+  if (bq_interrupt) {
+    bq_interrupt = false;
+    bq.handleInterrupt();
+  }
+}
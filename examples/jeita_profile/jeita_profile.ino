@@ -0,0 +1,61 @@
+/*
+ * Temperature-banded charging example for the Adafruit BQ25798 charger
+ *
+ * Reads the battery thermistor on TS once a second and sets the charge
+ * current and voltage from a four band profile: no charging below 0C, a
+ * trickle and lower voltage when cold, full rate in the middle and a lower
+ * voltage when warm. Above the last band, 50C, charging stops. The band
+ * and temperature are printed whenever the band changes.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_JEITA.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_JEITA jeita(&bq);
+
+// Upper edge in 0.1C, charge current in mA, charge voltage in mV
+const bq25798_jeita_band_t profile[] = {
+    {0, 0, 0},         // Below 0C: do not charge
+    {100, 300, 4100},  // 0C to 10C: trickle, reduced voltage
+    {450, 2000, 4200}, // 10C to 45C: full rate
+    {500, 1000, 4100}, // 45C to 50C: half rate, reduced voltage
+};
+const uint8_t bands = sizeof(profile) / sizeof(profile[0]);
+
+int8_t last_band = BQ25798_JEITA_NONE;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 JEITA profile"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  // For a board with a 10k B3950 thermistor instead of the datasheet part:
+  // jeita.getNTC().setBeta(10000, 3950);
+
+  if (!jeita.begin(profile, bands)) {
+    Serial.println(F("Failed to start the profile"));
+    while (1);
+  }
+}
+
+void loop() {
+  jeita.update();
+
+  if (jeita.getBand() == last_band) {
+    return;
+  }
+  last_band = jeita.getBand();
+
+  Serial.print(F("Battery at "));
+  Serial.print(jeita.getTemperature() / 10.0, 1);
+  Serial.print(F("C, band "));
+  Serial.print(last_band);
+  Serial.println(last_band == bands ? F(" (too hot, charging off)") : F(""));
+}
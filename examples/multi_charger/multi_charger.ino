@@ -0,0 +1,75 @@
+/*
+ * Multi-charger example for the Adafruit BQ25798 charger
+ *
+ * Four BQ25798s share address 0x6B, so each sits on its own channel of a
+ * TCA9548A mux at 0x70. The manager switches channels for them and polls
+ * status and ADC of the whole rack once a second, one channel switch per
+ * charger.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_Multi.h>
+
+#define NUM_CHARGERS 4
+
+Adafruit_BQ25798_I2C mux_bus(0x70, &Wire);
+Adafruit_BQ25798_I2C charger_bus(BQ25798_DEFAULT_ADDR, &Wire);
+Adafruit_BQ25798_Multi rack;
+
+bq25798_status_t status[NUM_CHARGERS];
+bq25798_adc_fixed_t adc[NUM_CHARGERS];
+
+bool configure(Adafruit_BQ25798 &charger, uint8_t unit, void *context) {
+  (void)unit;
+  (void)context;
+  return charger.setChargeLimitA(1.0) && charger.setChargeLimitV(4.2) &&
+         charger.configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                              BQ25798_ADC_CH_IBAT | BQ25798_ADC_CH_VBAT |
+                                  BQ25798_ADC_CH_VBUS);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 multi-charger example"));
+
+  int8_t mux = rack.addMux(&mux_bus, &charger_bus);
+  for (uint8_t ch = 0; ch < NUM_CHARGERS; ch++) {
+    rack.addCharger(mux, ch);
+  }
+
+  uint16_t found = rack.begin();
+  for (uint8_t i = 0; i < NUM_CHARGERS; i++) {
+    Serial.print(F("Charger "));
+    Serial.print(i);
+    Serial.println((found & (1 << i)) ? F(" found") : F(" missing"));
+  }
+
+  if (rack.forEach(configure) != found) {
+    Serial.println(F("Failed to configure every charger"));
+  }
+}
+
+void loop() {
+  delay(1000);
+
+  uint16_t ok = rack.poll(status, adc);
+  for (uint8_t i = 0; i < NUM_CHARGERS; i++) {
+    if (!(ok & (1 << i))) {
+      continue;
+    }
+    Serial.print(i);
+    Serial.print(F(": VBUS "));
+    Serial.print(adc[i].vbus);
+    Serial.print(F(" mV, VBAT "));
+    Serial.print(adc[i].vbat);
+    Serial.print(F(" mV, IBAT "));
+    Serial.print(adc[i].ibat);
+    Serial.print(F(" mA, state "));
+    Serial.println(status[i].chg_stat);
+  }
+
+  Serial.print(F("Mux switches so far: "));
+  Serial.println(rack.getSwitchCount());
+}
@@ -0,0 +1,84 @@
+/*
+ * OTG supervisor example for the Adafruit BQ25798 charger
+ *
+ * Powers a USB port at 5V / 1.5A from the battery. The supervisor runs
+ * the boost converter in PFM while the port is idle, switches to PWM
+ * under load, and turns the port off once the battery stays below 3.4V
+ * per cell. The output is printed every 2 seconds and the reason is
+ * printed when the port is shut down.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_OTG.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_OTG otg(&bq);
+
+uint32_t last_report = 0;
+
+void shutdown(bq25798_otg_reason_t reason) {
+  Serial.print(F("OTG turned off: "));
+  switch (reason) {
+  case BQ25798_OTG_OFF_VBAT_LOW:
+    Serial.println(F("battery low"));
+    break;
+  case BQ25798_OTG_OFF_OVERLOAD:
+    Serial.println(F("overload"));
+    break;
+  case BQ25798_OTG_OFF_OVP:
+    Serial.println(F("over-voltage"));
+    break;
+  case BQ25798_OTG_OFF_UVP:
+    Serial.println(F("under-voltage, output shorted?"));
+    break;
+  case BQ25798_OTG_OFF_THERMAL:
+    Serial.println(F("thermal shutdown"));
+    break;
+  default:
+    Serial.println(F("the charger left OTG mode"));
+    break;
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 OTG supervisor"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  uint8_t cells = (uint8_t)bq.getCellCount() + 1;
+  otg.setMinimum(cells * 3400);
+  // Give up after 5 seconds pinned at the current limit
+  otg.setOverload(5000);
+  otg.onShutdown(shutdown);
+
+  if (!otg.begin(5000, 1500)) {
+    Serial.println(F("Could not start OTG, battery too low?"));
+    while (1);
+  }
+}
+
+void loop() {
+  otg.update();
+
+  if (!otg.isRunning() || millis() - last_report < 2000) {
+    return;
+  }
+  last_report = millis();
+
+  bq25798_otg_stats_t stats;
+  otg.getStats(stats);
+  Serial.print(F("VBUS "));
+  Serial.print(stats.vbus_mV);
+  Serial.print(F(" mV, load "));
+  Serial.print(stats.load_mA);
+  Serial.print(F(" mA, battery "));
+  Serial.print(stats.vbat_mV);
+  Serial.print(F(" mV, "));
+  Serial.println(otg.isPFM() ? F("PFM") : F("PWM"));
+}
@@ -0,0 +1,60 @@
+/*
+ * Input power budget example for the Adafruit BQ25798 charger
+ *
+ * Runs from a 5V 2A adapter that also feeds the system load. The budget
+ * manager gives the battery whatever the load leaves of 9W, so the
+ * adapter never sees more than its rating. Input, load and charge power
+ * are printed every 2 seconds.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_Budget.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_Budget budget(&bq);
+
+uint32_t last_report = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 power budget"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  // Charge at up to 2A when the load allows it, never past the adapter
+  budget.setChargeRange(100, 2000);
+  budget.setInputMax(2000);
+
+  if (!budget.begin(9000)) {
+    Serial.println(F("Failed to start the budget manager"));
+    while (1);
+  }
+}
+
+void loop() {
+  budget.update();
+
+  if (millis() - last_report < 2000) {
+    return;
+  }
+  last_report = millis();
+
+  bq25798_budget_stats_t stats;
+  budget.getStats(stats);
+  Serial.print(F("Input "));
+  Serial.print(stats.input_mW);
+  Serial.print(F(" mW, load "));
+  Serial.print(stats.load_mW);
+  Serial.print(F(" mW, battery "));
+  Serial.print(stats.charge_mW);
+  Serial.print(F(" mW, ICHG "));
+  Serial.print(stats.ichg_mA);
+  Serial.print(F(" mA, IINDPM "));
+  Serial.print(stats.iindpm_mA);
+  Serial.println(F(" mA"));
+}
@@ -0,0 +1,87 @@
+/*
+ * State-of-charge monitor example for the Adafruit BQ25798 charger
+ *
+ * Estimates the charge left in the pack at 10 Hz and prints it once a
+ * second. The count is seeded from VBAT on the first sample, follows IBAT
+ * from then on and is pulled back to the open-circuit voltage curve after
+ * the battery has rested. Set CAPACITY_MAH and the chemistry to match your
+ * pack; the cell count is read from the charger.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_SoC.h>
+
+#define CAPACITY_MAH 2000
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_SoC soc(&bq);
+
+uint32_t last_sample = 0;
+uint8_t sample_count = 0;
+
+void chargeDone() {
+  soc.markFull();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 state-of-charge monitor"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  if (!bq.configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                       BQ25798_ADC_CH_IBAT | BQ25798_ADC_CH_VBAT |
+                           BQ25798_ADC_CH_TS)) {
+    Serial.println(F("Failed to configure ADC"));
+    while (1);
+  }
+
+  if (!soc.begin(BQ25798_CHEM_LIION, CAPACITY_MAH)) {
+    Serial.println(F("Failed to set up the estimator"));
+    while (1);
+  }
+  soc.setCellResistance(80);
+
+  // Termination is the one point where a full pack is known for certain
+  bq.onChargeDone(chargeDone);
+}
+
+void loop() {
+  bq.poll();
+
+  if (millis() - last_sample < 100) {
+    return;
+  }
+  last_sample = millis();
+
+  if (!soc.update()) {
+    Serial.println(F("ADC read failed"));
+    return;
+  }
+
+  if (++sample_count < 10) {
+    return;
+  }
+  sample_count = 0;
+
+  uint16_t pct = soc.getSoC();
+  Serial.print(F("SoC "));
+  Serial.print(pct / 100);
+  Serial.print('.');
+  if (pct % 100 < 10) Serial.print('0');
+  Serial.print(pct % 100);
+  Serial.print(F("%, "));
+  Serial.print(soc.getRemaining_mAh());
+  Serial.print(F(" mAh, "));
+  Serial.print(soc.getTemperature() / 10.0, 1);
+  Serial.print(F(" C"));
+  if (soc.isResting()) {
+    Serial.print(F(", resting"));
+  }
+  Serial.println();
+}
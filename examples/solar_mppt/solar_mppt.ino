@@ -0,0 +1,79 @@
+/*
+ * Solar MPPT example for the Adafruit BQ25798 charger
+ *
+ * Tracks a panel's maximum power point from the host, stepping VINDPM every
+ * 500ms, and prints harvest statistics once a minute. Every ten minutes it
+ * switches between perturb-and-observe, incremental conductance and the
+ * chip's own fractional-VOC tracker, so their average power can be
+ * compared under the same sky.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_MPPT.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_MPPT mppt(&bq);
+
+const char *const mode_names[] = {"P&O", "IncCond", "VOC"};
+bq25798_mppt_mode_t mode = BQ25798_MPPT_PERTURB_OBSERVE;
+
+uint32_t last_report = 0;
+uint32_t last_switch = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 solar MPPT"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  // Keep the setpoint between the panel's knee and just under its Voc
+  mppt.setLimits(12000, 21000);
+  mppt.setDeadband(20);
+  if (!mppt.begin(mode, 200, 500)) {
+    Serial.println(F("Failed to start MPPT"));
+    while (1);
+  }
+
+  Serial.println(F("mode,vindpm_mV,power_mW,peak_mW,avg_mW,energy_mWh,steps"));
+}
+
+void loop() {
+  mppt.update();
+
+  uint32_t now = millis();
+  if (now - last_report >= 60000UL) {
+    last_report = now;
+
+    bq25798_mppt_stats_t stats;
+    mppt.getStats(stats);
+
+    uint32_t avg_mW =
+        stats.elapsed_ms ? (uint32_t)(stats.energy_uJ / stats.elapsed_ms) : 0;
+
+    Serial.print(mode_names[mode]);
+    Serial.print(',');
+    Serial.print(stats.vindpm_mV);
+    Serial.print(',');
+    Serial.print(stats.power_mW);
+    Serial.print(',');
+    Serial.print(stats.peak_mW);
+    Serial.print(',');
+    Serial.print(avg_mW);
+    Serial.print(',');
+    Serial.print((uint32_t)(stats.energy_uJ / 3600000ULL));
+    Serial.print(',');
+    Serial.println(stats.steps);
+  }
+
+  if (now - last_switch >= 600000UL) {
+    last_switch = now;
+    mode = (bq25798_mppt_mode_t)((mode + 1) % 3);
+    mppt.setMode(mode);
+    mppt.resetStats();
+  }
+}
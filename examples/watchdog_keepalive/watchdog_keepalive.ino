@@ -0,0 +1,66 @@
+/*
+ * Watchdog keepalive example for the Adafruit BQ25798 charger
+ *
+ * Runs the charger with a 1 second I2C watchdog. If this sketch hangs, the
+ * chip falls back to its safe defaults on its own; while it runs, the
+ * keepalive service feeds the watchdog just ahead of the timeout and
+ * restores the configuration if an expiry slips through anyway. Health
+ * statistics are printed every 10 seconds.
+ */
+
+#include <Adafruit_BQ25798.h>
+#include <Adafruit_BQ25798_Watchdog.h>
+
+Adafruit_BQ25798 bq;
+Adafruit_BQ25798_Watchdog keepalive(&bq);
+
+uint32_t last_report = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit BQ25798 watchdog keepalive"));
+
+  if (!bq.begin()) {
+    Serial.println(F("Could not find a valid BQ25798 sensor, check wiring!"));
+    while (1);
+  }
+
+  // Serve setting reads and the configuration capture from RAM
+  bq.enableCache();
+
+  // Configure first: begin() captures what the watchdog should protect
+  bq.setChargeLimitA(1.0);
+  bq.setInputLimitA(1.5);
+
+  if (!keepalive.begin(BQ25798_WDT_1S)) {
+    Serial.println(F("Failed to arm the watchdog"));
+    while (1);
+  }
+}
+
+void loop() {
+  keepalive.update();
+
+  if (millis() - last_report < 10000) {
+    return;
+  }
+  last_report = millis();
+
+  bq25798_wdt_health_t health;
+  keepalive.getHealth(health);
+  Serial.print(F("Kicks "));
+  Serial.print(health.kicks);
+  Serial.print(F(", piggybacked "));
+  Serial.print(health.piggybacked);
+  Serial.print(F(", failures "));
+  Serial.print(health.failures);
+  Serial.print(F(", expiries "));
+  Serial.print(health.expiries);
+  Serial.print(F(", restores "));
+  Serial.print(health.restores);
+  Serial.print(F(", longest gap "));
+  Serial.print(health.max_gap_ms);
+  Serial.println(F(" ms"));
+}
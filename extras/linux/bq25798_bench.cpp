@@ -0,0 +1,193 @@
+/*
+ * Transactions-per-second benchmark for the BQ25798 on Linux i2c-dev.
+ *
+ * Compares per-field access against the burst APIs:
+ *   bq25798_bench [/dev/i2c-N | --sim] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_LinuxI2C.h"
+#include "Adafruit_BQ25798_Sim.h"
+
+/*
+ * Forwards to the real transport and counts the transactions it carries
+ */
+class CountingBus : public Adafruit_BQ25798_Transport {
+public:
+  explicit CountingBus(Adafruit_BQ25798_Transport *inner)
+      : bus(inner), transactions(0) {}
+
+  bool begin() {
+    return bus->begin();
+  }
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    transactions++;
+    return bus->readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    transactions++;
+    return bus->writeRegisters(reg, buffer, len);
+  }
+
+  bool recoverBus() {
+    return bus->recoverBus();
+  }
+
+  Adafruit_BQ25798_Transport *bus;
+  unsigned long transactions;
+};
+
+static Adafruit_BQ25798 bq;
+static CountingBus *counter;
+static volatile float sink; // keeps results from being optimized out
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, unsigned long iterations,
+                   unsigned long transactions, double seconds) {
+  printf("%-28s %8.0f ops/s %9.0f transactions/s %5.1f per op\n", name,
+         iterations / seconds, transactions / seconds,
+         (double)transactions / iterations);
+}
+
+/*
+ * Starts the clock and the transaction count for one measurement
+ */
+static void startRun(double &start) {
+  counter->transactions = 0;
+  start = now();
+}
+
+static void benchFieldRead(unsigned long iterations) {
+  double start;
+  startRun(start);
+  for (unsigned long i = 0; i < iterations; i++) {
+    sink += bq.getChargeLimitV();
+  }
+  report("getChargeLimitV", iterations, counter->transactions,
+         now() - start);
+}
+
+static void benchFieldWrite(unsigned long iterations) {
+  double start;
+  startRun(start);
+  for (unsigned long i = 0; i < iterations; i++) {
+    bq.setChargeLimitA((i & 1) ? 1.0f : 1.1f);
+  }
+  report("setChargeLimitA (RMW)", iterations, counter->transactions,
+         now() - start);
+}
+
+static void benchADCPerChannel(unsigned long iterations) {
+  // What reading every ADC channel through its own field would cost
+  static const bq25798_field_t channels[] = {
+      BQ25798_FIELD_IBUS_ADC, BQ25798_FIELD_IBAT_ADC,
+      BQ25798_FIELD_VBUS_ADC, BQ25798_FIELD_VAC1_ADC,
+      BQ25798_FIELD_VAC2_ADC, BQ25798_FIELD_VBAT_ADC,
+      BQ25798_FIELD_VSYS_ADC, BQ25798_FIELD_TS_ADC,
+      BQ25798_FIELD_TDIE_ADC, BQ25798_FIELD_DPLUS_ADC,
+      BQ25798_FIELD_DMINUS_ADC};
+  const uint8_t count = sizeof(channels) / sizeof(channels[0]);
+
+  bq25798_adc_t adc;
+  int32_t value;
+  double start;
+  startRun(start);
+  for (unsigned long i = 0; i < iterations; i++) {
+    for (uint8_t ch = 0; ch < count; ch++) {
+      bq.getField(channels[ch], value);
+      sink += value;
+    }
+  }
+  report("11 per-channel ADC reads", iterations, counter->transactions,
+         now() - start);
+
+  startRun(start);
+  for (unsigned long i = 0; i < iterations; i++) {
+    bq.readAllADC(adc);
+    sink += adc.vbat;
+  }
+  report("readAllADC (22-byte burst)", iterations, counter->transactions,
+         now() - start);
+}
+
+static void benchInterrupt(unsigned long iterations) {
+  double start;
+  startRun(start);
+  for (unsigned long i = 0; i < iterations; i++) {
+    bq.handleInterrupt();
+  }
+  report("handleInterrupt (13 bytes)", iterations, counter->transactions,
+         now() - start);
+}
+
+#ifdef BQ25798_BUS_STATS
+static void printBusStats() {
+  bq25798_bus_stats_t stats;
+  bq.getBusStats(stats);
+
+  printf("\n%lu reads, %lu writes, %lu bytes, %lu errors, %lu us on the bus\n",
+         (unsigned long)stats.total_reads, (unsigned long)stats.total_writes,
+         (unsigned long)stats.total_bytes, (unsigned long)stats.errors,
+         (unsigned long)stats.busy_us);
+
+  printf("reg    reads   writes    bytes\n");
+  for (uint8_t reg = 0; reg < BQ25798_NUM_REGS; reg++) {
+    if (stats.reads[reg] || stats.writes[reg]) {
+      printf("0x%02X %8lu %8lu %8lu\n", reg, (unsigned long)stats.reads[reg],
+             (unsigned long)stats.writes[reg], (unsigned long)stats.bytes[reg]);
+    }
+  }
+
+  printf("latency histogram (us)\n");
+  for (uint8_t b = 0; b < BQ25798_LATENCY_BUCKETS; b++) {
+    if (stats.latency[b]) {
+      printf("  < %6lu: %lu\n", 2UL << b, (unsigned long)stats.latency[b]);
+    }
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  const char *device = argc > 1 ? argv[1] : "/dev/i2c-1";
+  unsigned long iterations = argc > 2 ? strtoul(argv[2], NULL, 0) : 1000;
+
+  Adafruit_BQ25798_Sim sim;
+  Adafruit_BQ25798_LinuxI2C i2c(device);
+  CountingBus bus(&i2c);
+  if (!strcmp(device, "--sim")) {
+    bus.bus = &sim;
+    iterations *= 1000;
+  }
+  counter = &bus;
+
+  if (!bq.begin(&bus)) {
+    fprintf(stderr, "Could not find a BQ25798 on %s\n", device);
+    return 1;
+  }
+
+  printf("BQ25798 bus benchmark on %s, %lu iterations\n", device, iterations);
+#ifdef BQ25798_BUS_STATS
+  bq.resetBusStats();
+#endif
+  benchFieldRead(iterations);
+  benchFieldWrite(iterations);
+  benchADCPerChannel(iterations);
+  benchInterrupt(iterations);
+#ifdef BQ25798_BUS_STATS
+  printBusStats();
+#endif
+
+  return 0;
+}
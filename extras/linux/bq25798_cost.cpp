@@ -0,0 +1,830 @@
+/*
+ * Per-method bus cost and CPU time for the BQ25798 driver, on the host.
+ *
+ * Runs every public Adafruit_BQ25798 method against the in-memory register
+ * map, uncached and with the shadow cache on, and reports the I2C
+ * transactions, bytes moved (register address plus data) and nanoseconds
+ * each call costs, then a few composite scenarios:
+ *   bq25798_cost [--json FILE] [iterations]
+ *
+ * The time includes the mock transport's own work, so it is the driver's
+ * CPU cost plus a small constant rather than a prediction of bus time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_ADCRing.h"
+#include "Adafruit_BQ25798_Sim.h"
+
+/*
+ * Counts what crosses the bus on the way to the register map
+ */
+class CountingBus : public Adafruit_BQ25798_Transport {
+public:
+  CountingBus() : transactions(0), bytes(0) {}
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    transactions++;
+    bytes += 1 + len;
+    return sim.readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    transactions++;
+    bytes += 1 + len;
+    return sim.writeRegisters(reg, buffer, len);
+  }
+
+  bool recoverBus() {
+    return sim.recoverBus();
+  }
+
+  Adafruit_BQ25798_Sim sim;
+  unsigned long transactions;
+  unsigned long bytes;
+};
+
+typedef struct {
+  double transactions; // per call
+  double bytes;        // per call
+  double ns;           // per call
+} bench_cost_t;
+
+typedef struct {
+  const char *name;
+  void (*fn)(uint32_t i);
+} bench_method_t;
+
+typedef struct {
+  const char *name;
+  void (*setup)();
+  void (*fn)(uint32_t i);
+} bench_scenario_t;
+
+static CountingBus bus;
+static Adafruit_BQ25798 bq;
+static bq25798_async_op_t queue[8];
+static Adafruit_BQ25798_ADCBuffer<4> ring;
+static uint8_t config_a[BQ25798_CONFIG_SIZE];
+static uint8_t config_b[BQ25798_CONFIG_SIZE];
+static uint8_t defaults[BQ25798_NUM_REGS];
+static volatile double sink; // keeps results from being optimized out
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Every no-argument getter
+#define BENCH_GETTERS(X)                                                       \
+  X(getMinSystemV)                                                             \
+  X(getMinSystem_mV)                                                           \
+  X(getChargeLimitV)                                                           \
+  X(getChargeLimit_mV)                                                         \
+  X(getChargeLimitA)                                                           \
+  X(getChargeLimit_mA)                                                         \
+  X(getInputLimitV)                                                            \
+  X(getInputLimit_mV)                                                          \
+  X(getInputLimitA)                                                            \
+  X(getInputLimit_mA)                                                          \
+  X(getVBatLowV)                                                               \
+  X(getPrechargeLimitA)                                                        \
+  X(getPrechargeLimit_mA)                                                      \
+  X(getStopOnWDT)                                                              \
+  X(getTerminationA)                                                           \
+  X(getTermination_mA)                                                         \
+  X(getCellCount)                                                              \
+  X(getRechargeDeglitchTime)                                                   \
+  X(getRechargeThreshOffsetV)                                                  \
+  X(getRechargeThreshOffset_mV)                                                \
+  X(getOTGV)                                                                   \
+  X(getOTG_mV)                                                                 \
+  X(getPrechargeTimer)                                                         \
+  X(getOTGLimitA)                                                              \
+  X(getOTGLimit_mA)                                                            \
+  X(getTopOffTimer)                                                            \
+  X(getTrickleChargeTimerEnable)                                               \
+  X(getPrechargeTimerEnable)                                                   \
+  X(getFastChargeTimerEnable)                                                  \
+  X(getFastChargeTimer)                                                        \
+  X(getTimerHalfRateEnable)                                                    \
+  X(getAutoOVPBattDischarge)                                                   \
+  X(getForceBattDischarge)                                                     \
+  X(getChargeEnable)                                                           \
+  X(getICOEnable)                                                              \
+  X(getForceICO)                                                               \
+  X(getHIZMode)                                                                \
+  X(getTerminationEnable)                                                      \
+  X(getBackupModeEnable)                                                       \
+  X(getBackupModeThresh)                                                       \
+  X(getVACOVP)                                                                 \
+  X(getWDTStatus)                                                              \
+  X(getLastWDTReset)                                                           \
+  X(getWDT)                                                                    \
+  X(getForceDPinsDetection)                                                    \
+  X(getAutoDPinsDetection)                                                     \
+  X(getHVDCP12VEnable)                                                         \
+  X(getHVDCP9VEnable)                                                          \
+  X(getHVDCPEnable)                                                            \
+  X(getShipFETmode)                                                            \
+  X(getShipFET10sDelay)                                                        \
+  X(getACenable)                                                               \
+  X(getOTGenable)                                                              \
+  X(getOTGPFM)                                                                 \
+  X(getForwardPFM)                                                             \
+  X(getShipWakeupDelay)                                                        \
+  X(getBATFETLDOprecharge)                                                     \
+  X(getOTGOOA)                                                                 \
+  X(getForwardOOA)                                                             \
+  X(getACDRV2enable)                                                           \
+  X(getACDRV1enable)                                                           \
+  X(getPWMFrequency)                                                           \
+  X(getStatPinEnable)                                                          \
+  X(getVSYSshortProtect)                                                       \
+  X(getVOTG_UVPProtect)                                                        \
+  X(getIBUS_OCPenable)                                                         \
+  X(getVINDPMdetection)                                                        \
+  X(getShipFETpresent)                                                         \
+  X(getBatDischargeSenseEnable)                                                \
+  X(getBatDischargeA)                                                          \
+  X(getIINDPMenable)                                                           \
+  X(getExtILIMpin)                                                             \
+  X(getBatDischargeOCPenable)                                                  \
+  X(getVINDPM_VOCpercent)                                                      \
+  X(getVOCdelay)                                                               \
+  X(getVOCrate)                                                                \
+  X(getMPPTenable)                                                             \
+  X(getThermRegulationThresh)                                                  \
+  X(getThermShutdownThresh)                                                    \
+  X(getVBUSpulldown)                                                           \
+  X(getVAC1pulldown)                                                           \
+  X(getVAC2pulldown)                                                           \
+  X(getBackupACFET1on)                                                         \
+  X(getADCEnable)                                                              \
+  X(getInterruptMask)                                                          \
+  X(asyncPending)                                                              \
+  X(getLastError)
+
+// Setters taking a bool, toggled every call
+#define BENCH_FLAGS(X)                                                         \
+  X(setStopOnWDT)                                                              \
+  X(setTrickleChargeTimerEnable)                                               \
+  X(setPrechargeTimerEnable)                                                   \
+  X(setFastChargeTimerEnable)                                                  \
+  X(setTimerHalfRateEnable)                                                    \
+  X(setAutoOVPBattDischarge)                                                   \
+  X(setForceBattDischarge)                                                     \
+  X(setChargeEnable)                                                           \
+  X(setICOEnable)                                                              \
+  X(setForceICO)                                                               \
+  X(setHIZMode)                                                                \
+  X(setTerminationEnable)                                                      \
+  X(setBackupModeEnable)                                                       \
+  X(setWDTPiggyback)                                                           \
+  X(setForceDPinsDetection)                                                    \
+  X(setAutoDPinsDetection)                                                     \
+  X(setHVDCP12VEnable)                                                         \
+  X(setHVDCP9VEnable)                                                          \
+  X(setHVDCPEnable)                                                            \
+  X(setShipFET10sDelay)                                                        \
+  X(setACenable)                                                               \
+  X(setOTGenable)                                                              \
+  X(setOTGPFM)                                                                 \
+  X(setForwardPFM)                                                             \
+  X(setBATFETLDOprecharge)                                                     \
+  X(setOTGOOA)                                                                 \
+  X(setForwardOOA)                                                             \
+  X(setACDRV2enable)                                                           \
+  X(setACDRV1enable)                                                           \
+  X(setStatPinEnable)                                                          \
+  X(setVSYSshortProtect)                                                       \
+  X(setVOTG_UVPProtect)                                                        \
+  X(setIBUS_OCPenable)                                                         \
+  X(setVINDPMdetection)                                                        \
+  X(setShipFETpresent)                                                         \
+  X(setBatDischargeSenseEnable)                                                \
+  X(setIINDPMenable)                                                           \
+  X(setExtILIMpin)                                                             \
+  X(setBatDischargeOCPenable)                                                  \
+  X(setMPPTenable)                                                             \
+  X(setVBUSpulldown)                                                           \
+  X(setVAC1pulldown)                                                           \
+  X(setVAC2pulldown)                                                           \
+  X(setBackupACFET1on)
+
+// Setters taking an enum, alternating between its first two values
+#define BENCH_ENUMS(X)                                                         \
+  X(setVBatLowV, bq25798_vbat_lowv_t)                                          \
+  X(setCellCount, bq25798_cell_count_t)                                        \
+  X(setRechargeDeglitchTime, bq25798_trechg_time_t)                            \
+  X(setPrechargeTimer, bq25798_prechg_timer_t)                                 \
+  X(setTopOffTimer, bq25798_topoff_timer_t)                                    \
+  X(setFastChargeTimer, bq25798_chg_timer_t)                                   \
+  X(setBackupModeThresh, bq25798_vbus_backup_t)                                \
+  X(setVACOVP, bq25798_vac_ovp_t)                                              \
+  X(setWDT, bq25798_wdt_t)                                                     \
+  X(setShipFETmode, bq25798_sdrv_ctrl_t)                                       \
+  X(setShipWakeupDelay, bq25798_wkup_dly_t)                                    \
+  X(setPWMFrequency, bq25798_pwm_freq_t)                                       \
+  X(setBatDischargeA, bq25798_ibat_reg_t)                                      \
+  X(setVINDPM_VOCpercent, bq25798_voc_pct_t)                                   \
+  X(setVOCdelay, bq25798_voc_dly_t)                                            \
+  X(setVOCrate, bq25798_voc_rate_t)                                            \
+  X(setThermRegulationThresh, bq25798_treg_t)                                  \
+  X(setThermShutdownThresh, bq25798_tshut_t)
+
+// Setters taking a value, alternating between two valid settings
+#define BENCH_VALUES(X)                                                        \
+  X(setMinSystemV, 3.5f, 3.25f)                                                \
+  X(setMinSystem_mV, 3500, 3250)                                               \
+  X(setChargeLimitV, 4.2f, 4.1f)                                               \
+  X(setChargeLimit_mV, 4200, 4100)                                             \
+  X(setChargeLimitA, 1.0f, 1.1f)                                               \
+  X(setChargeLimit_mA, 1000, 1100)                                             \
+  X(setInputLimitV, 4.4f, 4.5f)                                                \
+  X(setInputLimit_mV, 4400, 4500)                                              \
+  X(setInputLimitA, 1.0f, 1.5f)                                                \
+  X(setInputLimit_mA, 1000, 1500)                                              \
+  X(setPrechargeLimitA, 0.12f, 0.2f)                                           \
+  X(setPrechargeLimit_mA, 120, 200)                                            \
+  X(setTerminationA, 0.2f, 0.12f)                                              \
+  X(setTermination_mA, 200, 120)                                               \
+  X(setRechargeThreshOffsetV, 0.2f, 0.3f)                                      \
+  X(setRechargeThreshOffset_mV, 200, 300)                                      \
+  X(setOTGV, 5.0f, 5.1f)                                                       \
+  X(setOTG_mV, 5000, 5100)                                                     \
+  X(setOTGLimitA, 1.0f, 1.5f)                                                  \
+  X(setOTGLimit_mA, 1000, 1500)                                                \
+  X(setInterruptMask, 0, 0xFFFF)
+
+#define BENCH_GET(name)                                                        \
+  static void call_##name(uint32_t) {                                          \
+    sink += bq.name();                                                         \
+  }
+#define BENCH_FLAG(name)                                                       \
+  static void call_##name(uint32_t i) {                                        \
+    bq.name(i & 1);                                                            \
+  }
+#define BENCH_ENUM(name, type)                                                 \
+  static void call_##name(uint32_t i) {                                        \
+    bq.name((type)(i & 1));                                                    \
+  }
+#define BENCH_VALUE(name, a, b)                                                \
+  static void call_##name(uint32_t i) {                                        \
+    bq.name((i & 1) ? a : b);                                                  \
+  }
+#define BENCH_ENTRY(name) {#name, call_##name},
+#define BENCH_ENUM_ENTRY(name, type) BENCH_ENTRY(name)
+#define BENCH_VALUE_ENTRY(name, a, b) BENCH_ENTRY(name)
+
+BENCH_GETTERS(BENCH_GET)
+BENCH_FLAGS(BENCH_FLAG)
+BENCH_ENUMS(BENCH_ENUM)
+BENCH_VALUES(BENCH_VALUE)
+
+static void onState(bool state) {
+  sink += state;
+}
+
+static void onChgStat(bq25798_chg_stat_t state) {
+  sink += state;
+}
+
+static void onNothing() {
+  sink += 1;
+}
+
+static void onFault(uint16_t faults) {
+  sink += faults;
+}
+
+static void onEvent(uint64_t flags) {
+  sink += flags;
+}
+
+static void drain() {
+  while (bq.asyncPending()) {
+    bq.tick();
+  }
+}
+
+static void call_begin(uint32_t) {
+  bq.begin(&bus);
+}
+
+static void call_resetWDT(uint32_t) {
+  bq.resetWDT();
+}
+
+static void call_reset(uint32_t) {
+  bq.reset();
+}
+
+static void call_readAllADC(uint32_t) {
+  bq25798_adc_t adc;
+  bq.readAllADC(adc);
+  sink += adc.vbat;
+}
+
+static void call_readAllADC_fixed(uint32_t) {
+  bq25798_adc_fixed_t adc;
+  bq.readAllADC(adc);
+  sink += adc.vbat;
+}
+
+static void call_getStatus(uint32_t) {
+  bq25798_status_t status;
+  bq.getStatus(status);
+  sink += status.chg_stat;
+}
+
+static void call_configureADC(uint32_t i) {
+  bq.configureADC(true, BQ25798_ADC_RES_15BIT, i & 1);
+}
+
+static void call_disableADC(uint32_t) {
+  bq.disableADC();
+}
+
+static void call_setADCStream(uint32_t i) {
+  bq.setADCStream((i & 1) ? &ring : NULL);
+}
+
+static void call_poll(uint32_t) {
+  bq.setADCStream(&ring);
+  bq.poll();
+  ring.clear();
+}
+
+static void call_handleInterrupt(uint32_t) {
+  uint64_t flags;
+  bq.handleInterrupt(&flags);
+  sink += flags;
+}
+
+static void call_onVBUSPresentChanged(uint32_t) {
+  bq.onVBUSPresentChanged(onState);
+}
+
+static void call_onPowerGoodChanged(uint32_t) {
+  bq.onPowerGoodChanged(onState);
+}
+
+static void call_onChargeStateChanged(uint32_t) {
+  bq.onChargeStateChanged(onChgStat);
+}
+
+static void call_onChargeDone(uint32_t) {
+  bq.onChargeDone(onNothing);
+}
+
+static void call_onWatchdogExpired(uint32_t) {
+  bq.onWatchdogExpired(onNothing);
+}
+
+static void call_onTSHUT(uint32_t) {
+  bq.onTSHUT(onNothing);
+}
+
+static void call_onFault(uint32_t) {
+  bq.onFault(onFault);
+}
+
+static void call_onEvent(uint32_t) {
+  bq.onEvent(onEvent);
+}
+
+#ifdef BQ25798_BUS_STATS
+static void call_getBusStats(uint32_t) {
+  static bq25798_bus_stats_t stats;
+  bq.getBusStats(stats);
+  sink += stats.total_reads;
+}
+
+static void call_resetBusStats(uint32_t) {
+  bq.resetBusStats();
+}
+#endif
+
+static void call_abortBatch(uint32_t) {
+  bq.beginBatch();
+  bq.abortBatch();
+}
+
+static void call_commit(uint32_t i) {
+  bq.beginBatch();
+  bq.setChargeLimit_mA((i & 1) ? 1000 : 1100);
+  bq.setInputLimit_mA((i & 1) ? 1000 : 1500);
+  bq.commit();
+}
+
+static void call_saveConfig(uint32_t) {
+  uint8_t config[BQ25798_CONFIG_SIZE];
+  bq.saveConfig(config);
+  sink += config[1];
+}
+
+static void call_restoreConfig(uint32_t i) {
+  bq.restoreConfig((i & 1) ? config_a : config_b);
+}
+
+static void call_crc16(uint32_t) {
+  sink += Adafruit_BQ25798::crc16(config_a, BQ25798_CONFIG_SIZE - 2);
+}
+
+static void call_getField(uint32_t) {
+  sink += bq.getField(BQ25798_FIELD_VREG);
+}
+
+static void call_getField_ref(uint32_t) {
+  int32_t value;
+  bq.getField(BQ25798_FIELD_VREG, value);
+  sink += value;
+}
+
+static void call_setField(uint32_t i) {
+  bq.setField(BQ25798_FIELD_VREG, (i & 1) ? 4200 : 4100);
+}
+
+static void call_getFields(uint32_t) {
+  static const bq25798_field_t fields[] = {
+      BQ25798_FIELD_VSYSMIN, BQ25798_FIELD_VREG, BQ25798_FIELD_ICHG,
+      BQ25798_FIELD_VINDPM, BQ25798_FIELD_IINDPM};
+  int32_t values[5];
+  bq.getFields(fields, values, 5);
+  sink += values[4];
+}
+
+static void call_getFieldInfo(uint32_t) {
+  bq25798_field_desc_t desc;
+  Adafruit_BQ25798::getFieldInfo(BQ25798_FIELD_VREG, desc);
+  sink += desc.max;
+}
+
+static void call_getFieldName(uint32_t) {
+  char name[24];
+  Adafruit_BQ25798::getFieldName(BQ25798_FIELD_VREG, name, sizeof(name));
+  sink += name[0];
+}
+
+static void call_findField(uint32_t) {
+  sink += Adafruit_BQ25798::findField("VREG");
+}
+
+static void call_setAsyncQueue(uint32_t) {
+  bq.setAsyncQueue(queue, 8);
+}
+
+static void call_readAsync(uint32_t) {
+  uint8_t buffer[2];
+  bq.readAsync(BQ25798_REG_CHARGE_VOLTAGE_LIMIT, buffer, 2);
+  drain();
+}
+
+static void call_writeAsync(uint32_t i) {
+  const uint8_t buffer[2] = {0x01, (uint8_t)((i & 1) ? 0xA4 : 0x9A)};
+  bq.writeAsync(BQ25798_REG_CHARGE_VOLTAGE_LIMIT, buffer, 2);
+  drain();
+}
+
+static void call_getFieldAsync(uint32_t) {
+  int32_t value;
+  bq.getFieldAsync(BQ25798_FIELD_VREG, &value);
+  drain();
+}
+
+static void call_setFieldAsync(uint32_t i) {
+  bq.setFieldAsync(BQ25798_FIELD_VREG, (i & 1) ? 4200 : 4100);
+  drain();
+}
+
+static void call_getStatusAsync(uint32_t) {
+  bq25798_status_t status;
+  bq.getStatusAsync(&status);
+  drain();
+}
+
+static void call_readAllADCAsync(uint32_t) {
+  bq25798_adc_fixed_t adc;
+  bq.readAllADCAsync(&adc);
+  drain();
+}
+
+static void call_tick(uint32_t) {
+  bq.tick();
+}
+
+static void call_setRetryPolicy(uint32_t i) {
+  bq.setRetryPolicy((i & 1) ? 3 : 1);
+}
+
+static void call_enableCache(uint32_t i) {
+  bq.enableCache(i & 1);
+}
+
+static void call_resyncCache(uint32_t) {
+  bq.resyncCache();
+}
+
+static void call_invalidateCache(uint32_t) {
+  bq.invalidateCache();
+}
+
+static const bench_method_t getters[] = {BENCH_GETTERS(BENCH_ENTRY)};
+static const bench_method_t flags[] = {BENCH_FLAGS(BENCH_ENTRY)};
+static const bench_method_t enums[] = {BENCH_ENUMS(BENCH_ENUM_ENTRY)};
+static const bench_method_t values[] = {BENCH_VALUES(BENCH_VALUE_ENTRY)};
+
+static const bench_method_t others[] = {
+    {"begin(Transport *)", call_begin},
+    {"resetWDT", call_resetWDT},
+    {"reset", call_reset},
+    {"readAllADC(adc_t)", call_readAllADC},
+    {"readAllADC(adc_fixed_t)", call_readAllADC_fixed},
+    {"getStatus", call_getStatus},
+    {"configureADC", call_configureADC},
+    {"disableADC", call_disableADC},
+    {"setADCStream", call_setADCStream},
+    {"poll", call_poll},
+    {"handleInterrupt", call_handleInterrupt},
+    {"onVBUSPresentChanged", call_onVBUSPresentChanged},
+    {"onPowerGoodChanged", call_onPowerGoodChanged},
+    {"onChargeStateChanged", call_onChargeStateChanged},
+    {"onChargeDone", call_onChargeDone},
+    {"onWatchdogExpired", call_onWatchdogExpired},
+    {"onTSHUT", call_onTSHUT},
+    {"onFault", call_onFault},
+    {"onEvent", call_onEvent},
+#ifdef BQ25798_BUS_STATS
+    {"getBusStats", call_getBusStats},
+    {"resetBusStats", call_resetBusStats},
+#endif
+    {"beginBatch+abortBatch", call_abortBatch},
+    {"beginBatch+2 setters+commit", call_commit},
+    {"saveConfig", call_saveConfig},
+    {"restoreConfig", call_restoreConfig},
+    {"crc16", call_crc16},
+    {"getField", call_getField},
+    {"getField(field, value)", call_getField_ref},
+    {"setField", call_setField},
+    {"getFields (5 fields)", call_getFields},
+    {"getFieldInfo", call_getFieldInfo},
+    {"getFieldName", call_getFieldName},
+    {"findField", call_findField},
+    {"setAsyncQueue", call_setAsyncQueue},
+    {"readAsync+tick", call_readAsync},
+    {"writeAsync+tick", call_writeAsync},
+    {"getFieldAsync+tick", call_getFieldAsync},
+    {"setFieldAsync+tick", call_setFieldAsync},
+    {"getStatusAsync+tick", call_getStatusAsync},
+    {"readAllADCAsync+tick", call_readAllADCAsync},
+    {"tick (empty queue)", call_tick},
+    {"setRetryPolicy", call_setRetryPolicy},
+    {"enableCache", call_enableCache},
+    {"resyncCache", call_resyncCache},
+    {"invalidateCache", call_invalidateCache},
+};
+
+#define COUNT(table) (sizeof(table) / sizeof(table[0]))
+#define NUM_METHODS                                                            \
+  (COUNT(others) + COUNT(getters) + COUNT(flags) + COUNT(enums) + COUNT(values))
+
+// The state a sketch is in after setup(): started, ADC converting
+static void prepare(bool cached) {
+  bus.sim.powerOnReset();
+  bq.begin(&bus);
+  bq.configureADC(true, BQ25798_ADC_RES_15BIT, false);
+  bq.setAsyncQueue(queue, 8);
+  bq.enableCache(cached);
+}
+
+static void prepareUncached() {
+  prepare(false);
+}
+
+static void prepareCached() {
+  prepare(true);
+}
+
+static void prepareStorm() {
+  prepare(true);
+  bq.onVBUSPresentChanged(onState);
+  bq.onPowerGoodChanged(onState);
+  bq.onChargeStateChanged(onChgStat);
+  bq.onChargeDone(onNothing);
+  bq.onWatchdogExpired(onNothing);
+  bq.onTSHUT(onNothing);
+  bq.onFault(onFault);
+  bq.onEvent(onEvent);
+}
+
+static void prepareBoot() {
+  bus.sim.powerOnReset();
+}
+
+static void bootConfig() {
+  bq.begin(&bus);
+  bq.setCellCount(BQ25798_CELL_COUNT_2S);
+  bq.setChargeLimit_mV(8400);
+  bq.setChargeLimit_mA(2000);
+  bq.setInputLimit_mA(3000);
+  bq.setInputLimit_mV(4400);
+  bq.setMinSystem_mV(7000);
+  bq.setTermination_mA(200);
+  bq.setPrechargeLimit_mA(200);
+  bq.setWDT(BQ25798_WDT_40S);
+  bq.configureADC(true, BQ25798_ADC_RES_15BIT, false);
+  bq.setInterruptMask(~(BQ25798_FLAG_VBUS_PRESENT | BQ25798_FLAG_CHG));
+  bq.enableCache();
+}
+
+static void scenarioBoot(uint32_t) {
+  prepareBoot();
+  bootConfig();
+}
+
+static void scenarioBootBatched(uint32_t) {
+  prepareBoot();
+  bq.begin(&bus);
+  bq.beginBatch();
+  bq.setCellCount(BQ25798_CELL_COUNT_2S);
+  bq.setChargeLimit_mV(8400);
+  bq.setChargeLimit_mA(2000);
+  bq.setInputLimit_mA(3000);
+  bq.setInputLimit_mV(4400);
+  bq.setMinSystem_mV(7000);
+  bq.setTermination_mA(200);
+  bq.setPrechargeLimit_mA(200);
+  bq.setWDT(BQ25798_WDT_40S);
+  bq.commit();
+  bq.configureADC(true, BQ25798_ADC_RES_15BIT, false);
+  bq.setInterruptMask(~(BQ25798_FLAG_VBUS_PRESENT | BQ25798_FLAG_CHG));
+  bq.enableCache();
+}
+
+// One pass of a typical 1 Hz loop: status, ADC, events, a setting, WDT kick
+static void scenarioTelemetry(uint32_t) {
+  bq25798_status_t status;
+  bq25798_adc_fixed_t adc;
+  bq.getStatus(status);
+  bq.readAllADC(adc);
+  bq.handleInterrupt();
+  sink += bq.getChargeLimit_mA();
+  bq.resetWDT();
+  sink += adc.vbat + status.chg_stat;
+}
+
+// Every flag at once, as after a watchdog expiry: the chip has reloaded its
+// control registers, so the handler resyncs and the config is put back
+static void scenarioFaultStorm(uint32_t) {
+  for (uint8_t reg = 0; reg <= BQ25798_REG_NTC_CONTROL_1; reg++) {
+    bus.sim.poke(reg, defaults[reg]);
+  }
+  bus.sim.raiseFlags(~0ULL);
+
+  bq25798_status_t status;
+  bq.handleInterrupt();
+  bq.getStatus(status);
+  bq.restoreConfig(config_a);
+  sink += status.chg_stat;
+}
+
+static const bench_scenario_t scenarios[] = {
+    {"boot_config", prepareBoot, scenarioBoot},
+    {"boot_config_batched", prepareBoot, scenarioBootBatched},
+    {"telemetry_1hz", prepareUncached, scenarioTelemetry},
+    {"telemetry_1hz_cached", prepareCached, scenarioTelemetry},
+    {"fault_storm", prepareStorm, scenarioFaultStorm},
+};
+
+#define NUM_SCENARIOS COUNT(scenarios)
+
+static bench_cost_t measure(void (*setup)(), void (*fn)(uint32_t),
+                            unsigned long iterations) {
+  setup();
+  fn(0); // first call may fill the shadow cache or queue
+  bus.transactions = 0;
+  bus.bytes = 0;
+
+  double start = now();
+  for (unsigned long i = 1; i <= iterations; i++) {
+    fn(i);
+  }
+  double seconds = now() - start;
+
+  bench_cost_t cost;
+  cost.transactions = (double)bus.transactions / iterations;
+  cost.bytes = (double)bus.bytes / iterations;
+  cost.ns = seconds * 1e9 / iterations;
+  return cost;
+}
+
+static void printCost(const char *name, const bench_cost_t &cost) {
+  printf("%-32s %7.2f %7.2f %9.1f", name, cost.transactions, cost.bytes,
+         cost.ns);
+}
+
+static void writeCost(FILE *json, const bench_cost_t &cost) {
+  fprintf(json, "\"transactions\": %.2f, \"bytes\": %.2f, \"ns\": %.2f",
+          cost.transactions, cost.bytes, cost.ns);
+}
+
+int main(int argc, char **argv) {
+  const char *json_path = NULL;
+  unsigned long iterations = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+      json_path = argv[++i];
+    } else {
+      iterations = strtoul(argv[i], NULL, 0);
+    }
+  }
+  if (!iterations) {
+    fprintf(stderr, "usage: %s [--json FILE] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  // Two configs for restoreConfig() to alternate between, and the power-on
+  // register values the fault storm reloads
+  prepare(false);
+  for (uint8_t reg = 0; reg < BQ25798_NUM_REGS; reg++) {
+    defaults[reg] = bus.sim.peek(reg);
+  }
+  bootConfig();
+  bq.saveConfig(config_a);
+  bq.setChargeLimit_mV(8300);
+  bq.setInputLimit_mA(1500);
+  bq.saveConfig(config_b);
+
+  static const bench_method_t *methods[NUM_METHODS];
+  size_t count = 0;
+  const bench_method_t *tables[] = {others, getters, flags, enums, values};
+  const size_t sizes[] = {COUNT(others), COUNT(getters), COUNT(flags),
+                          COUNT(enums), COUNT(values)};
+  for (size_t t = 0; t < COUNT(tables); t++) {
+    for (size_t m = 0; m < sizes[t]; m++) {
+      methods[count++] = &tables[t][m];
+    }
+  }
+
+  static bench_cost_t uncached[NUM_METHODS];
+  static bench_cost_t cached[NUM_METHODS];
+  static bench_cost_t composite[NUM_SCENARIOS];
+
+  printf("BQ25798 per-method cost, %lu iterations, per call\n", iterations);
+  printf("%-32s %7s %7s %9s %7s %7s %9s\n", "method", "xfers", "bytes", "ns",
+         "cached", "bytes", "ns");
+  for (size_t m = 0; m < NUM_METHODS; m++) {
+    uncached[m] = measure(prepareUncached, methods[m]->fn, iterations);
+    cached[m] = measure(prepareCached, methods[m]->fn, iterations);
+    printCost(methods[m]->name, uncached[m]);
+    printf(" %7.2f %7.2f %9.1f\n", cached[m].transactions, cached[m].bytes,
+           cached[m].ns);
+  }
+
+  printf("\n%-32s %7s %7s %9s\n", "scenario", "xfers", "bytes", "ns");
+  for (size_t s = 0; s < NUM_SCENARIOS; s++) {
+    composite[s] = measure(scenarios[s].setup, scenarios[s].fn, iterations);
+    printCost(scenarios[s].name, composite[s]);
+    printf("\n");
+  }
+
+  if (!json_path) {
+    return 0;
+  }
+  FILE *json = fopen(json_path, "w");
+  if (!json) {
+    perror(json_path);
+    return 1;
+  }
+
+  fprintf(json, "{\n  \"library\": \"Adafruit_BQ25798\",\n");
+  fprintf(json, "  \"iterations\": %lu,\n", iterations);
+#ifdef BQ25798_BUS_STATS
+  fprintf(json, "  \"bus_stats\": true,\n");
+#else
+  fprintf(json, "  \"bus_stats\": false,\n");
+#endif
+  fprintf(json, "  \"methods\": [\n");
+  for (size_t m = 0; m < NUM_METHODS; m++) {
+    fprintf(json, "    {\"name\": \"%s\", ", methods[m]->name);
+    writeCost(json, uncached[m]);
+    fprintf(json, ", \"cached\": {");
+    writeCost(json, cached[m]);
+    fprintf(json, "}}%s\n", m + 1 < NUM_METHODS ? "," : "");
+  }
+  fprintf(json, "  ],\n  \"scenarios\": [\n");
+  for (size_t s = 0; s < NUM_SCENARIOS; s++) {
+    fprintf(json, "    {\"name\": \"%s\", ", scenarios[s].name);
+    writeCost(json, composite[s]);
+    fprintf(json, "}%s\n", s + 1 < NUM_SCENARIOS ? "," : "");
+  }
+  fprintf(json, "  ]\n}\n");
+  fclose(json);
+  return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Minimal assertion helpers for the BQ25798 host tests. Each test file is
+ * its own executable and exits non-zero if any check failed, which is all
+ * ctest needs.
+ */
+
+#ifndef BQ25798_TEST_H
+#define BQ25798_TEST_H
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      test_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                             \
+  do {                                                                         \
+    long long a_ = (long long)(actual);                                        \
+    long long e_ = (long long)(expected);                                      \
+    if (a_ != e_) {                                                            \
+      fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__,          \
+              __LINE__, #actual, a_, e_);                                      \
+      test_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                \
+  do {                                                                         \
+    double a_ = (double)(actual);                                              \
+    double e_ = (double)(expected);                                            \
+    if (a_ - e_ > (tolerance) || e_ - a_ > (tolerance)) {                      \
+      fprintf(stderr, "%s:%d: %s is %g, expected %g\n", __FILE__, __LINE__,    \
+              #actual, a_, e_);                                                \
+      test_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define RUN(test)                                                              \
+  do {                                                                         \
+    int before_ = test_failures;                                               \
+    test();                                                                    \
+    printf("%s %s\n", test_failures == before_ ? "PASS" : "FAIL", #test);      \
+  } while (0)
+
+#endif // BQ25798_TEST_H
@@ -0,0 +1,178 @@
+/*
+ * ADC sample ring, poll() streaming and readAllADC() decoding.
+ */
+
+#include <string.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_ADCRing.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+static bq25798_adc_sample_t sampleAt(uint32_t timestamp_us) {
+  bq25798_adc_sample_t sample;
+  memset(&sample, 0, sizeof(sample));
+  sample.timestamp_us = timestamp_us;
+  return sample;
+}
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  bq.setADCStream(NULL);
+  sim.poke16(BQ25798_REG_IBUS_ADC, (uint16_t)-250);
+  sim.poke16(BQ25798_REG_VBUS_ADC, 5000);
+  sim.poke16(BQ25798_REG_VBAT_ADC, 3700);
+  sim.poke16(BQ25798_REG_VSYS_ADC, 3800);
+}
+
+static void testRingWrapsAround() {
+  Adafruit_BQ25798_ADCBuffer<4> ring;
+  CHECK_EQ(ring.capacity(), 4);
+
+  // Indices run well past the capacity; order must survive every wrap
+  uint32_t next_in = 0, next_out = 0;
+  for (uint8_t round = 0; round < 10; round++) {
+    for (uint8_t i = 0; i < 3; i++) {
+      CHECK(ring.push(sampleAt(next_in++)));
+    }
+    CHECK_EQ(ring.available(), 3);
+    bq25798_adc_sample_t sample;
+    while (ring.pop(sample)) {
+      CHECK_EQ(sample.timestamp_us, next_out++);
+    }
+  }
+  CHECK_EQ(next_out, 30);
+  CHECK_EQ(ring.dropped(), 0);
+}
+
+static void testRingFullCountsOverruns() {
+  Adafruit_BQ25798_ADCBuffer<4> ring;
+  for (uint32_t i = 0; i < 4; i++) {
+    CHECK(ring.push(sampleAt(i)));
+  }
+  CHECK(!ring.push(sampleAt(4)));
+  CHECK(!ring.push(sampleAt(5)));
+  CHECK_EQ(ring.available(), 4);
+  CHECK_EQ(ring.dropped(), 2);
+
+  // peek() leaves the oldest sample in place
+  bq25798_adc_sample_t sample;
+  CHECK(ring.peek(sample));
+  CHECK_EQ(sample.timestamp_us, 0);
+  CHECK_EQ(ring.available(), 4);
+
+  // A freed slot takes the next push, the dropped ones stay gone
+  CHECK(ring.pop(sample));
+  CHECK_EQ(sample.timestamp_us, 0);
+  CHECK(ring.push(sampleAt(6)));
+  static const uint32_t expected[] = {1, 2, 3, 6};
+  for (uint8_t i = 0; i < 4; i++) {
+    CHECK(ring.pop(sample));
+    CHECK_EQ(sample.timestamp_us, expected[i]);
+  }
+  CHECK(!ring.pop(sample));
+  CHECK(!ring.peek(sample));
+
+  ring.clear();
+  CHECK_EQ(ring.dropped(), 0);
+  CHECK_EQ(ring.available(), 0);
+}
+
+static void testPollPushesDecodedSamples() {
+  setup();
+  Adafruit_BQ25798_ADCBuffer<4> ring;
+  CHECK(!bq.poll()); // no stream set yet
+
+  bq.setADCStream(&ring);
+  CHECK(bq.configureADC(true, BQ25798_ADC_RES_15BIT, false,
+                        BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_VBAT));
+  sim.resetCounts();
+
+  uint32_t before = micros();
+  CHECK(bq.poll());
+  uint32_t after = micros();
+  CHECK_EQ(sim.readCount(), 1); // IBUS through VBAT in one burst
+  CHECK_EQ(sim.writeCount(), 0);
+
+  bq25798_adc_sample_t sample;
+  CHECK(ring.pop(sample));
+  CHECK(sample.timestamp_us - before <= after - before);
+  CHECK_EQ(sample.channels, BQ25798_ADC_CH_IBUS | BQ25798_ADC_CH_VBAT);
+  CHECK_EQ(sample.adc.ibus, -250);
+  CHECK_EQ(sample.adc.vbat, 3700);
+  CHECK_EQ(sample.adc.vbus, 0); // inside the burst but not selected
+  CHECK_EQ(sample.adc.vsys, 0);
+}
+
+static void testPollOneShotWaitsForConversion() {
+  setup();
+  Adafruit_BQ25798_ADCBuffer<4> ring;
+  bq.setADCStream(&ring);
+  CHECK(bq.configureADC(false, BQ25798_ADC_RES_12BIT, false,
+                        BQ25798_ADC_CH_VBUS));
+
+  // Conversion still running: ADC_EN has not cleared yet
+  uint8_t control = sim.peek(BQ25798_REG_ADC_CONTROL);
+  sim.poke(BQ25798_REG_ADC_CONTROL, control | 0x80);
+  CHECK(!bq.poll());
+  CHECK_EQ(ring.available(), 0);
+
+  // Done: one sample, and the next conversion is started
+  sim.poke(BQ25798_REG_ADC_CONTROL, control);
+  sim.resetCounts();
+  CHECK(bq.poll());
+  CHECK_EQ(sim.writeCount(), 1);
+  bq25798_adc_sample_t sample;
+  CHECK(ring.pop(sample));
+  CHECK_EQ(sample.adc.vbus, 5000);
+}
+
+static void testPollReportsFullRing() {
+  setup();
+  Adafruit_BQ25798_ADCBuffer<2> ring;
+  bq.setADCStream(&ring);
+  CHECK(bq.configureADC(true));
+  CHECK(bq.poll());
+  CHECK(bq.poll());
+  CHECK(!bq.poll());
+  CHECK_EQ(ring.dropped(), 1);
+}
+
+static void testReadAllADCSigns() {
+  setup();
+  sim.poke16(BQ25798_REG_IBAT_ADC, (uint16_t)-1000);
+  sim.poke16(BQ25798_REG_TDIE_ADC, (uint16_t)-50); // 0.5C per LSB
+
+  bq25798_adc_fixed_t fixed;
+  CHECK(bq.readAllADC(fixed));
+  CHECK_EQ(fixed.ibus, -250);
+  CHECK_EQ(fixed.ibat, -1000);
+  CHECK_EQ(fixed.tdie, -250);
+  CHECK_EQ(fixed.vbus, 5000);
+
+  bq25798_adc_t adc;
+  CHECK(bq.readAllADC(adc));
+  CHECK_NEAR(adc.ibus, -0.25, 0.0001);
+  CHECK_NEAR(adc.ibat, -1.0, 0.0001);
+  CHECK_NEAR(adc.tdie, -25.0, 0.001);
+
+  sim.poke16(BQ25798_REG_IBAT_ADC, 1500);
+  sim.poke16(BQ25798_REG_TDIE_ADC, 70);
+  CHECK(bq.readAllADC(fixed));
+  CHECK_EQ(fixed.ibat, 1500);
+  CHECK_EQ(fixed.tdie, 350);
+}
+
+int main() {
+  RUN(testRingWrapsAround);
+  RUN(testRingFullCountsOverruns);
+  RUN(testPollPushesDecodedSamples);
+  RUN(testPollOneShotWaitsForConversion);
+  RUN(testPollReportsFullRing);
+  RUN(testReadAllADCSigns);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Dual-input arbiter: break-before-make on EN_ACDRV1/EN_ACDRV2 with the dead
+ * time, brownout debounce and the power-good check after a switch.
+ */
+
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Arbiter.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+#define ACDRV_MASK 0xC0 // EN_ACDRV2, EN_ACDRV1
+
+/*
+ * Sim that records every CHARGER_CONTROL_4 write and flags any that would
+ * have both pairs on
+ */
+class ACDRVSim : public Adafruit_BQ25798_Sim {
+public:
+  ACDRVSim() : logged(0), overlap(false) {}
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    if (reg <= BQ25798_REG_CHARGER_CONTROL_4 &&
+        reg + len > BQ25798_REG_CHARGER_CONTROL_4) {
+      uint8_t value = buffer[BQ25798_REG_CHARGER_CONTROL_4 - reg];
+      if ((value & ACDRV_MASK) == ACDRV_MASK) {
+        overlap = true;
+      }
+      if (logged < 8) {
+        drv[logged] = value & ACDRV_MASK;
+        when[logged] = millis();
+        logged++;
+      }
+    }
+    return Adafruit_BQ25798_Sim::writeRegisters(reg, buffer, len);
+  }
+
+  uint8_t drv[8];
+  uint32_t when[8];
+  uint8_t logged;
+  bool overlap;
+};
+
+static ACDRVSim sim;
+static Adafruit_BQ25798 bq;
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  sim.poke(BQ25798_REG_CHARGER_STATUS_3, 0xC0); // ACRB1, ACRB2 fitted
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, 0x0E); // PG, AC2 and AC1 present
+  sim.poke16(BQ25798_REG_VAC1_ADC, 9000);
+  sim.poke16(BQ25798_REG_VAC2_ADC, 5000);
+  sim.logged = 0;
+  sim.overlap = false;
+}
+
+static void sleepMs(uint32_t ms) {
+  struct timespec ts = {0, (long)ms * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+static void testBreakBeforeMake() {
+  setup();
+  Adafruit_BQ25798_Arbiter arbiter(&bq);
+  CHECK(arbiter.begin(BQ25798_ARBITER_HIGHER_VOLTAGE, 0));
+  arbiter.setDwell(0);
+  arbiter.setDeadTime(20);
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_NONE);
+
+  // Nothing to break: the first input comes straight up
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+  CHECK_EQ(sim.logged, 1);
+  CHECK_EQ(sim.drv[0], 0x40);
+
+  // VAC2 clears the hysteresis: break now, make after the dead time
+  sim.poke16(BQ25798_REG_VAC2_ADC, 12000);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_NONE);
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_CONTROL_4) & ACDRV_MASK, 0);
+  CHECK(arbiter.update());
+  CHECK_EQ(sim.logged, 2);
+
+  sleepMs(25);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC2);
+  CHECK_EQ(sim.logged, 3);
+  CHECK_EQ(sim.drv[1], 0x00);
+  CHECK_EQ(sim.drv[2], 0x80);
+  CHECK(sim.when[2] - sim.when[1] >= 20);
+  CHECK(!sim.overlap);
+
+  bq25798_arbiter_stats_t stats;
+  arbiter.getStats(stats);
+  CHECK_EQ(stats.switches, 2);
+  CHECK_EQ(stats.vac2_mV, 12000);
+}
+
+static void testBothOnAtBeginFixedUp() {
+  setup();
+  uint8_t control = sim.peek(BQ25798_REG_CHARGER_CONTROL_4);
+  sim.poke(BQ25798_REG_CHARGER_CONTROL_4, control | ACDRV_MASK);
+
+  Adafruit_BQ25798_Arbiter arbiter(&bq);
+  CHECK(arbiter.begin(BQ25798_ARBITER_HIGHER_VOLTAGE, 0));
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_CONTROL_4) & ACDRV_MASK, 0x40);
+  CHECK(!sim.overlap);
+
+  // A missing pair is refused
+  sim.poke(BQ25798_REG_CHARGER_STATUS_3, 0x40);
+  Adafruit_BQ25798_Arbiter single(&bq);
+  CHECK(!single.begin());
+}
+
+static void testBrownoutDebounce() {
+  setup();
+  Adafruit_BQ25798_Arbiter arbiter(&bq);
+  CHECK(arbiter.begin(BQ25798_ARBITER_HIGHER_VOLTAGE, 0));
+  arbiter.setDebounce(0, 50);
+  arbiter.setDeadTime(0);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+
+  // A dip shorter than the brownout time is ridden out
+  sim.poke16(BQ25798_REG_VAC1_ADC, 3000);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+  sim.poke16(BQ25798_REG_VAC1_ADC, 9000);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+
+  // A longer one gives the input up, inside the dwell time
+  sim.poke16(BQ25798_REG_VAC1_ADC, 3000);
+  CHECK(arbiter.update());
+  sleepMs(60);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC2);
+  CHECK(!sim.overlap);
+
+  bq25798_arbiter_stats_t stats;
+  arbiter.getStats(stats);
+  CHECK_EQ(stats.dips, 1);
+  CHECK_EQ(stats.brownouts, 1);
+  CHECK_EQ(stats.switches, 2);
+}
+
+static void testPowerGoodMustFollow() {
+  setup();
+  Adafruit_BQ25798_Arbiter arbiter(&bq);
+  CHECK(arbiter.begin(BQ25798_ARBITER_HIGHER_VOLTAGE, 0));
+  arbiter.setDebounce(30, 200);
+  arbiter.setDeadTime(0);
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, 0x06); // present, not power good
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+
+  // Within the qualify time it is given the benefit of the doubt
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC1);
+
+  sleepMs(35);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC2);
+  bq25798_arbiter_stats_t stats;
+  arbiter.getStats(stats);
+  CHECK_EQ(stats.failed, 1);
+
+  // Power good on the new input verifies it
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, 0x0E);
+  sleepMs(35);
+  CHECK(arbiter.update());
+  CHECK_EQ(arbiter.getActive(), BQ25798_INPUT_VAC2);
+  arbiter.getStats(stats);
+  CHECK_EQ(stats.failed, 1);
+  CHECK(!sim.overlap);
+}
+
+static void testBeginAfterGlitch() {
+  // ERR_BUS left behind by a failed read must not fail the cached reads
+  // begin() checks with getLastError()
+  setup();
+  CHECK(bq.enableCache(true));
+  bq.setRetryPolicy(1);
+  bq25798_status_t status;
+  sim.failTransfers(1);
+  CHECK(!bq.getStatus(status));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUS);
+
+  sim.poke(BQ25798_REG_CHARGER_STATUS_3, 0xC0);
+  Adafruit_BQ25798_Arbiter arbiter(&bq);
+  CHECK(arbiter.begin(BQ25798_ARBITER_HIGHER_VOLTAGE, 0));
+}
+
+int main() {
+  RUN(testBreakBeforeMake);
+  RUN(testBothOnAtBeginFixedUp);
+  RUN(testBrownoutDebounce);
+  RUN(testPowerGoodMustFollow);
+  RUN(testBeginAfterGlitch);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Async queue against a transport whose transfers stay in flight until the
+ * test completes them, and the bounded wait on a transfer that never ends.
+ */
+
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+static bq25798_async_op_t ops[4];
+
+static uint8_t callbacks;
+static bool callback_ok;
+
+static void done(bool ok, void *context) {
+  (void)context;
+  callbacks++;
+  callback_ok = ok;
+}
+
+static void setup(bool cached) {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.enableCache(cached));
+  bq.setAsyncQueue(ops, 4);
+  sim.deferTransfers(true);
+  sim.resetCounts();
+  callbacks = 0;
+  callback_ok = false;
+}
+
+static void sleepMs(uint32_t ms) {
+  struct timespec ts = {0, (long)ms * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+static void testTickOnlyPolls() {
+  setup(false);
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, 0x08); // PG_STAT
+
+  bq25798_status_t status;
+  CHECK(bq.getStatusAsync(&status, done));
+  CHECK(bq.tick());
+  CHECK(bq.tick());
+  CHECK_EQ(sim.readCount(), 0); // started, not yet on the "bus"
+  CHECK_EQ(callbacks, 0);
+
+  CHECK(sim.completeTransfer());
+  CHECK_EQ(sim.readCount(), 1);
+  CHECK(!bq.tick());
+  CHECK_EQ(callbacks, 1);
+  CHECK(callback_ok);
+  CHECK(status.power_good);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+static void testSyncCallTimesOutBehindTransfer() {
+  setup(false);
+  bq25798_status_t status;
+  CHECK(bq.getStatusAsync(&status));
+  CHECK(bq.tick());
+
+  // The sync call gives up instead of spinning on the stuck transfer
+  struct timespec before, after;
+  clock_gettime(CLOCK_MONOTONIC, &before);
+  CHECK_EQ(bq.getChargeLimit_mV(), 0);
+  clock_gettime(CLOCK_MONOTONIC, &after);
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_TIMEOUT);
+  long waited_us = (after.tv_sec - before.tv_sec) * 1000000L +
+                   (after.tv_nsec - before.tv_nsec) / 1000;
+  CHECK(waited_us >= BQ25798_XFER_TIMEOUT_US);
+  CHECK_EQ(sim.readCount(), 0);
+
+  CHECK(sim.completeTransfer());
+  CHECK(!bq.tick());
+  CHECK_EQ(bq.getChargeLimit_mV(), 4200);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+static void testTickTimesOutStuckTransfer() {
+  setup(false);
+  bq25798_status_t status;
+  CHECK(bq.getStatusAsync(&status, done));
+  CHECK(bq.tick());
+
+  sleepMs(BQ25798_XFER_TIMEOUT_US / 1000 + 5);
+  CHECK(bq.tick());
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_TIMEOUT);
+  CHECK_EQ(bq.asyncPending(), 1); // the transport still owns the buffer
+  CHECK_EQ(callbacks, 0);
+
+  // A late completion still fails the op, and is not retried
+  CHECK(sim.completeTransfer());
+  CHECK(!bq.tick());
+  CHECK_EQ(callbacks, 1);
+  CHECK(!callback_ok);
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_TIMEOUT);
+  CHECK_EQ(sim.readCount(), 1);
+}
+
+static void testFieldWriteIsTwoTransfers() {
+  setup(false);
+  CHECK(bq.setFieldAsync(BQ25798_FIELD_VREG, 4100, done));
+
+  CHECK(bq.tick());
+  CHECK(sim.completeTransfer()); // read half
+  CHECK(bq.tick());
+  CHECK(bq.tick());
+  CHECK_EQ(sim.writeCount(), 0);
+  CHECK(sim.completeTransfer()); // write half
+  CHECK(!bq.tick());
+
+  CHECK_EQ(callbacks, 1);
+  CHECK(callback_ok);
+  CHECK_EQ(sim.readCount(), 1);
+  CHECK_EQ(sim.writeCount(), 1);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 410);
+}
+
+static void testCachedFieldReadSkipsBus() {
+  setup(true);
+  int32_t value = 0;
+  CHECK(bq.getFieldAsync(BQ25798_FIELD_VREG, &value, done));
+  CHECK(!bq.tick());
+  CHECK(!sim.completeTransfer());
+  CHECK_EQ(callbacks, 1);
+  CHECK(callback_ok);
+  CHECK_EQ(value, 4200);
+  CHECK_EQ(sim.readCount(), 0);
+}
+
+int main() {
+  RUN(testTickOnlyPolls);
+  RUN(testSyncCallTimesOutBehindTransfer);
+  RUN(testTickTimesOutStuckTransfer);
+  RUN(testFieldWriteIsTwoTransfers);
+  RUN(testCachedFieldReadSkipsBus);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Input power budget manager: ICHG and IINDPM writes for given IBUS, IBAT,
+ * VBUS and VSYS readings, the raise slew, the caps and floors, and the
+ * one-LSB write threshold.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Budget.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.setChargeLimit_mA(2000));
+  CHECK(bq.setInputLimit_mA(3000));
+}
+
+static void feed(int16_t ibus_mA, int16_t ibat_mA, uint16_t vbus_mV,
+                 uint16_t vsys_mV) {
+  sim.poke16(BQ25798_REG_IBUS_ADC, (uint16_t)ibus_mA);
+  sim.poke16(BQ25798_REG_IBAT_ADC, (uint16_t)ibat_mA);
+  sim.poke16(BQ25798_REG_VBUS_ADC, vbus_mV);
+  sim.poke16(BQ25798_REG_VSYS_ADC, vsys_mV);
+}
+
+static void testChargeFollowsLoad() {
+  setup();
+  Adafruit_BQ25798_Budget budget(&bq);
+  CHECK(budget.begin(15000, 0));
+  CHECK(bq.getADCEnable());
+
+  // 10W in, 4W into the battery: 6W load leaves more than the 2A ceiling
+  feed(2000, 1000, 5000, 4000);
+  sim.resetCounts();
+  CHECK(budget.update());
+  CHECK_EQ(sim.writeCount(), 0);
+  bq25798_budget_stats_t stats;
+  budget.getStats(stats);
+  CHECK_EQ(stats.input_mW, 10000);
+  CHECK_EQ(stats.charge_mW, 4000);
+  CHECK_EQ(stats.load_mW, 6000);
+  CHECK_EQ(stats.ichg_mA, 2000);
+  CHECK_EQ(stats.iindpm_mA, 3000);
+
+  // Load steps to 11W: (15000 - 200 - 11000) / 4V, cut at once
+  feed(3000, 1000, 5000, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getChargeLimit_mA(), 950);
+
+  // Load back to 9W: spare is 1450mA, reached 200mA per update
+  static const uint16_t steps[] = {1150, 1350, 1450, 1450};
+  feed(2000, 250, 5000, 4000);
+  for (uint8_t i = 0; i < 4; i++) {
+    CHECK(budget.update());
+    CHECK_EQ(bq.getChargeLimit_mA(), steps[i]);
+  }
+  budget.getStats(stats);
+  CHECK_EQ(stats.writes, 4);
+  CHECK_EQ(stats.samples, 6);
+  CHECK_EQ(stats.over, 0);
+  CHECK_EQ(stats.peak_mW, 15000);
+}
+
+static void testFloorsAndCaps() {
+  setup();
+  Adafruit_BQ25798_Budget budget(&bq);
+  CHECK(budget.begin(15000, 0));
+
+  // Load over the budget: charging carries on at the floor
+  feed(3300, 0, 5000, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getChargeLimit_mA(), 50);
+  budget.setChargeRange(300, 1200);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getChargeLimit_mA(), 300);
+  bq25798_budget_stats_t stats;
+  budget.getStats(stats);
+  CHECK_EQ(stats.over, 2);
+
+  // No load: raises stop at the new ceiling
+  budget.setSlew(2000);
+  feed(0, 0, 5000, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getChargeLimit_mA(), 1200);
+
+  // IINDPM is the budget at VBUS, in 10mA steps, under the rating
+  feed(0, 0, 9000, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getInputLimit_mA(), 1660);
+  feed(0, 0, 4000, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getInputLimit_mA(), 3000); // set before begin()
+  budget.setInputMax(1500);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getInputLimit_mA(), 1500);
+  budget.setBudget(100);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getInputLimit_mA(), 100);
+}
+
+static void testWritesOnlyPastOneLSB() {
+  // With no input and VBUS at 0 the ICHG target is budget / VSYS and
+  // IINDPM is left alone
+  setup();
+  Adafruit_BQ25798_Budget budget(&bq);
+  budget.setHeadroom(0);
+  budget.setSlew(2000);
+  CHECK(budget.begin(4000, 0));
+  feed(0, 0, 0, 4000);
+  CHECK(budget.update());
+  CHECK_EQ(bq.getChargeLimit_mA(), 1000);
+
+  sim.resetCounts();
+  budget.setBudget(4060); // 1015mA, 1010 after rounding down
+  CHECK(budget.update());
+  budget.setBudget(3960); // 990mA
+  CHECK(budget.update());
+  CHECK_EQ(sim.writeCount(), 0);
+  CHECK_EQ(bq.getChargeLimit_mA(), 1000);
+
+  budget.setBudget(4080); // 1020mA
+  CHECK(budget.update());
+  CHECK_EQ(sim.writeCount(), 1);
+  CHECK_EQ(bq.getChargeLimit_mA(), 1020);
+  budget.setBudget(3960);
+  CHECK(budget.update());
+  CHECK_EQ(sim.writeCount(), 2);
+  CHECK_EQ(bq.getChargeLimit_mA(), 990);
+}
+
+int main() {
+  RUN(testChargeFollowsLoad);
+  RUN(testFloorsAndCaps);
+  RUN(testWritesOnlyPastOneLSB);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * saveConfig()/restoreConfig() and configuration batches.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+/*
+ * Passes reads through to the simulator and NAKs writes on demand
+ */
+class FlakyWrites : public Adafruit_BQ25798_Transport {
+public:
+  FlakyWrites() : fail(false) {}
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    return sim.readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    return !fail && sim.writeRegisters(reg, buffer, len);
+  }
+
+  bool fail;
+};
+
+static uint8_t config[BQ25798_CONFIG_SIZE];
+
+static void setup(bool cached) {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.enableCache(cached));
+  CHECK(bq.setChargeLimitV(4.1));
+  CHECK(bq.setChargeLimitA(1.5));
+  CHECK(bq.saveConfig(config));
+}
+
+static void testRestoreUnchangedWritesNothing() {
+  setup(false);
+  sim.resetCounts();
+
+  uint8_t changed = 0xFF;
+  CHECK(bq.restoreConfig(config, &changed));
+  CHECK_EQ(changed, 0);
+  CHECK_EQ(sim.writeCount(), 0);
+}
+
+static void testRestoreAfterReset() {
+  setup(false);
+  CHECK(bq.reset());
+  CHECK_NEAR(bq.getChargeLimitV(), 4.2, 0.001);
+
+  uint8_t changed = 0;
+  CHECK(bq.restoreConfig(config, &changed));
+  CHECK_EQ(changed, 2); // the low bytes of VREG and ICHG
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 410);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_CURRENT_LIMIT), 150);
+}
+
+static void testRestoreReadsLiveRegistersWhenCached() {
+  setup(true);
+
+  // Change VREG on the chip without the driver knowing
+  sim.poke16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT, 0x01A4);
+  CHECK_NEAR(bq.getChargeLimitV(), 4.1, 0.001); // still the shadow copy
+
+  uint8_t changed = 0;
+  CHECK(bq.restoreConfig(config, &changed));
+  CHECK_EQ(changed, 1);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 410);
+  CHECK_NEAR(bq.getChargeLimitV(), 4.1, 0.001);
+}
+
+static void testRestoreRefusesOpenBatch() {
+  setup(true);
+  CHECK(bq.reset());
+  CHECK(bq.beginBatch());
+  CHECK(bq.setInputLimitA(1.0));
+  sim.resetCounts();
+
+  CHECK(!bq.restoreConfig(config));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUSY);
+  CHECK_EQ(sim.writeCount(), 0);
+
+  // The caller's batch is still open and intact
+  CHECK(bq.commit());
+  CHECK_EQ(sim.peek16(BQ25798_REG_INPUT_CURRENT_LIMIT), 100);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 0x01A4);
+}
+
+static void testRestoreRejectsCorruptBlob() {
+  setup(false);
+  uint8_t bad[BQ25798_CONFIG_SIZE];
+  memcpy(bad, config, sizeof(bad));
+  bad[2] ^= 0x01;
+  CHECK(!bq.restoreConfig(bad));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+
+  memcpy(bad, config, sizeof(bad));
+  bad[0]++;
+  CHECK(!bq.restoreConfig(bad));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+}
+
+static void testRestoreBusFailureClosesBatch() {
+  setup(false);
+  CHECK(bq.reset());
+
+  FlakyWrites flaky;
+  CHECK(bq.begin(&flaky));
+  bq.setRetryPolicy(1);
+  flaky.fail = true;
+  CHECK(!bq.restoreConfig(config));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUS);
+
+  // The next setter goes straight to the chip, not into a leftover batch
+  flaky.fail = false;
+  CHECK(bq.setInputLimitA(1.0));
+  CHECK_EQ(sim.peek16(BQ25798_REG_INPUT_CURRENT_LIMIT), 100);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 0x01A4);
+}
+
+static void testBatchCoalescesWrites() {
+  setup(false);
+  CHECK(bq.beginBatch());
+  CHECK(bq.setChargeLimitV(4.0));
+  CHECK(bq.setChargeLimitA(1.0));
+  CHECK(bq.setInputLimitA(2.0));
+  CHECK_NEAR(bq.getChargeLimitV(), 4.0, 0.001); // staged values are visible
+  sim.resetCounts();
+  CHECK(bq.commit());
+  CHECK_EQ(sim.writeCount(), 1);
+  CHECK_EQ(sim.peek16(BQ25798_REG_INPUT_CURRENT_LIMIT), 200);
+}
+
+static void testBatchSurvivesWatchdogResync() {
+  setup(true);
+  CHECK(bq.beginBatch());
+  CHECK(bq.setChargeLimit_mV(4000));
+  CHECK(bq.setInputLimit_mV(5000));
+
+  // An expiry mid-batch reloads ICHG, which commit() bridges over
+  sim.poke16(BQ25798_REG_CHARGE_CURRENT_LIMIT, 100);
+  sim.raiseFlags(BQ25798_FLAG_WD);
+  CHECK(bq.handleInterrupt());
+
+  CHECK(bq.commit());
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 400);
+  CHECK_EQ(sim.peek(BQ25798_REG_INPUT_VOLTAGE_LIMIT), 50);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_CURRENT_LIMIT), 100);
+  CHECK_EQ(bq.getChargeLimit_mA(), 1000); // shadow picked up the reload
+}
+
+static void testBatchDoesNotBridgeLiveRegisters() {
+  setup(true);
+  CHECK(bq.setHIZMode(true));
+  CHECK(bq.beginBatch());
+  CHECK(bq.setField(BQ25798_FIELD_EN_CHG_TMR, 0));
+  CHECK(bq.setField(BQ25798_FIELD_WATCHDOG, 1));
+
+  // VBUS plug-in clears EN_HIZ behind the shadow copy
+  uint8_t control = sim.peek(BQ25798_REG_CHARGER_CONTROL_0);
+  sim.poke(BQ25798_REG_CHARGER_CONTROL_0, control & ~0x04);
+  sim.resetCounts();
+
+  CHECK(bq.commit());
+  CHECK_EQ(sim.writeCount(), 2);
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_CONTROL_0), control & ~0x04);
+}
+
+int main() {
+  RUN(testRestoreUnchangedWritesNothing);
+  RUN(testRestoreAfterReset);
+  RUN(testRestoreReadsLiveRegistersWhenCached);
+  RUN(testRestoreRefusesOpenBatch);
+  RUN(testRestoreRejectsCorruptBlob);
+  RUN(testRestoreBusFailureClosesBatch);
+  RUN(testBatchCoalescesWrites);
+  RUN(testBatchSurvivesWatchdogResync);
+  RUN(testBatchDoesNotBridgeLiveRegisters);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Coulomb counter and energy accumulator on synthetic samples.
+ */
+
+#include <math.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Energy.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+#define HOUR_US 3600000000UL
+
+static bq25798_adc_fixed_t battery(int16_t ibat_mA, uint16_t vbat_mV) {
+  bq25798_adc_fixed_t adc;
+  memset(&adc, 0, sizeof(adc));
+  adc.ibat = ibat_mA;
+  adc.vbat = vbat_mV;
+  return adc;
+}
+
+static uint64_t distance(uint64_t a, uint64_t b) {
+  return a > b ? a - b : b - a;
+}
+
+static void testConstantCharge() {
+  Adafruit_BQ25798_Energy energy;
+  energy.addSample(battery(500, 4000), 0);
+  energy.addSample(battery(500, 4000), HOUR_US);
+
+  bq25798_energy_totals_t totals;
+  energy.getTotals(totals);
+  CHECK_EQ(totals.bat_in_uAh, 500000);
+  CHECK_EQ(totals.bat_out_uAh, 0);
+  CHECK_EQ(totals.bat_in_uWh, 2000000);
+  CHECK_EQ(totals.elapsed_s, 3600);
+  CHECK_EQ(energy.getNetCharge_uAh(), 500000);
+  CHECK_EQ(energy.getSampleCount(), 2);
+}
+
+static void testRampSplitsAtZeroCrossing() {
+  // -1A to +1A over an hour, sampled only at its ends: the trapezoid alone
+  // would net to zero
+  Adafruit_BQ25798_Energy energy;
+  energy.addSample(battery(-1000, 4000), 0);
+  energy.addSample(battery(1000, 4000), HOUR_US);
+
+  bq25798_energy_totals_t totals;
+  energy.getTotals(totals);
+  CHECK_EQ(totals.bat_in_uAh, 250000);
+  CHECK_EQ(totals.bat_out_uAh, 250000);
+  CHECK_EQ(totals.bat_in_uWh, 1000000);
+  CHECK_EQ(totals.bat_out_uWh, 1000000);
+  CHECK_EQ(energy.getNetCharge_uAh(), 0);
+}
+
+static void testSlowSamplingOfSine() {
+  // One period of a 1A sine over an hour carries 1000/pi mAh each way
+  uint64_t in[2];
+  const uint32_t steps_s[2] = {1, 60};
+  for (uint8_t i = 0; i < 2; i++) {
+    Adafruit_BQ25798_Energy energy;
+    for (uint32_t t = 0; t <= 3600; t += steps_s[i]) {
+      int16_t ibat = (int16_t)lround(1000 * sin(2 * M_PI * t / 3600.0));
+      energy.addSample(battery(ibat, 4000), t * 1000000UL);
+    }
+    bq25798_energy_totals_t totals;
+    energy.getTotals(totals);
+    CHECK(distance(totals.bat_in_uAh, totals.bat_out_uAh) <= 1);
+    in[i] = totals.bat_in_uAh;
+  }
+
+  uint64_t exact = (uint64_t)lround(1000000 / M_PI);
+  CHECK(distance(in[0], exact) * 10000 <= exact);  // 1Hz within 0.01%
+  CHECK(distance(in[1], in[0]) * 1000 <= in[0]);   // 1/min within 0.1%
+}
+
+static void testOTGCountsAsBusOut() {
+  Adafruit_BQ25798_Energy energy;
+  bq25798_adc_fixed_t adc = battery(-1200, 3700);
+  adc.vbus = 5000;
+  adc.ibus = -800;
+  energy.addSample(adc, 0);
+  energy.addSample(adc, HOUR_US / 2);
+
+  bq25798_energy_totals_t totals;
+  energy.getTotals(totals);
+  CHECK_EQ(totals.vbus_in_uWh, 0);
+  CHECK_EQ(totals.vbus_out_uWh, 2000000);
+  CHECK_EQ(totals.bat_out_uAh, 600000);
+  CHECK_EQ(totals.bat_out_uWh, 2220000);
+}
+
+static void testTimestampWrap() {
+  Adafruit_BQ25798_Energy energy;
+  energy.addSample(battery(1000, 4000), 0xFFFFFFFFUL - 999999);
+  energy.addSample(battery(1000, 4000), 3600UL * 1000000 - 1000000);
+
+  bq25798_energy_totals_t totals;
+  energy.getTotals(totals);
+  CHECK_EQ(totals.elapsed_s, 3600);
+}
+
+static void testSaveRestoreState() {
+  Adafruit_BQ25798_Energy energy;
+  energy.addSample(battery(-1000, 4000), 0);
+  energy.addSample(battery(1000, 4000), HOUR_US);
+
+  uint8_t state[BQ25798_ENERGY_STATE_SIZE];
+  energy.saveState(state);
+
+  // After a reboot micros() starts over and the gap is not integrated
+  Adafruit_BQ25798_Energy restored;
+  CHECK(restored.restoreState(state));
+  restored.addSample(battery(1000, 4000), 1000);
+  bq25798_energy_totals_t totals;
+  restored.getTotals(totals);
+  CHECK_EQ(totals.bat_in_uAh, 250000);
+  CHECK_EQ(totals.bat_out_uAh, 250000);
+  CHECK_EQ(totals.elapsed_s, 3600);
+
+  state[5] ^= 0x01;
+  CHECK(!restored.restoreState(state));
+  energy.saveState(state);
+  state[0]++;
+  CHECK(!restored.restoreState(state));
+  restored.getTotals(totals);
+  CHECK_EQ(totals.bat_in_uAh, 250000);
+}
+
+static void testUpdateReadsADC() {
+  Adafruit_BQ25798_Energy unattached;
+  CHECK(!unattached.update());
+
+  Adafruit_BQ25798_Sim sim;
+  Adafruit_BQ25798 bq;
+  CHECK(bq.begin(&sim));
+  sim.poke16(BQ25798_REG_IBAT_ADC, 1500);
+  sim.poke16(BQ25798_REG_VBAT_ADC, 4100);
+
+  Adafruit_BQ25798_Energy energy(&bq);
+  CHECK(energy.update());
+  delay(10);
+  CHECK(energy.update());
+  CHECK_EQ(energy.getSampleCount(), 2);
+  CHECK(energy.getNetCharge_uAh() >= 4); // 1.5A for at least 10ms
+
+  bq25798_energy_totals_t totals;
+  energy.getTotals(totals);
+  CHECK_EQ(totals.bat_out_uAh, 0);
+
+  energy.reset();
+  CHECK_EQ(energy.getSampleCount(), 0);
+  CHECK_EQ(energy.getNetCharge_uAh(), 0);
+}
+
+int main() {
+  RUN(testConstantCharge);
+  RUN(testRampSplitsAtZeroCrossing);
+  RUN(testSlowSamplingOfSine);
+  RUN(testOTGCountsAsBusOut);
+  RUN(testTimestampWrap);
+  RUN(testSaveRestoreState);
+  RUN(testUpdateReadsADC);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * getLastError() after calls that never touch the bus: cache hits and
+ * batch-staged writes must not report an earlier failure.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+static bq25798_async_op_t ops[2];
+
+// Leave ERR_BUS behind from a failed status read
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.enableCache(true));
+  bq.setRetryPolicy(1);
+
+  bq25798_status_t status;
+  sim.failTransfers(1);
+  CHECK(!bq.getStatus(status));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUS);
+  sim.resetCounts();
+}
+
+static void testCachedReadClearsError() {
+  setup();
+  bq.getCellCount();
+  CHECK_EQ(sim.readCount(), 0);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+
+  setup();
+  int32_t value = 0;
+  CHECK(bq.getField(BQ25798_FIELD_VREG, value));
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+static void testCachedWriteClearsError() {
+  setup();
+  CHECK(bq.setChargeLimit_mV(4100));
+  CHECK_EQ(sim.readCount(), 0);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+static void testStagedWriteClearsError() {
+  setup();
+  CHECK(bq.beginBatch());
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+
+  setup();
+  CHECK(bq.beginBatch());
+  sim.failTransfers(1);
+  CHECK(!bq.resetWDT()); // strobes bypass the batch
+  sim.resetCounts();
+  CHECK(bq.setChargeLimit_mV(4100));
+  CHECK_EQ(sim.writeCount(), 0);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+  CHECK(bq.commit());
+}
+
+static void testCachedGetFieldsClearsError() {
+  static const bq25798_field_t fields[] = {BQ25798_FIELD_VREG,
+                                           BQ25798_FIELD_ICHG};
+  int32_t values[2];
+  setup();
+  CHECK(bq.getFields(fields, values, 2));
+  CHECK_EQ(sim.readCount(), 0);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+
+  static const bq25798_field_t bad[] = {BQ25798_FIELD_COUNT};
+  CHECK(!bq.getFields(bad, values, 1));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+}
+
+static void testCachedAsyncReadClearsError() {
+  setup();
+  bq.setAsyncQueue(ops, 2);
+  int32_t value = 0;
+  CHECK(bq.getFieldAsync(BQ25798_FIELD_VREG, &value));
+  CHECK(!bq.tick());
+  CHECK_EQ(value, 4200);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+int main() {
+  RUN(testCachedReadClearsError);
+  RUN(testCachedWriteClearsError);
+  RUN(testStagedWriteClearsError);
+  RUN(testCachedGetFieldsClearsError);
+  RUN(testCachedAsyncReadClearsError);
+  return test_failures ? 1 : 0;
+}
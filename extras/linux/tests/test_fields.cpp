@@ -0,0 +1,123 @@
+/*
+ * Field-by-ID access: getField(), setField(), getFields() and the name
+ * lookups.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+// Config, control and ADC fields spread over 0x00-0x41
+static const bq25798_field_t query[] = {
+    BQ25798_FIELD_VSYSMIN,  BQ25798_FIELD_VREG,     BQ25798_FIELD_ICHG,
+    BQ25798_FIELD_VINDPM,   BQ25798_FIELD_IINDPM,   BQ25798_FIELD_ITERM,
+    BQ25798_FIELD_CELL,     BQ25798_FIELD_VOTG,     BQ25798_FIELD_IOTG,
+    BQ25798_FIELD_EN_CHG,   BQ25798_FIELD_WATCHDOG, BQ25798_FIELD_EN_OTG,
+    BQ25798_FIELD_EN_MPPT,  BQ25798_FIELD_TREG,     BQ25798_FIELD_ADC_EN,
+    BQ25798_FIELD_IBUS_ADC, BQ25798_FIELD_IBAT_ADC, BQ25798_FIELD_VBUS_ADC,
+    BQ25798_FIELD_VBAT_ADC, BQ25798_FIELD_TDIE_ADC};
+#define QUERY_SIZE (sizeof(query) / sizeof(query[0]))
+
+static void setup(bool cached) {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.enableCache(cached));
+  sim.poke16(BQ25798_REG_IBUS_ADC, (uint16_t)-120);
+  sim.poke16(BQ25798_REG_VBUS_ADC, 5020);
+  sim.poke16(BQ25798_REG_VBAT_ADC, 3800);
+  sim.resetCounts();
+}
+
+static void testGetFieldMatchesNamedGetters() {
+  setup(false);
+  CHECK(bq.setChargeLimit_mV(4150));
+  CHECK(bq.setInputLimit_mA(1230));
+  CHECK_EQ(bq.getField(BQ25798_FIELD_VREG), 4150);
+  CHECK_EQ(bq.getField(BQ25798_FIELD_IINDPM), 1230);
+  CHECK_EQ(bq.getField(BQ25798_FIELD_CELL), bq.getCellCount());
+  CHECK_EQ(bq.getField(BQ25798_FIELD_IBUS_ADC), -120);
+
+  int32_t value = 0;
+  CHECK(bq.getField(BQ25798_FIELD_VBAT_ADC, value));
+  CHECK_EQ(value, 3800);
+  CHECK(!bq.getField(BQ25798_FIELD_COUNT, value));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+}
+
+static void testSetFieldRangeAndReadOnly() {
+  setup(false);
+  CHECK(bq.setField(BQ25798_FIELD_ICHG, 2000));
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_CURRENT_LIMIT), 200);
+  CHECK_EQ(bq.getChargeLimit_mA(), 2000);
+
+  CHECK(!bq.setField(BQ25798_FIELD_ICHG, 5010));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+  CHECK(!bq.setField(BQ25798_FIELD_ICHG, 40));
+  CHECK(!bq.setField(BQ25798_FIELD_VBAT_ADC, 4000));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_INVALID);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_CURRENT_LIMIT), 200);
+  CHECK_EQ(sim.peek16(BQ25798_REG_VBAT_ADC), 3800);
+}
+
+static void testGetFieldsMatchesGetField() {
+  setup(false);
+  int32_t values[QUERY_SIZE];
+  CHECK(bq.getFields(query, values, QUERY_SIZE));
+  for (uint8_t i = 0; i < QUERY_SIZE; i++) {
+    CHECK_EQ(values[i], bq.getField(query[i]));
+  }
+}
+
+static void testGetFieldsBurstCount() {
+  int32_t values[QUERY_SIZE];
+
+  setup(false);
+  // 0x00-0x16, 0x2E-0x36, 0x3B-0x3C and 0x41-0x42: the gaps between the
+  // ADC runs are too wide to bridge
+  CHECK(bq.getFields(query, values, QUERY_SIZE));
+  CHECK_EQ(sim.readCount(), 4);
+
+  // The config run comes from the shadow instead
+  setup(true);
+  CHECK(bq.getFields(query, values, QUERY_SIZE));
+  CHECK_EQ(sim.readCount(), 3);
+}
+
+static void testGetFieldsSkipsFlagRegisters() {
+  setup(false);
+  static const bq25798_field_t around[] = {BQ25798_FIELD_BKUP_ACFET1_ON,
+                                           BQ25798_FIELD_ADC_EN};
+  int32_t values[2];
+
+  sim.raiseFlags(BQ25798_FLAG_PG);
+  CHECK(bq.getFields(around, values, 2));
+  uint64_t flags = 0;
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, BQ25798_FLAG_PG);
+}
+
+static void testNames() {
+  char name[24];
+  for (uint8_t f = 0; f < BQ25798_FIELD_COUNT; f++) {
+    CHECK(Adafruit_BQ25798::getFieldName((bq25798_field_t)f, name,
+                                         sizeof(name)));
+    CHECK_EQ(Adafruit_BQ25798::findField(name), f);
+  }
+
+  CHECK(Adafruit_BQ25798::getFieldName(BQ25798_FIELD_VREG, name, 24));
+  CHECK(!strcmp(name, "VREG"));
+  CHECK_EQ(Adafruit_BQ25798::findField("NOPE"), BQ25798_FIELD_COUNT);
+}
+
+int main() {
+  RUN(testGetFieldMatchesNamedGetters);
+  RUN(testSetFieldRangeAndReadOnly);
+  RUN(testGetFieldsMatchesGetField);
+  RUN(testGetFieldsBurstCount);
+  RUN(testGetFieldsSkipsFlagRegisters);
+  RUN(testNames);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * handleInterrupt(): typed callbacks from one burst of the status and
+ * clear-on-read flag registers.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+static uint8_t vbus_calls, pg_calls, chg_calls, done_calls, wd_calls;
+static uint8_t tshut_calls, fault_calls, event_calls;
+static bool vbus_state, pg_state;
+static bq25798_chg_stat_t chg_state;
+static uint16_t faults;
+static uint64_t events;
+
+static void onVBUS(bool state) {
+  vbus_calls++;
+  vbus_state = state;
+}
+
+static void onPG(bool state) {
+  pg_calls++;
+  pg_state = state;
+}
+
+static void onChg(bq25798_chg_stat_t state) {
+  chg_calls++;
+  chg_state = state;
+}
+
+static void onDone() {
+  done_calls++;
+}
+
+static void onWD() {
+  wd_calls++;
+}
+
+static void onTSHUT() {
+  tshut_calls++;
+}
+
+static void onFaults(uint16_t flags) {
+  fault_calls++;
+  faults = flags;
+}
+
+static void onAny(uint64_t flags) {
+  event_calls++;
+  events = flags;
+}
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  bq.onVBUSPresentChanged(onVBUS);
+  bq.onPowerGoodChanged(onPG);
+  bq.onChargeStateChanged(onChg);
+  bq.onChargeDone(onDone);
+  bq.onWatchdogExpired(onWD);
+  bq.onTSHUT(onTSHUT);
+  bq.onFault(onFaults);
+  bq.onEvent(onAny);
+
+  vbus_calls = pg_calls = chg_calls = done_calls = wd_calls = 0;
+  tshut_calls = fault_calls = event_calls = 0;
+  vbus_state = pg_state = false;
+  chg_state = BQ25798_CHG_STAT_NOT_CHARGING;
+  faults = 0;
+  events = 0;
+}
+
+static void testEachCallbackFiresOnce() {
+  setup();
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, 0x09); // PG_STAT, VBUS_PRESENT
+  sim.poke(BQ25798_REG_CHARGER_STATUS_1, BQ25798_CHG_STAT_DONE << 5);
+  const uint64_t raised = BQ25798_FLAG_VBUS_PRESENT | BQ25798_FLAG_PG |
+                          BQ25798_FLAG_CHG | BQ25798_FLAG_WD |
+                          BQ25798_FLAG_VBUS_OVP | BQ25798_FLAG_TSHUT;
+  sim.raiseFlags(raised);
+
+  uint64_t flags = 0;
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, raised);
+  CHECK_EQ(vbus_calls, 1);
+  CHECK(vbus_state);
+  CHECK_EQ(pg_calls, 1);
+  CHECK(pg_state);
+  CHECK_EQ(chg_calls, 1);
+  CHECK_EQ(chg_state, BQ25798_CHG_STAT_DONE);
+  CHECK_EQ(done_calls, 1);
+  CHECK_EQ(wd_calls, 1);
+  CHECK_EQ(tshut_calls, 1);
+  CHECK_EQ(fault_calls, 1);
+  CHECK_EQ(faults, (BQ25798_FLAG_VBUS_OVP | BQ25798_FLAG_TSHUT) >> 32);
+  CHECK_EQ(event_calls, 1);
+  CHECK_EQ(events, raised);
+
+  // The flags were cleared by the first read; status alone raises nothing
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, 0);
+  CHECK_EQ(vbus_calls, 1);
+  CHECK_EQ(wd_calls, 1);
+  CHECK_EQ(event_calls, 1);
+}
+
+static void testOnlyRaisedEventsDispatch() {
+  setup();
+  sim.poke(BQ25798_REG_CHARGER_STATUS_1, BQ25798_CHG_STAT_FAST << 5);
+  sim.raiseFlags(BQ25798_FLAG_CHG);
+
+  CHECK(bq.handleInterrupt());
+  CHECK_EQ(chg_calls, 1);
+  CHECK_EQ(chg_state, BQ25798_CHG_STAT_FAST);
+  CHECK_EQ(done_calls, 0); // not a transition into DONE
+  CHECK_EQ(vbus_calls, 0);
+  CHECK_EQ(pg_calls, 0);
+  CHECK_EQ(fault_calls, 0);
+  CHECK_EQ(event_calls, 1);
+
+  bq.onEvent(NULL);
+  sim.raiseFlags(BQ25798_FLAG_ADC_DONE);
+  CHECK(bq.handleInterrupt());
+  CHECK_EQ(event_calls, 1);
+}
+
+static void testOneBurstClearsFlags() {
+  setup();
+  sim.raiseFlags(BQ25798_FLAG_ALL);
+  sim.resetCounts();
+
+  uint64_t flags = 0;
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, BQ25798_FLAG_ALL);
+  CHECK_EQ(sim.readCount(), 1);
+  CHECK_EQ(sim.writeCount(), 0);
+  for (uint8_t reg = BQ25798_REG_CHARGER_FLAG_0;
+       reg <= BQ25798_REG_FAULT_FLAG_1; reg++) {
+    CHECK_EQ(sim.peek(reg), 0);
+  }
+}
+
+static void testStatusDoesNotClearFlags() {
+  setup();
+  sim.raiseFlags(BQ25798_FLAG_PG);
+
+  bq25798_status_t status;
+  CHECK(bq.getStatus(status));
+  uint64_t flags = 0;
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, BQ25798_FLAG_PG);
+  CHECK_EQ(pg_calls, 1);
+}
+
+int main() {
+  RUN(testEachCallbackFiresOnce);
+  RUN(testOnlyRaisedEventsDispatch);
+  RUN(testOneBurstClearsFlags);
+  RUN(testStatusDoesNotClearFlags);
+  return test_failures ? 1 : 0;
+}
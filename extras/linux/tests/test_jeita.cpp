@@ -0,0 +1,193 @@
+/*
+ * Temperature-banded charge profile: band edges, relaxing hysteresis, the
+ * order of the ICHG and VREG writes and the cutoff above the last band.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_JEITA.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+/*
+ * Sim that logs the first register of every write
+ */
+class LoggingSim : public Adafruit_BQ25798_Sim {
+public:
+  LoggingSim() : logged(0) {}
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    if (logged < sizeof(log)) {
+      log[logged++] = reg;
+    }
+    return Adafruit_BQ25798_Sim::writeRegisters(reg, buffer, len);
+  }
+
+  uint8_t log[16];
+  uint8_t logged;
+};
+
+static LoggingSim sim;
+static Adafruit_BQ25798 bq;
+
+static const bq25798_jeita_band_t profile[] = {
+    {0, 200, 4100},    // up to 0C
+    {100, 500, 4200},  // up to 10C
+    {450, 1000, 4200}, // up to 45C
+    {550, 500, 4000},  // up to 55C, charging stops above
+};
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  sim.logged = 0;
+}
+
+static void testBandEdges() {
+  setup();
+  Adafruit_BQ25798_JEITA jeita(&bq);
+  CHECK(jeita.begin(profile, 4));
+  CHECK_EQ(jeita.getBand(), BQ25798_JEITA_NONE);
+  CHECK(bq.getADCEnable());
+
+  // An edge belongs to the band below it
+  CHECK(jeita.apply(0));
+  CHECK_EQ(jeita.getBand(), 0);
+  CHECK_EQ(bq.getChargeLimit_mA(), 200);
+  CHECK_EQ(bq.getChargeLimit_mV(), 4100);
+  CHECK(bq.getChargeEnable());
+
+  // Warming into a harsher band is immediate, one step past the edge
+  CHECK(jeita.apply(300));
+  CHECK_EQ(jeita.getBand(), 2);
+  CHECK(jeita.apply(450));
+  CHECK_EQ(jeita.getBand(), 2);
+  CHECK(jeita.apply(451));
+  CHECK_EQ(jeita.getBand(), 3);
+  CHECK_EQ(bq.getChargeLimit_mA(), 500);
+  CHECK_EQ(bq.getChargeLimit_mV(), 4000);
+  CHECK_EQ(jeita.getChanges(), 3);
+
+  // Staying put writes nothing
+  sim.resetCounts();
+  CHECK(jeita.apply(550));
+  CHECK_EQ(sim.writeCount(), 0);
+  CHECK_EQ(jeita.getTemperature(), 550);
+}
+
+static void testRelaxingNeedsHysteresis() {
+  setup();
+  Adafruit_BQ25798_JEITA jeita(&bq);
+  CHECK(jeita.begin(profile, 4, 20));
+  CHECK(jeita.apply(-50));
+  CHECK_EQ(jeita.getBand(), 0);
+
+  // Warming out of the cold band has to clear 0C by 2C
+  CHECK(jeita.apply(1));
+  CHECK(jeita.apply(20));
+  CHECK_EQ(jeita.getBand(), 0);
+  CHECK(jeita.apply(21));
+  CHECK_EQ(jeita.getBand(), 1);
+
+  // Cooling back out of the warm band has to clear 45C by 2C
+  CHECK(jeita.apply(300));
+  CHECK_EQ(jeita.getBand(), 2);
+  CHECK(jeita.apply(460));
+  CHECK_EQ(jeita.getBand(), 3);
+  CHECK(jeita.apply(449));
+  CHECK(jeita.apply(431));
+  CHECK_EQ(jeita.getBand(), 3);
+  CHECK(jeita.apply(430));
+  CHECK_EQ(jeita.getBand(), 2);
+  CHECK_EQ(bq.getChargeLimit_mA(), 1000);
+
+  // Cooling into the 500mA band below is harsher, so it is immediate
+  CHECK(jeita.apply(100));
+  CHECK_EQ(jeita.getBand(), 1);
+}
+
+static void testWriteOrdering() {
+  setup();
+  Adafruit_BQ25798_JEITA jeita(&bq);
+  CHECK(jeita.begin(profile, 4));
+  CHECK(jeita.apply(300));
+
+  // Lower current goes out before the voltage changes...
+  sim.logged = 0;
+  CHECK(jeita.apply(500));
+  CHECK_EQ(sim.logged, 2);
+  CHECK_EQ(sim.log[0], BQ25798_REG_CHARGE_CURRENT_LIMIT);
+  CHECK_EQ(sim.log[1], BQ25798_REG_CHARGE_VOLTAGE_LIMIT);
+
+  // ...and a higher one after it
+  sim.logged = 0;
+  CHECK(jeita.apply(300));
+  CHECK_EQ(sim.logged, 2);
+  CHECK_EQ(sim.log[0], BQ25798_REG_CHARGE_VOLTAGE_LIMIT);
+  CHECK_EQ(sim.log[1], BQ25798_REG_CHARGE_CURRENT_LIMIT);
+
+  // Only the setting that differs is written
+  sim.logged = 0;
+  CHECK(jeita.apply(50));
+  CHECK_EQ(sim.logged, 1);
+  CHECK_EQ(sim.log[0], BQ25798_REG_CHARGE_CURRENT_LIMIT);
+}
+
+static void testCutoffStopsCharging() {
+  setup();
+  Adafruit_BQ25798_JEITA jeita(&bq);
+  CHECK(jeita.begin(profile, 4));
+  CHECK(jeita.apply(500));
+  CHECK(bq.getChargeEnable());
+
+  sim.logged = 0;
+  CHECK(jeita.apply(551));
+  CHECK_EQ(jeita.getBand(), 4);
+  CHECK(!bq.getChargeEnable());
+  CHECK_EQ(sim.logged, 1);
+  CHECK_EQ(sim.log[0], BQ25798_REG_CHARGER_CONTROL_0);
+  CHECK_EQ(bq.getChargeLimit_mV(), 4000); // limits left alone
+
+  // Back under the last edge by the hysteresis: limits, then enable
+  CHECK(jeita.apply(531));
+  CHECK_EQ(jeita.getBand(), 4);
+  sim.logged = 0;
+  CHECK(jeita.apply(530));
+  CHECK_EQ(jeita.getBand(), 3);
+  CHECK(bq.getChargeEnable());
+  CHECK_EQ(sim.logged, 3);
+  CHECK_EQ(sim.log[2], BQ25798_REG_CHARGER_CONTROL_0);
+}
+
+static void testUpdateReadsTS() {
+  setup();
+  Adafruit_BQ25798_JEITA jeita(&bq);
+  CHECK(jeita.begin(profile, 4, 20, 60000));
+
+  // No conversion yet
+  CHECK(!jeita.update());
+  CHECK_EQ(jeita.getBand(), BQ25798_JEITA_NONE);
+
+  // TS reading for about 25C from the default thermistor table
+  uint16_t raw = 1000;
+  while (jeita.getNTC().toTemperature((raw * 625UL + 32) / 64) < 250) {
+    raw--;
+  }
+  sim.poke16(BQ25798_REG_TS_ADC, raw);
+  CHECK(jeita.update());
+  CHECK_EQ(jeita.getBand(), 2);
+  CHECK(jeita.getTemperature() >= 250);
+
+  // Inside the interval nothing is read
+  sim.resetCounts();
+  CHECK(jeita.update());
+  CHECK_EQ(sim.readCount(), 0);
+}
+
+int main() {
+  RUN(testBandEdges);
+  RUN(testRelaxingNeedsHysteresis);
+  RUN(testWriteOrdering);
+  RUN(testCutoffStopsCharging);
+  RUN(testUpdateReadsTS);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * MPPT against a simulated 18V / 1A solar panel.
+ */
+
+#include <math.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_MPPT.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+/*
+ * A panel on VBUS with the charger holding it at VINDPM. Before every read
+ * the VBUS and IBUS ADC registers are refreshed from the panel curve,
+ * I = Isc * (1 - exp((V - Voc) / Vt)), whose maximum power point on the
+ * 100mV VINDPM grid is 15.4V.
+ */
+class SolarPanel : public Adafruit_BQ25798_Transport {
+public:
+  SolarPanel() : scale(1.0) {}
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    uint16_t vbus = sim.peek(BQ25798_REG_INPUT_VOLTAGE_LIMIT) * 100;
+    sim.poke16(BQ25798_REG_VBUS_ADC, vbus < 18000 ? vbus : 18000);
+    sim.poke16(BQ25798_REG_IBUS_ADC, current(vbus));
+    return sim.readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    return sim.writeRegisters(reg, buffer, len);
+  }
+
+  uint16_t current(uint16_t mV) {
+    if (mV >= 18000) {
+      return 0;
+    }
+    return (uint16_t)(1000 * scale * (1 - exp((mV - 18000) / 900.0)));
+  }
+
+  // Best setpoint on the VINDPM grid
+  uint16_t mpp() {
+    uint16_t best = 0;
+    uint32_t best_power = 0;
+    for (uint16_t mV = 3600; mV < 18000; mV += 100) {
+      uint32_t power = (uint32_t)mV * current(mV);
+      if (power > best_power) {
+        best_power = power;
+        best = mV;
+      }
+    }
+    return best;
+  }
+
+  Adafruit_BQ25798_Sim sim;
+  double scale; // irradiance, 1.0 for full sun
+};
+
+static SolarPanel panel;
+static Adafruit_BQ25798 bq;
+
+static void setup(Adafruit_BQ25798_MPPT &mppt, bq25798_mppt_mode_t mode) {
+  panel.sim.powerOnReset();
+  panel.scale = 1.0;
+  CHECK(bq.begin(&panel));
+  CHECK(bq.setInputLimit_mV(8000));
+  CHECK(mppt.begin(mode, 100, 0));
+}
+
+static uint16_t distance(uint16_t a, uint16_t b) {
+  return a > b ? a - b : b - a;
+}
+
+static void testPanelModel() {
+  CHECK_EQ(panel.mpp(), 15400);
+}
+
+static void testPerturbObserveFindsMPP() {
+  Adafruit_BQ25798_MPPT mppt(&bq);
+  setup(mppt, BQ25798_MPPT_PERTURB_OBSERVE);
+  CHECK(!bq.getMPPTenable());
+
+  for (int i = 0; i < 150; i++) {
+    CHECK(mppt.update());
+  }
+
+  // P&O keeps perturbing, so it dithers around the MPP
+  bq25798_mppt_stats_t stats;
+  for (int i = 0; i < 20; i++) {
+    CHECK(mppt.update());
+    mppt.getStats(stats);
+    CHECK(distance(stats.vindpm_mV, panel.mpp()) <= 200);
+  }
+  CHECK(stats.reversals > 0);
+  CHECK(stats.peak_mW >= 14000);
+}
+
+static void testIncrementalConductanceHolds() {
+  Adafruit_BQ25798_MPPT mppt(&bq);
+  setup(mppt, BQ25798_MPPT_INC_CONDUCTANCE);
+
+  for (int i = 0; i < 150; i++) {
+    CHECK(mppt.update());
+  }
+
+  bq25798_mppt_stats_t before;
+  mppt.getStats(before);
+  CHECK(distance(before.vindpm_mV, panel.mpp()) <= 100);
+
+  // Settled at the MPP: sampling carries on, writing stops
+  panel.sim.resetCounts();
+  for (int i = 0; i < 50; i++) {
+    CHECK(mppt.update());
+  }
+  bq25798_mppt_stats_t after;
+  mppt.getStats(after);
+  CHECK_EQ(after.steps, before.steps);
+  CHECK_EQ(after.samples, before.samples + 50);
+  CHECK_EQ(panel.sim.writeCount(), 0);
+}
+
+static void testTracksIrradianceDrop() {
+  Adafruit_BQ25798_MPPT mppt(&bq);
+  setup(mppt, BQ25798_MPPT_PERTURB_OBSERVE);
+  for (int i = 0; i < 150; i++) {
+    CHECK(mppt.update());
+  }
+
+  // Less light lowers the current but leaves the MPP voltage alone in this
+  // model, so the tracker should stay put
+  panel.scale = 0.3;
+  for (int i = 0; i < 50; i++) {
+    CHECK(mppt.update());
+  }
+  bq25798_mppt_stats_t stats;
+  mppt.getStats(stats);
+  CHECK(distance(stats.vindpm_mV, panel.mpp()) <= 200);
+}
+
+static void testLimits() {
+  Adafruit_BQ25798_MPPT mppt(&bq);
+  setup(mppt, BQ25798_MPPT_PERTURB_OBSERVE);
+  mppt.setLimits(6000, 12000);
+  for (int i = 0; i < 150; i++) {
+    CHECK(mppt.update());
+    CHECK(bq.getInputLimit_mV() <= 12000);
+  }
+  CHECK(bq.getInputLimit_mV() >= 11800);
+}
+
+static void testVOCModeLeavesSetpointToChip() {
+  Adafruit_BQ25798_MPPT mppt(&bq);
+  setup(mppt, BQ25798_MPPT_VOC);
+  CHECK(bq.getMPPTenable());
+
+  panel.sim.resetCounts();
+  for (int i = 0; i < 10; i++) {
+    CHECK(mppt.update());
+  }
+  CHECK_EQ(panel.sim.writeCount(), 0);
+
+  CHECK(mppt.end());
+  CHECK(!bq.getMPPTenable());
+}
+
+int main() {
+  RUN(testPanelModel);
+  RUN(testPerturbObserveFindsMPP);
+  RUN(testIncrementalConductanceHolds);
+  RUN(testTracksIrradianceDrop);
+  RUN(testLimits);
+  RUN(testVOCModeLeavesSetpointToChip);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Multi-charger manager against fake TCA9548A muxes. Each fake bus routes
+ * a transfer to the one simulated charger reachable through the open mux
+ * channels, and fails it if none or more than one would answer at 0x6B.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Multi.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+/*
+ * TCA9548A control port: the zero-length write's "register" is the mask
+ */
+class FakeMux : public Adafruit_BQ25798_Transport {
+public:
+  FakeMux() : mask(0), writes(0) {
+    for (uint8_t ch = 0; ch < 8; ch++) {
+      channels[ch] = NULL;
+    }
+  }
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    (void)reg;
+    (void)buffer;
+    (void)len;
+    return false;
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    (void)buffer;
+    if (len) {
+      return false;
+    }
+    writes++;
+    mask = reg;
+    return true;
+  }
+
+  Adafruit_BQ25798_Sim *channels[8];
+  uint8_t mask;
+  uint32_t writes;
+};
+
+/*
+ * One physical bus: an optional charger wired straight on, plus muxes
+ */
+class FakeBus : public Adafruit_BQ25798_Transport {
+public:
+  FakeBus() : direct(NULL), mux_count(0), fail(0), recoveries(0) {}
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    Adafruit_BQ25798_Sim *sim = route();
+    return sim && sim->readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    Adafruit_BQ25798_Sim *sim = route();
+    return sim && sim->writeRegisters(reg, buffer, len);
+  }
+
+  bool recoverBus() {
+    recoveries++;
+    return true;
+  }
+
+  void attach(FakeMux *mux) {
+    muxes[mux_count++] = mux;
+  }
+
+  Adafruit_BQ25798_Sim *direct;
+  FakeMux *muxes[2];
+  uint8_t mux_count;
+  uint8_t fail;
+  uint8_t recoveries;
+
+private:
+  Adafruit_BQ25798_Sim *route() {
+    if (fail) {
+      fail--;
+      return NULL;
+    }
+    Adafruit_BQ25798_Sim *found = direct;
+    uint8_t answering = direct ? 1 : 0;
+    for (uint8_t m = 0; m < mux_count; m++) {
+      for (uint8_t ch = 0; ch < 8; ch++) {
+        if ((muxes[m]->mask & (1 << ch)) && muxes[m]->channels[ch]) {
+          found = muxes[m]->channels[ch];
+          answering++;
+        }
+      }
+    }
+    return answering == 1 ? found : NULL;
+  }
+};
+
+static uint8_t visited[BQ25798_MULTI_MAX];
+static uint8_t visits;
+
+static bool record(Adafruit_BQ25798 &charger, uint8_t unit, void *context) {
+  (void)charger;
+  (void)context;
+  visited[visits++] = unit;
+  return true;
+}
+
+static void testGroupedOrderAndSweepDirection() {
+  FakeBus bus_a, bus_b, bus_c;
+  FakeMux mux0, mux1;
+  Adafruit_BQ25798_Sim sims[5];
+  bus_a.attach(&mux0);
+  bus_b.attach(&mux1);
+  mux0.channels[5] = &sims[0];
+  mux1.channels[2] = &sims[1];
+  mux0.channels[1] = &sims[2];
+  bus_c.direct = &sims[3];
+  mux1.channels[0] = &sims[4];
+
+  Adafruit_BQ25798_Multi multi;
+  CHECK_EQ(multi.addMux(&mux0, &bus_a), 0);
+  CHECK_EQ(multi.addMux(&mux1, &bus_b), 1);
+  CHECK_EQ(multi.addCharger(0, 5), 0);
+  CHECK_EQ(multi.addCharger(1, 2), 1);
+  CHECK_EQ(multi.addCharger(0, 1), 2);
+  CHECK_EQ(multi.addCharger(&bus_c), 3);
+  CHECK_EQ(multi.addCharger(1, 0), 4);
+  CHECK_EQ(multi.addCharger(0, 8), -1);
+  CHECK_EQ(multi.begin(), 0x1F);
+
+  // Buses in the order first seen, then by channel within each mux
+  static const uint8_t forward[] = {2, 0, 4, 1, 3};
+  visits = 0;
+  CHECK_EQ(multi.forEach(record), 0x1F);
+  CHECK_EQ(visits, 5);
+  for (uint8_t i = 0; i < 5; i++) {
+    CHECK_EQ(visited[i], forward[i]);
+  }
+
+  visits = 0;
+  CHECK_EQ(multi.forEach(record), 0x1F);
+  for (uint8_t i = 0; i < 5; i++) {
+    CHECK_EQ(visited[i], forward[4 - i]);
+  }
+
+  // Readings land at the right unit index
+  for (uint8_t i = 0; i < 5; i++) {
+    sims[i].poke16(BQ25798_REG_VBAT_ADC, 3000 + i);
+  }
+  bq25798_adc_fixed_t adc[5];
+  CHECK_EQ(multi.pollADC(adc), 0x1F);
+  for (uint8_t i = 0; i < 5; i++) {
+    CHECK_EQ(adc[i].vbat, 3000 + i);
+  }
+}
+
+static void testSwitchCount() {
+  FakeBus bus;
+  FakeMux mux;
+  Adafruit_BQ25798_Sim sims[4];
+  bus.attach(&mux);
+
+  Adafruit_BQ25798_Multi multi;
+  multi.addMux(&mux, &bus);
+  for (uint8_t ch = 0; ch < 4; ch++) {
+    mux.channels[ch] = &sims[ch];
+    multi.addCharger(0, ch);
+  }
+  CHECK_EQ(multi.begin(), 0x0F);
+  CHECK_EQ(multi.getSwitchCount(), mux.writes);
+
+  // begin() left channel 3 open: the forward sweep pays for all four, the
+  // backward one starts where it ended
+  bq25798_status_t status[4];
+  uint32_t before = multi.getSwitchCount();
+  CHECK_EQ(multi.pollStatus(status), 0x0F);
+  CHECK_EQ(multi.getSwitchCount() - before, 4);
+  before = multi.getSwitchCount();
+  CHECK_EQ(multi.poll(status, NULL), 0x0F);
+  CHECK_EQ(multi.getSwitchCount() - before, 3);
+  CHECK_EQ(multi.getSwitchCount(), mux.writes);
+
+  // Repeat accesses to the selected unit cost no switch
+  before = multi.getSwitchCount();
+  multi.getCharger(0)->getChargeLimit_mV();
+  multi.getCharger(0)->getChargeLimit_mV();
+  CHECK_EQ(multi.getSwitchCount() - before, 0);
+
+  CHECK(multi.deselectAll());
+  CHECK_EQ(mux.mask, 0);
+  before = mux.writes;
+  CHECK(multi.deselectAll()); // already closed, no write
+  CHECK_EQ(mux.writes, before);
+  CHECK_EQ(multi.getSwitchCount(), mux.writes);
+}
+
+static void testOtherMuxesOnBusClosed() {
+  FakeBus bus;
+  FakeMux mux0, mux1;
+  Adafruit_BQ25798_Sim sims[2];
+  bus.attach(&mux0);
+  bus.attach(&mux1);
+  mux0.channels[2] = &sims[0];
+  mux1.channels[3] = &sims[1];
+
+  Adafruit_BQ25798_Multi multi;
+  multi.addMux(&mux0, &bus);
+  multi.addMux(&mux1, &bus);
+  uint8_t a = multi.addCharger(0, 2);
+  uint8_t b = multi.addCharger(1, 3);
+  CHECK_EQ(multi.begin(), 0x03);
+
+  CHECK(multi.select(b));
+  CHECK_EQ(mux0.mask, 0);
+  CHECK_EQ(mux1.mask, 1 << 3);
+  CHECK(multi.getCharger(b)->getChargeLimit_mV());
+
+  CHECK(multi.select(a));
+  CHECK_EQ(mux0.mask, 1 << 2);
+  CHECK_EQ(mux1.mask, 0);
+  CHECK(multi.getCharger(a)->getChargeLimit_mV());
+
+  CHECK(multi.deselectAll());
+  CHECK_EQ(mux0.mask | mux1.mask, 0);
+  CHECK(!multi.select(7));
+}
+
+static void testRecoverBusRewritesMuxes() {
+  FakeBus bus;
+  FakeMux mux;
+  Adafruit_BQ25798_Sim sim;
+  bus.attach(&mux);
+  mux.channels[4] = &sim;
+
+  Adafruit_BQ25798_Multi multi;
+  multi.addMux(&mux, &bus);
+  uint8_t unit = multi.addCharger(0, 4);
+  CHECK_EQ(multi.begin(), 0x01);
+  Adafruit_BQ25798 *charger = multi.getCharger(unit);
+  charger->setRetryPolicy(2, 0, true);
+
+  // The mux may have seen garbage during the recovery, so the next
+  // access rewrites its channel even though it has not changed
+  uint32_t before = mux.writes;
+  bus.fail = 1;
+  CHECK_EQ(charger->getChargeLimit_mV(), 4200);
+  CHECK_EQ(bus.recoveries, 1);
+  CHECK_EQ(mux.writes - before, 1);
+  CHECK_EQ(mux.mask, 1 << 4);
+}
+
+int main() {
+  RUN(testGroupedOrderAndSweepDirection);
+  RUN(testSwitchCount);
+  RUN(testOtherMuxesOnBusClosed);
+  RUN(testRecoverBusRewritesMuxes);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+/*
+ * OTG supervisor against a simulated load on VBUS: PFM hysteresis, the
+ * shutdown reasons and the battery cutoff debounce.
+ */
+
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_OTG.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+/*
+ * A load on VBUS fed by the boost converter. Before every read the status
+ * and ADC registers are refreshed from EN_OTG, VOTG and IOTG: VBUS_STAT
+ * reports OTG while it is on, IBUS reads the load as negative, and a load
+ * above IOTG is held at the limit with IINDPM_STAT set.
+ */
+class OTGLoad : public Adafruit_BQ25798_Transport {
+public:
+  OTGLoad() : load(0), vbat(3900) {}
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t len) {
+    bool on = sim.peek(BQ25798_REG_CHARGER_CONTROL_3) & 0x40;
+    uint16_t limit = (sim.peek(BQ25798_REG_IOTG_REGULATION) & 0x7F) * 40;
+    bool regulating = on && load > limit;
+
+    uint8_t status0 = sim.peek(BQ25798_REG_CHARGER_STATUS_0) & 0x7F;
+    sim.poke(BQ25798_REG_CHARGER_STATUS_0, status0 | (regulating ? 0x80 : 0));
+    uint8_t status1 = sim.peek(BQ25798_REG_CHARGER_STATUS_1) & ~0x1E;
+    sim.poke(BQ25798_REG_CHARGER_STATUS_1,
+             status1 | (on ? BQ25798_VBUS_STAT_OTG << 1 : 0));
+
+    uint16_t votg = sim.peek16(BQ25798_REG_VOTG_REGULATION) * 10 + 2800;
+    uint16_t ibus = regulating ? limit : load;
+    sim.poke16(BQ25798_REG_VBUS_ADC, on ? votg : 0);
+    sim.poke16(BQ25798_REG_IBUS_ADC, on ? (uint16_t)-ibus : 0);
+    sim.poke16(BQ25798_REG_VBAT_ADC, vbat);
+    return sim.readRegisters(reg, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, uint8_t len) {
+    return sim.writeRegisters(reg, buffer, len);
+  }
+
+  bool otgEnabled() {
+    return sim.peek(BQ25798_REG_CHARGER_CONTROL_3) & 0x40;
+  }
+
+  Adafruit_BQ25798_Sim sim;
+  uint16_t load; // mA drawn from VBUS
+  uint16_t vbat; // mV
+};
+
+static OTGLoad port;
+static Adafruit_BQ25798 bq;
+
+static uint8_t shutdowns;
+static bq25798_otg_reason_t shutdown_reason;
+
+static void onShutdown(bq25798_otg_reason_t reason) {
+  shutdowns++;
+  shutdown_reason = reason;
+}
+
+static void setup() {
+  port.sim.powerOnReset();
+  port.load = 0;
+  port.vbat = 3900;
+  CHECK(bq.begin(&port));
+  shutdowns = 0;
+  shutdown_reason = BQ25798_OTG_OFF_NONE;
+}
+
+static void sleepMs(uint32_t ms) {
+  struct timespec ts = {0, (long)ms * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+static void testPFMHysteresis() {
+  setup();
+  Adafruit_BQ25798_OTG otg(&bq);
+  CHECK(otg.begin(5000, 1000, 0));
+  CHECK(port.otgEnabled());
+  CHECK(!bq.getOTGPFM());
+
+  // Light below 100mA, heavy above 300mA, no change in between
+  static const uint16_t loads[] = {50, 200, 300, 301, 150, 100, 99};
+  static const bool modes[] = {true, true, true, false, false, false, true};
+  for (uint8_t i = 0; i < 7; i++) {
+    port.load = loads[i];
+    CHECK(otg.update());
+    CHECK_EQ(otg.isPFM(), modes[i]);
+    CHECK_EQ(bq.getOTGPFM(), modes[i]);
+  }
+
+  bq25798_otg_stats_t stats;
+  otg.getStats(stats);
+  CHECK_EQ(stats.pfm_changes, 3);
+  CHECK_EQ(stats.samples, 7);
+  CHECK_EQ(stats.vbus_mV, 5000);
+  CHECK_EQ(stats.load_mA, 99);
+  CHECK_EQ(stats.peak_mA, 301);
+  CHECK_EQ(stats.vbat_mV, 3900);
+
+  CHECK(otg.end());
+  CHECK(!port.otgEnabled());
+  CHECK_EQ(otg.getReason(), BQ25798_OTG_OFF_REQUESTED);
+}
+
+static void testFaultShutdowns() {
+  struct {
+    uint8_t reg;
+    uint8_t bit;
+    bq25798_otg_reason_t reason;
+  } static const faults[] = {
+      {BQ25798_REG_FAULT_STATUS_1, 0x20, BQ25798_OTG_OFF_OVP},
+      {BQ25798_REG_FAULT_STATUS_1, 0x10, BQ25798_OTG_OFF_UVP},
+      {BQ25798_REG_CHARGER_STATUS_4, 0x10, BQ25798_OTG_OFF_VBAT_LOW},
+  };
+  for (uint8_t i = 0; i < 3; i++) {
+    setup();
+    Adafruit_BQ25798_OTG otg(&bq);
+    otg.onShutdown(onShutdown);
+    CHECK(otg.begin(5000, 1000, 0));
+    CHECK(otg.update());
+
+    port.sim.poke(faults[i].reg, port.sim.peek(faults[i].reg) | faults[i].bit);
+    CHECK(!otg.update());
+    CHECK(!otg.isRunning());
+    CHECK(!port.otgEnabled());
+    CHECK_EQ(otg.getReason(), faults[i].reason);
+    CHECK_EQ(shutdowns, 1);
+    CHECK_EQ(shutdown_reason, faults[i].reason);
+
+    // end() afterwards keeps the reason and stays quiet
+    CHECK(otg.end());
+    CHECK_EQ(otg.getReason(), faults[i].reason);
+    CHECK_EQ(shutdowns, 1);
+  }
+}
+
+static void testCutoffDebounce() {
+  setup();
+  Adafruit_BQ25798_OTG otg(&bq);
+  otg.onShutdown(onShutdown);
+  otg.setMinimum(3400, 30);
+
+  // Already below the cutoff: OTG is never turned on
+  port.vbat = 3300;
+  CHECK(!otg.begin(5000, 1000, 0));
+  CHECK(!port.otgEnabled());
+  CHECK_EQ(otg.getReason(), BQ25798_OTG_OFF_VBAT_LOW);
+  CHECK_EQ(shutdowns, 0);
+
+  port.vbat = 3500;
+  CHECK(otg.begin(5000, 1000, 0));
+  CHECK(otg.update());
+
+  // A sag shorter than the debounce is ridden out, and restarts it
+  port.vbat = 3300;
+  CHECK(otg.update());
+  sleepMs(20);
+  port.vbat = 3500;
+  CHECK(otg.update());
+  port.vbat = 3300;
+  sleepMs(20);
+  CHECK(otg.update());
+  CHECK(otg.isRunning());
+
+  sleepMs(35);
+  CHECK(!otg.update());
+  CHECK_EQ(otg.getReason(), BQ25798_OTG_OFF_VBAT_LOW);
+  CHECK_EQ(shutdowns, 1);
+  CHECK(!port.otgEnabled());
+}
+
+static void testOverload() {
+  setup();
+  Adafruit_BQ25798_OTG otg(&bq);
+  otg.onShutdown(onShutdown);
+  otg.setOverload(30);
+  CHECK(otg.begin(5000, 1000, 0));
+
+  port.load = 1500;
+  CHECK(otg.update());
+  bq25798_otg_stats_t stats;
+  otg.getStats(stats);
+  CHECK_EQ(stats.load_mA, 1000); // held at IOTG
+
+  // Leaving regulation restarts the timer
+  sleepMs(20);
+  port.load = 500;
+  CHECK(otg.update());
+  port.load = 1500;
+  sleepMs(20);
+  CHECK(otg.update());
+  CHECK(otg.isRunning());
+
+  sleepMs(35);
+  CHECK(!otg.update());
+  CHECK_EQ(otg.getReason(), BQ25798_OTG_OFF_OVERLOAD);
+  CHECK_EQ(shutdown_reason, BQ25798_OTG_OFF_OVERLOAD);
+}
+
+static void testChipLeavesOTG() {
+  setup();
+  Adafruit_BQ25798_OTG otg(&bq);
+  CHECK(otg.begin(5000, 1000, 0));
+  CHECK(otg.update());
+
+  // e.g. the battery went hot and the chip dropped EN_OTG itself
+  uint8_t control = port.sim.peek(BQ25798_REG_CHARGER_CONTROL_3);
+  port.sim.poke(BQ25798_REG_CHARGER_CONTROL_3, control & ~0x40);
+  CHECK(!otg.update());
+  CHECK_EQ(otg.getReason(), BQ25798_OTG_OFF_STOPPED);
+}
+
+static void testBeginAfterGlitch() {
+  // ERR_BUS left behind by a failed read must not fail the cached cell
+  // count begin() checks with getLastError()
+  setup();
+  CHECK(bq.enableCache(true));
+  bq.setRetryPolicy(1);
+  bq25798_status_t status;
+  port.sim.failTransfers(1);
+  CHECK(!bq.getStatus(status));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUS);
+
+  port.vbat = 3900;
+  Adafruit_BQ25798_OTG otg(&bq);
+  CHECK(otg.begin(5000, 1000, 0));
+  CHECK(bq.getOTGenable());
+}
+
+int main() {
+  RUN(testPFMHysteresis);
+  RUN(testFaultShutdowns);
+  RUN(testCutoffDebounce);
+  RUN(testOverload);
+  RUN(testChipLeavesOTG);
+  RUN(testBeginAfterGlitch);
+  return test_failures ? 1 : 0;
+}
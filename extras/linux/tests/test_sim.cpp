@@ -0,0 +1,120 @@
+/*
+ * Register-map simulator and the driver's basic register access.
+ */
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+}
+
+static void testBeginChecksPartNumber() {
+  sim.powerOnReset();
+  sim.poke(BQ25798_REG_PART_INFORMATION, 0x00);
+  CHECK(!bq.begin(&sim));
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_NO_DEVICE);
+
+  setup();
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+}
+
+static void testResetSelfClears() {
+  setup();
+  CHECK(bq.setChargeLimitV(4.1));
+  CHECK(bq.setTerminationA(0.4));
+  CHECK(bq.reset());
+
+  CHECK_EQ(sim.peek(BQ25798_REG_TERMINATION_CONTROL) & 0x40, 0);
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 0x01A4);
+  CHECK_NEAR(bq.getChargeLimitV(), 4.2, 0.001);
+  CHECK_NEAR(bq.getTerminationA(), 0.2, 0.001);
+}
+
+static void testStrobesSelfClear() {
+  setup();
+  CHECK(bq.resetWDT());
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_CONTROL_1) & 0x08, 0);
+  CHECK(bq.setForceICO(true));
+  CHECK(!bq.getForceICO());
+}
+
+static void testFlagsClearOnRead() {
+  setup();
+  sim.raiseFlags(BQ25798_FLAG_PG | BQ25798_FLAG_WD);
+
+  uint64_t flags = 0;
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, BQ25798_FLAG_PG | BQ25798_FLAG_WD);
+  for (uint8_t reg = BQ25798_REG_CHARGER_FLAG_0;
+       reg <= BQ25798_REG_FAULT_FLAG_1; reg++) {
+    CHECK_EQ(sim.peek(reg), 0);
+  }
+
+  CHECK(bq.handleInterrupt(&flags));
+  CHECK_EQ(flags, 0);
+}
+
+static void testSixteenBitFieldsMSBFirst() {
+  setup();
+  CHECK(bq.setChargeLimitV(8.4));
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 0x03);
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGE_VOLTAGE_LIMIT + 1), 0x48);
+  CHECK_NEAR(bq.getChargeLimitV(), 8.4, 0.001);
+
+  sim.poke16(BQ25798_REG_VBAT_ADC, 3712);
+  sim.poke16(BQ25798_REG_IBUS_ADC, (uint16_t)-250);
+  bq25798_adc_t adc;
+  CHECK(bq.readAllADC(adc));
+  CHECK_NEAR(adc.vbat, 3.712, 0.0001);
+  CHECK_NEAR(adc.ibus, -0.25, 0.0001);
+}
+
+static void testReadOnlyMasks() {
+  setup();
+  uint8_t ones[2] = {0xFF, 0xFF};
+
+  // VREG is 11 bits, the top five of the MSB are reserved
+  CHECK(sim.writeRegisters(BQ25798_REG_CHARGE_VOLTAGE_LIMIT, ones, 2));
+  CHECK_EQ(sim.peek16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT), 0x07FF);
+
+  // Status and part information cannot be written at all
+  CHECK(sim.writeRegisters(BQ25798_REG_CHARGER_STATUS_0, ones, 1));
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_STATUS_0), 0);
+  CHECK(sim.writeRegisters(BQ25798_REG_PART_INFORMATION, ones, 1));
+  CHECK_EQ(sim.peek(BQ25798_REG_PART_INFORMATION), 0x19);
+
+  // Runs past the end of the map are refused
+  CHECK(!sim.writeRegisters(BQ25798_REG_PART_INFORMATION, ones, 2));
+}
+
+static void testFailedTransfers() {
+  setup();
+  bq.setRetryPolicy(1);
+  sim.failTransfers(1);
+  CHECK_EQ(bq.getChargeLimit_mV(), 0);
+  CHECK_EQ(bq.getLastError(), BQ25798_ERR_BUS);
+  CHECK_EQ(bq.getChargeLimit_mV(), 4200);
+  CHECK_EQ(bq.getLastError(), BQ25798_OK);
+
+  bq.setRetryPolicy(3, 0);
+  sim.failTransfers(2);
+  CHECK_EQ(bq.getChargeLimit_mV(), 4200);
+  CHECK_EQ(sim.recoveryCount(), 2);
+}
+
+int main() {
+  RUN(testBeginChecksPartNumber);
+  RUN(testResetSelfClears);
+  RUN(testStrobesSelfClear);
+  RUN(testFlagsClearOnRead);
+  RUN(testSixteenBitFieldsMSBFirst);
+  RUN(testReadOnlyMasks);
+  RUN(testFailedTransfers);
+  return test_failures ? 1 : 0;
+}
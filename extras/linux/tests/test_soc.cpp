@@ -0,0 +1,184 @@
+/*
+ * State-of-charge estimator on synthetic samples with explicit timestamps.
+ */
+
+#include <string.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_SoC.h"
+#include "bq25798_test.h"
+
+#define SECOND_US 1000000UL
+
+static bq25798_adc_fixed_t battery(int16_t ibat_mA, uint16_t vbat_mV) {
+  bq25798_adc_fixed_t adc;
+  memset(&adc, 0, sizeof(adc));
+  adc.ibat = ibat_mA;
+  adc.vbat = vbat_mV;
+  return adc;
+}
+
+static void testOCVSegmentEdges() {
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+
+  uint16_t slope = 0;
+  CHECK_EQ(soc.ocvToSoC(3200, &slope), 0); // below the table
+  CHECK_EQ(slope, 280);
+  CHECK_EQ(soc.ocvToSoC(3300), 0);
+  CHECK_EQ(soc.ocvToSoC(3580, &slope), 1000); // a point starts its segment
+  CHECK_EQ(slope, 90);
+  CHECK_EQ(soc.ocvToSoC(3625), 1500);
+  CHECK_EQ(soc.ocvToSoC(4199, &slope), 9991);
+  CHECK_EQ(slope, 120);
+  CHECK_EQ(soc.ocvToSoC(4200), 10000);
+  CHECK_EQ(soc.ocvToSoC(4300), 10000);
+}
+
+static void testSeedCorrectsForResistance() {
+  // 1A into 100 mOhm lifts the terminal 100mV above the 60% OCV
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 2));
+  soc.addSample(battery(1000, 2 * 3960), 0);
+  CHECK_EQ(soc.getSoC(), 6000);
+  CHECK_EQ(soc.getRemaining_mAh(), 600);
+
+  // setSoC() before the first sample replaces the seed
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 2));
+  soc.setSoC(2500);
+  soc.addSample(battery(1000, 2 * 3960), 0);
+  CHECK_EQ(soc.getSoC(), 2500);
+}
+
+static void testRestCorrection() {
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+  soc.setRestDetection(20, 60);
+  soc.setSoC(5000);
+
+  // 3860mV rested is 60%; |IBAT| of 19mA still counts as resting
+  soc.addSample(battery(0, 3860), 0);
+  soc.addSample(battery(-19, 3860), 30 * SECOND_US);
+  CHECK(!soc.isResting());
+  CHECK_EQ(soc.getSoC(), 4999); // 30s at 9.5mA average
+
+  soc.addSample(battery(0, 3860), 60 * SECOND_US);
+  CHECK(soc.isResting());
+  CHECK_EQ(soc.getSoC(), 6000);
+  CHECK_EQ(soc.getCorrections(), 1);
+
+  // Still the same rest period
+  soc.addSample(battery(0, 3860), 90 * SECOND_US);
+  CHECK_EQ(soc.getCorrections(), 1);
+
+  // Load ends the rest; the next one needs the full time again
+  soc.addSample(battery(20, 3860), 91 * SECOND_US);
+  CHECK(!soc.isResting());
+  soc.addSample(battery(0, 3810), 150 * SECOND_US);
+  CHECK(!soc.isResting());
+  soc.addSample(battery(0, 3810), 151 * SECOND_US);
+  CHECK(soc.isResting());
+  CHECK_EQ(soc.getSoC(), 5000);
+  CHECK_EQ(soc.getCorrections(), 2);
+}
+
+static void testColdRestTakesTwiceAsLong() {
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+  soc.setRestDetection(20, 60);
+
+  // TS reading for about 5C from the default thermistor table
+  uint16_t ts = 5000;
+  while (soc.getNTC().toTemperature(ts) > 50) {
+    ts += 10;
+  }
+
+  bq25798_adc_fixed_t adc = battery(0, 3860);
+  adc.ts = ts;
+  soc.addSample(adc, 0);
+  soc.addSample(adc, 60 * SECOND_US);
+  CHECK(soc.getTemperature() <= 50);
+  CHECK(!soc.isResting());
+  soc.addSample(adc, 120 * SECOND_US);
+  CHECK(soc.isResting());
+}
+
+static void testFlatSlopeRejected() {
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIFEPO4, 1000, 1));
+  soc.setRestDetection(20, 60);
+
+  uint16_t slope = 0;
+  CHECK_EQ(soc.ocvToSoC(3285, &slope), 5500);
+  CHECK_EQ(slope, 10);
+
+  // On the plateau a rest leaves the count alone
+  soc.setSoC(2000);
+  soc.addSample(battery(0, 3285), 0);
+  soc.addSample(battery(0, 3285), 60 * SECOND_US);
+  CHECK(soc.isResting());
+  CHECK_EQ(soc.getSoC(), 2000);
+  CHECK_EQ(soc.getCorrections(), 0);
+
+  // On the steep part below it the curve is trusted
+  soc.addSample(battery(0, 3150), 61 * SECOND_US);
+  CHECK_EQ(soc.getSoC(), 1500);
+  CHECK_EQ(soc.getCorrections(), 1);
+
+  soc.markFull();
+  CHECK_EQ(soc.getSoC(), 10000);
+}
+
+static void testIntegrateLongInterval() {
+  // 100s is split into chunks of at most 32767ms; none of it may be lost
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+  soc.setSoC(5000);
+  soc.addSample(battery(1000, 3900), 0);
+  soc.addSample(battery(1000, 3900), 100 * SECOND_US);
+  CHECK_EQ(soc.getRemaining_mAh(), 528); // 500mAh + 100mA*s*1000/3600
+  CHECK_EQ(soc.getSoC(), 5277);
+
+  soc.addSample(battery(-1000, 3900), 200 * SECOND_US); // trapezoid nets 0
+  CHECK_EQ(soc.getSoC(), 5277);
+  soc.addSample(battery(-1000, 3900), 300 * SECOND_US);
+  CHECK_EQ(soc.getSoC(), 5000);
+}
+
+static void testIntegrateCarriesResiduals() {
+  // 1mA sampled every 1.5ms rounds to nothing per step; the residual and
+  // the sub-ms timestamp remainder must add up to exactly 360mA*s (0.01%)
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+  soc.setSoC(5000);
+  for (uint32_t t = 0; t <= 360 * SECOND_US; t += 1500) {
+    soc.addSample(battery(1, 3900), t);
+  }
+  CHECK_EQ(soc.getSoC(), 5001);
+}
+
+static void testIntegrateClampsAndWraps() {
+  Adafruit_BQ25798_SoC soc;
+  CHECK(soc.begin(BQ25798_CHEM_LIION, 1000, 1));
+  soc.setSoC(9990);
+  soc.addSample(battery(1000, 4100), 0xFFFFFFFFUL - SECOND_US + 1);
+  soc.addSample(battery(1000, 4100), 99 * SECOND_US); // across the wrap
+  CHECK_EQ(soc.getSoC(), 10000);
+
+  soc.setSoC(10);
+  soc.addSample(battery(-1000, 3400), 100 * SECOND_US);
+  soc.addSample(battery(-1000, 3400), 200 * SECOND_US);
+  CHECK_EQ(soc.getSoC(), 0);
+}
+
+int main() {
+  RUN(testOCVSegmentEdges);
+  RUN(testSeedCorrectsForResistance);
+  RUN(testRestCorrection);
+  RUN(testColdRestTakesTwiceAsLong);
+  RUN(testFlatSlopeRejected);
+  RUN(testIntegrateLongInterval);
+  RUN(testIntegrateCarriesResiduals);
+  RUN(testIntegrateClampsAndWraps);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Watchdog keepalive service: kick scheduling, piggybacked resets and
+ * restoring the configuration after an expiry. The sim does not run the
+ * watchdog timer, so expiries are staged by hand.
+ */
+
+#include <time.h>
+
+#include "Adafruit_BQ25798.h"
+#include "Adafruit_BQ25798_Sim.h"
+#include "Adafruit_BQ25798_Watchdog.h"
+#include "bq25798_test.h"
+
+static Adafruit_BQ25798_Sim sim;
+static Adafruit_BQ25798 bq;
+
+static void setup() {
+  sim.powerOnReset();
+  CHECK(bq.begin(&sim));
+  CHECK(bq.setChargeLimit_mV(4100));
+  CHECK(bq.setChargeLimit_mA(1500));
+  CHECK(bq.setInputLimit_mA(2000));
+}
+
+static void sleepMs(uint32_t ms) {
+  struct timespec ts = {0, (long)ms * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+/*
+ * What the chip does on expiry: control registers back to their power-on
+ * values, WD_STAT set
+ */
+static void expire() {
+  Adafruit_BQ25798_Sim defaults;
+  for (uint8_t reg = 0; reg <= BQ25798_REG_CHARGER_CONTROL_5; reg++) {
+    sim.poke(reg, defaults.peek(reg));
+  }
+  uint8_t status = sim.peek(BQ25798_REG_CHARGER_STATUS_0);
+  sim.poke(BQ25798_REG_CHARGER_STATUS_0, status | 0x20);
+}
+
+static void testKicksOnlyWhenDue() {
+  setup();
+  Adafruit_BQ25798_Watchdog wd(&bq);
+  wd.setMargin(450);
+  wd.setCheckInterval(0);
+  CHECK(wd.begin(BQ25798_WDT_0_5S));
+  CHECK_EQ(wd.getTimeout_ms(), 500);
+  CHECK_EQ(bq.getWDT(), BQ25798_WDT_0_5S);
+
+  // begin()'s own write to 0x10 was the first reset
+  sim.resetCounts();
+  CHECK(wd.update());
+  CHECK_EQ(sim.writeCount(), 0);
+  CHECK_EQ(sim.readCount(), 0);
+
+  sleepMs(60);
+  CHECK(wd.update());
+  CHECK_EQ(sim.writeCount(), 1);
+  bq25798_wdt_health_t health;
+  wd.getHealth(health);
+  CHECK_EQ(health.kicks, 1);
+  CHECK_EQ(health.piggybacked, 0);
+  CHECK_EQ(health.checks, 0);
+  CHECK(health.max_gap_ms >= 50);
+
+  CHECK(wd.end());
+  CHECK_EQ(bq.getWDT(), BQ25798_WDT_DISABLE);
+  CHECK(!wd.update());
+}
+
+static void testControl1WriteIsPiggybacked() {
+  setup();
+  Adafruit_BQ25798_Watchdog wd(&bq);
+  wd.setMargin(450);
+  wd.setCheckInterval(0);
+  CHECK(wd.begin(BQ25798_WDT_0_5S));
+
+  // Any setter on CHARGER_CONTROL_1 carries WD_RST, so no kick is due
+  sleepMs(60);
+  CHECK(bq.setWDT(BQ25798_WDT_0_5S));
+  sim.resetCounts();
+  CHECK(wd.update());
+  CHECK_EQ(sim.writeCount(), 0);
+
+  bq25798_wdt_health_t health;
+  wd.getHealth(health);
+  CHECK_EQ(health.piggybacked, 1);
+  CHECK_EQ(health.kicks, 0);
+  CHECK_EQ(sim.peek(BQ25798_REG_CHARGER_CONTROL_1) & 0x08, 0);
+}
+
+static void testExpiryRestoresConfig() {
+  setup();
+  Adafruit_BQ25798_Watchdog wd(&bq);
+  wd.setCheckInterval(1);
+  CHECK(wd.begin(BQ25798_WDT_0_5S));
+
+  expire();
+  CHECK_EQ(bq.getChargeLimit_mV(), 4200);
+  CHECK_EQ(bq.getWDT(), BQ25798_WDT_40S);
+
+  sleepMs(2);
+  CHECK(wd.update());
+  bq25798_wdt_health_t health;
+  wd.getHealth(health);
+  CHECK_EQ(health.checks, 1);
+  CHECK_EQ(health.expiries, 1);
+  CHECK_EQ(health.restores, 1);
+  CHECK_EQ(health.restored, 5); // VREG, ICHG, both IINDPM bytes, timer
+  CHECK_EQ(bq.getChargeLimit_mV(), 4100);
+  CHECK_EQ(bq.getChargeLimit_mA(), 1500);
+  CHECK_EQ(bq.getInputLimit_mA(), 2000);
+  CHECK_EQ(bq.getWDT(), BQ25798_WDT_0_5S);
+}
+
+static void testFailedKickTriggersCheck() {
+  setup();
+  Adafruit_BQ25798_Watchdog wd(&bq);
+  wd.setMargin(450);
+  wd.setCheckInterval(0);
+  CHECK(wd.begin(BQ25798_WDT_0_5S));
+
+  sleepMs(60);
+  sim.failTransfers(1);
+  CHECK(!wd.update());
+  bq25798_wdt_health_t health;
+  wd.getHealth(health);
+  CHECK_EQ(health.failures, 1);
+  CHECK_EQ(health.kicks, 0);
+  CHECK_EQ(health.checks, 1); // healthy, so nothing restored
+  CHECK_EQ(health.expiries, 0);
+
+  // Still overdue: the next call kicks
+  CHECK(wd.update());
+  wd.getHealth(health);
+  CHECK_EQ(health.kicks, 1);
+}
+
+int main() {
+  RUN(testKicksOnlyWhenDue);
+  RUN(testControl1WriteIsPiggybacked);
+  RUN(testExpiryRestoresConfig);
+  RUN(testFailedKickTriggersCheck);
+  return test_failures ? 1 : 0;
+}